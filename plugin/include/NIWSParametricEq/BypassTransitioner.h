@@ -2,6 +2,7 @@
 #include <juce_dsp/juce_dsp.h>
 #include "filters/BiquadFilter.h"
 #include <ranges>
+#include <type_traits>
 
 namespace parametric_eq {
 class BypassTransitioner {
@@ -15,6 +16,8 @@ public:
     sampleRateHz = spec.sampleRate;
     dryBuffer.setSize(static_cast<int>(spec.numChannels),
                       static_cast<int>(spec.maximumBlockSize));
+    dryBufferDouble.setSize(static_cast<int>(spec.numChannels),
+                            static_cast<int>(spec.maximumBlockSize));
     //dryGain.reset(spec.sampleRate, crossfadeLengthSeconds);
     //wetGain.reset(spec.sampleRate, crossfadeLengthSeconds);
   }
@@ -47,43 +50,77 @@ public:
     return dryGain.isSmoothing() || wetGain.isSmoothing();
   }
 
-  void setDryBuffer(const juce::AudioBuffer<float>& buffer) noexcept {
+  template <typename SampleType>
+  void setDryBuffer(const juce::AudioBuffer<SampleType>& buffer) noexcept {
     auto totalNumSamples = buffer.getNumSamples();
     auto totalNumChannels = buffer.getNumChannels();
+    auto& dry = getDryBuffer<SampleType>();
 
-    jassert(totalNumSamples <= dryBuffer.getNumSamples());
-    jassert(totalNumChannels <= dryBuffer.getNumChannels());
+    jassert(totalNumSamples <= dry.getNumSamples());
+    jassert(totalNumChannels <= dry.getNumChannels());
 
     for (int ch = 0; ch < totalNumChannels; ch++) {
-      dryBuffer.copyFrom(ch, 0, buffer, ch, 0, totalNumSamples);
+      dry.copyFrom(ch, 0, buffer, ch, 0, totalNumSamples);
     };
 
-    dryGain.applyGain(dryBuffer, totalNumSamples);
+    applyGain(dryGain, dry, totalNumSamples);
   }
 
-  void mixToWetBuffer(juce::AudioBuffer<float>& buffer) noexcept {
+  template <typename SampleType>
+  void mixToWetBuffer(juce::AudioBuffer<SampleType>& buffer) noexcept {
     auto totalNumSamples = buffer.getNumSamples();
     auto totalNumChannels = buffer.getNumChannels();
+    const auto& dry = getDryBuffer<SampleType>();
 
-    jassert(totalNumSamples <= dryBuffer.getNumSamples());
-    jassert(totalNumChannels <= dryBuffer.getNumChannels());
+    jassert(totalNumSamples <= dry.getNumSamples());
+    jassert(totalNumChannels <= dry.getNumChannels());
 
-    wetGain.applyGain(buffer, totalNumSamples);
+    applyGain(wetGain, buffer, totalNumSamples);
     for (int ch = 0; ch < totalNumChannels; ch++) {
-      buffer.addFrom(ch, 0, dryBuffer, ch, 0, totalNumSamples);
+      buffer.addFrom(ch, 0, dry, ch, 0, totalNumSamples);
     };
   }
 
   void reset() noexcept {
     setBypassForced(false);
     dryBuffer.clear();
+    dryBufferDouble.clear();
   }
 
 private:
+  template <typename SampleType>
+  juce::AudioBuffer<SampleType>& getDryBuffer() noexcept {
+    if constexpr (std::is_same_v<SampleType, double>) {
+      return dryBufferDouble;
+    } else {
+      return dryBuffer;
+    }
+  }
+
+  // The smoothed gains stay in float; for double buffers they are stepped here the way
+  // SmoothedValue::applyGain steps them for float ones.
+  template <typename SampleType>
+  static void applyGain(juce::LinearSmoothedValue<float>& gain, juce::AudioBuffer<SampleType>& buffer,
+                        int numSamples) noexcept {
+    if constexpr (std::is_same_v<SampleType, float>) {
+      gain.applyGain(buffer, numSamples);
+    } else if (!gain.isSmoothing()) {
+      buffer.applyGain(0, numSamples, static_cast<SampleType>(gain.getTargetValue()));
+    } else {
+      for (int n = 0; n < numSamples; ++n) {
+        const auto sampleGain = static_cast<SampleType>(gain.getNextValue());
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+          buffer.getWritePointer(ch)[n] *= sampleGain;
+        }
+      }
+    }
+  }
+
   double crossfadeLengthSeconds = 0.0;
   double sampleRateHz = 0.0;
   juce::LinearSmoothedValue<float> dryGain{0.f};
   juce::LinearSmoothedValue<float> wetGain{1.f};
   juce::AudioBuffer<float> dryBuffer;
+  juce::AudioBuffer<double> dryBufferDouble;
 };
 }  // namespace parametric_eq
@@ -14,6 +14,7 @@ public:
         BaseParameters* base = nullptr;
         juce::AudioParameterFloat* gain = nullptr;
         LfoParameters* lfo = nullptr;
+        juce::AudioParameterBool* steep = nullptr;
     };
 
     FilterInspectorPanel();
@@ -78,6 +79,7 @@ private:
     SliderField qField_{"Q"};
     ChoiceField slopeField_{"Slope"};
     ToggleField bypassField_{"Bypass"};
+    ToggleField steepField_{"Steep"};
 
     SliderField gainField_{"Gain"};
     ToggleField lfoEnabledField_{"LFO Enabled"};
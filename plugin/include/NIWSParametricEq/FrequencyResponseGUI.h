@@ -1,5 +1,6 @@
 #pragma once
 #include "PluginProcessor.h"
+#include "gui/SpectrumDisplay.h"
 #include <juce_graphics/juce_graphics.h>
 
 namespace parametric_eq {
@@ -9,21 +10,25 @@ public:
     ~FrequencyResponseGUI() override = default;
 
     void paint(juce::Graphics& g) override;
+    void resized() override { display_.setBounds(getLocalBounds().toFloat()); }
+
     void setMagnitudes(const std::vector<float>& magnitudes) {
-        spectrumMagnitudes_ = magnitudes;
+        display_.pushFrame(magnitudes);
+        hasMagnitudes_ = true;
         repaint();
     }
 
-    void setSampleRate(double sampleRate) noexcept {
-        sampleRate_ = sampleRate;
+    void setSmoothing(SpectrumDisplay::Smoothing smoothing) {
+        if (smoothing != display_.getSmoothing()) {
+            display_.setSmoothing(smoothing);
+            repaint();
+        }
     }
 
 private:
-    std::vector<float> spectrumMagnitudes_; 
-    std::vector<float> previousMagnitudes_;
-
-    double sampleRate_{44100.0};
+    SpectrumDisplay display_;
+    bool hasMagnitudes_{false};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrequencyResponseGUI)
 };
-}  // namespace parametric_eq
\ No newline at end of file
+}  // namespace parametric_eq
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+
+#include "filters/BiquadCascade.h"
+#include "filters/BiquadFilter.h"
+
+namespace parametric_eq {
+// Uniformly partitioned overlap-save convolution, for a kernel given as the spectra of its
+// partitions. Every partition of input costs one forward and one inverse FFT of twice the
+// partition size, plus one complex multiply-add per kernel partition against a frequency-domain
+// delay line of past input spectra. The delay line does not depend on the kernel, so any number
+// of kernels can be run against the same input.
+class UniformConvolution {
+public:
+    /** Allocates nothing when nothing changed. */
+    void prepare(int partitionOrder, size_t numPartitions, int numChannels);
+    void reset() noexcept;
+
+    int getPartitionSize() const noexcept { return partitionSize_; }
+    size_t getNumPartitions() const noexcept { return numPartitions_; }
+    size_t getKernelSize() const noexcept { return numPartitions_ * getSpectrumSize(); }
+
+    /** Turns getNumPartitions() * getPartitionSize() taps into partition spectra. The FFT has to be
+        of twice the partition size, and scratch has to hold four partitions. */
+    void transformKernel(const juce::dsp::FFT& fft, const float* taps, float* kernel, float* scratch) const noexcept;
+
+    /** Starts the next partition: call it once, then push that partition of input for every channel. */
+    void advance() noexcept;
+    void pushInput(size_t channel, const float* partition) noexcept;
+
+    /** Writes one partition of the channel's input so far convolved with the kernel. */
+    void convolve(const float* kernel, size_t channel, float* output) noexcept;
+
+private:
+    // Interleaved real and imaginary parts of the partitionSize + 1 bins of a partition spectrum.
+    size_t getSpectrumSize() const noexcept { return 2 * static_cast<size_t>(partitionSize_ + 1); }
+
+    std::unique_ptr<juce::dsp::FFT> fft_;
+    int partitionSize_{0};
+    size_t numPartitions_{0};
+    size_t numChannels_{0};
+    std::vector<float> inputs_;
+    std::vector<float> delayLine_;
+    std::vector<float> fftBuffer_;
+    size_t delayLineHead_{0};
+};
+
+// Linear-phase rendition of a cascade of biquads. A background thread samples the cascade's
+// magnitude response and turns it into a symmetric FIR kernel, long enough to resolve about 20 Hz.
+//
+// The kernel is partitioned non-uniformly. Its head, twice the tail partition long, runs as a
+// convolution with short partitions on the audio thread, so the latency is half the kernel plus
+// one head partition. The rest runs with partitions 2^TAIL_ORDER_STEP times longer, or a quarter
+// of the kernel if that is shorter, on a worker thread. Every tail partition of input is handed
+// over as a job, and its output is not due before another tail partition has gone by: that is
+// what the head is twice the tail partition long for. Should the worker not have started a job
+// when it falls due, the audio thread runs it itself, so a late worker costs CPU on the audio
+// thread but never drops out.
+//
+// The audio thread never takes a lock to talk to the workers: it only touches atomics, and wakes
+// them with Worker::wake().
+//
+// A new kernel takes over by running both kernels across one tail partition of output and
+// crossfading them. Head and tail switch over on the same sample, so the two halves always
+// belong to the same mix of kernels.
+//
+// The head partition is the latency/CPU tradeoff: every halving saves half its delay, and costs
+// more FFTs and more head partitions on the audio thread.
+class LinearPhaseEngine {
+public:
+    static constexpr int DEFAULT_KERNEL_ORDER = 14;
+    static constexpr int MIN_HEAD_ORDER = 6;
+    static constexpr int MAX_HEAD_ORDER = 10;
+    static constexpr int DEFAULT_HEAD_ORDER = 8;
+    static constexpr int DEFAULT_LATENCY_SAMPLES = (1 << DEFAULT_KERNEL_ORDER) / 2 + (1 << DEFAULT_HEAD_ORDER);
+    static constexpr int TAIL_ORDER_STEP = 4;
+    static constexpr size_t MAX_SECTIONS = BiquadCascade::MAX_SECTIONS;
+
+    /** The response to render: the product of the sections' magnitude responses. */
+    struct Response {
+        std::array<BiquadFilter::Coefficients, MAX_SECTIONS> sections{};
+        size_t numSections{0};
+
+        bool operator==(const Response& other) const noexcept;
+    };
+
+    explicit LinearPhaseEngine(int kernelOrder = DEFAULT_KERNEL_ORDER);
+    ~LinearPhaseEngine();
+
+    /** Sets the head partition size as a power of two, from MIN_HEAD_ORDER to MAX_HEAD_ORDER.
+        Takes effect at the next prepare(). */
+    void setHeadOrder(int order);
+
+    /** Allocates nothing when neither the channel count nor the head order changed. */
+    void prepare(int numChannels);
+    void reset() noexcept;
+
+    /** Hands over the response to render. Returns straight away; when the response changed, a
+        new kernel is designed in the background and faded in once it is ready. */
+    void setResponse(const Response& response) noexcept;
+    void processBlock(juce::AudioBuffer<float>& buffer) noexcept;
+
+    int getHeadPartitionSize() const noexcept { return 1 << headOrder_; }
+    int getTailPartitionSize() const noexcept { return 1 << getTailOrder(); }
+    int getLatencySamples() const noexcept { return kernelSize_ / 2 + getHeadPartitionSize(); }
+
+    /** True from a change of response until its kernel has fully taken over. */
+    bool isUpdatingKernel() const noexcept;
+
+private:
+    enum class KernelState { idle, ready, fading };
+    enum class TailJobState { pending, running, done };
+
+    // Runs one of the engine's loops. It sleeps on an atomic rather than with juce::Thread::wait(),
+    // since notify() signals a WaitableEvent, which locks a mutex. wake() is a futex wake, or the
+    // platform's equivalent, and fine on the audio thread.
+    class Worker : public juce::Thread {
+    public:
+        Worker(const juce::String& name, LinearPhaseEngine& engine, void (LinearPhaseEngine::*loop)())
+            : juce::Thread(name), engine_(engine), loop_(loop) {}
+
+        void run() override { (engine_.*loop_)(); }
+
+        void wake() noexcept {
+            wakeups_.fetch_add(1, std::memory_order_release);
+            wakeups_.notify_one();
+        }
+
+        /** Taken before looking for work, and handed to sleep(), so that a wake() in between is
+            not lost. */
+        uint32_t getWakeups() const noexcept { return wakeups_.load(std::memory_order_acquire); }
+        void sleep(uint32_t wakeups) const noexcept { wakeups_.wait(wakeups, std::memory_order_acquire); }
+
+        void stop() {
+            signalThreadShouldExit();
+            wake();
+            stopThread(1000);
+        }
+
+    private:
+        LinearPhaseEngine& engine_;
+        void (LinearPhaseEngine::*loop_)();
+        std::atomic<uint32_t> wakeups_{0};
+    };
+
+    struct Kernel {
+        std::vector<float> head;
+        std::vector<float> tail;
+    };
+
+    // One tail partition of input, and the output it makes, in blocks of a tail partition per
+    // channel. Whoever moves the state from pending to running computes it.
+    struct TailJob {
+        std::vector<float> input;
+        std::vector<float> output;
+        size_t kernel{0};
+        bool fadesIn{false};
+        std::atomic<juce::int64> index{0};
+        std::atomic<TailJobState> state{TailJobState::done};
+    };
+
+    int getTailOrder() const noexcept;
+
+    void designKernels();
+    void designKernel(const Response& response, Kernel& kernel);
+    void transformKernel(Kernel& kernel);
+
+    void processPartition() noexcept;
+    void submitTailJob() noexcept;
+    void collectTailJob() noexcept;
+    void computeTailJobs();
+    void computeTailJob(TailJob& job) noexcept;
+    void finishTailJob(TailJob& job, juce::int64 index) noexcept;
+    void cancelTailJobs() noexcept;
+    void finishFade() noexcept;
+    TailJob& getTailJob(juce::int64 index) noexcept;
+
+    const int kernelOrder_;
+    const int kernelSize_;
+    int headOrder_{DEFAULT_HEAD_ORDER};
+    int nextHeadOrder_{DEFAULT_HEAD_ORDER};
+    int numChannels_{0};
+    size_t headSize_{0};
+    size_t tailSize_{0};
+
+    // Audio thread.
+    UniformConvolution head_;
+    std::vector<float> inputs_;
+    std::vector<float> outputs_;
+    std::vector<float> fadeBuffer_;
+    std::vector<float> tailInputs_;
+    std::vector<float> tailOutputs_;
+    int fifoPosition_{0};
+    size_t tailInputPosition_{0};
+    size_t tailOutputPosition_{0};
+    juce::int64 outputPosition_{0};
+    juce::int64 fadeStart_{0};
+    bool isFading_{false};
+    juce::int64 numTailJobsSubmitted_{0};
+    int numTailJobsInFlight_{0};
+    Response lastResponse_{};
+    bool responseUnsent_{false};
+
+    // Whoever computes the tail job, one at a time and in order.
+    UniformConvolution tail_;
+    std::vector<float> tailFadeBuffer_;
+    std::array<TailJob, 2> tailJobs_;
+    std::atomic<juce::int64> numTailJobsCompleted_{0};
+
+    // Kernel design thread.
+    juce::dsp::FFT designFft_;
+    std::unique_ptr<juce::dsp::FFT> headDesignFft_;
+    std::unique_ptr<juce::dsp::FFT> tailDesignFft_;
+    std::vector<float> designBuffer_;
+    std::vector<float> designPartitionBuffer_;
+    std::vector<float> window_;
+
+    // Handover. The design thread only writes the inactive kernel while the state is idle; the
+    // audio thread swaps the two when it finds one ready and hands the old one back once the
+    // crossfade is over.
+    std::array<Kernel, 2> kernels_;
+    size_t activeKernel_{0};
+    std::atomic<KernelState> kernelState_{KernelState::idle};
+
+    juce::SpinLock responseLock_;
+    Response pendingResponse_{};
+    std::atomic<bool> responsePending_{false};
+    std::atomic<bool> designing_{false};
+
+    Worker designThread_{"Linear-phase EQ kernel design", *this, &LinearPhaseEngine::designKernels};
+    Worker tailThread_{"Linear-phase EQ tail convolution", *this, &LinearPhaseEngine::computeTailJobs};
+
+    JUCE_DECLARE_NON_COPYABLE(LinearPhaseEngine)
+};
+} // namespace parametric_eq
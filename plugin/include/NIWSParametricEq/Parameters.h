@@ -11,7 +11,9 @@ struct Parameters {
 
     juce::AudioParameterBool& bypassed; 
 
-    std::array<std::unique_ptr<BoostCutParameters>, ParametricEq::NUM_PEAKS> peakFilters;
+    // The whole pool of peaks; peakEnabled says which of them are in use.
+    std::array<std::unique_ptr<BoostCutParameters>, ParametricEq::MAX_PEAKS> peakFilters;
+    std::array<juce::AudioParameterBool*, ParametricEq::MAX_PEAKS> peakEnabled{};
     BoostCutParameters lowShelfParameters; 
     BoostCutParameters highShelfParameters; 
     BaseParameters lowPassParameters;
@@ -19,6 +21,15 @@ struct Parameters {
     
     juce::AudioParameterBool& isPost;
 
+    juce::AudioParameterBool& lowPassSteep;
+    juce::AudioParameterBool& highPassSteep;
+
+    juce::AudioParameterChoice& oversampling;
+    juce::AudioParameterBool& linearPhase;
+
+    // How finely the analyzer's spectrum is drawn; it has no effect on the sound.
+    juce::AudioParameterChoice* analyzerSmoothing{};
+
     JUCE_DECLARE_NON_COPYABLE(Parameters)
     JUCE_DECLARE_NON_MOVEABLE(Parameters)
 };
@@ -3,9 +3,15 @@
 #include "NIWSParametricEq/filters/PeakFilter.h"
 #include "NIWSParametricEq/filters/LowShelfFilter.h"
 #include "NIWSParametricEq/filters/HighShelfFilter.h"
-#include "NIWSParametricEq/filters/LowPassFilter.h"
-#include "NIWSParametricEq/filters/HighPassFilter.h"
+#include "NIWSParametricEq/filters/PassFilterCascade.h"
+#include "NIWSParametricEq/filters/SvfFilter.h"
+#include "NIWSParametricEq/filters/ParallelSections.h"
+#include "NIWSParametricEq/filters/MultirateSplit.h"
+#include "NIWSParametricEq/LinearPhaseEngine.h"
 #include "filters/BiquadFilter.h"
+#include "filters/BiquadCascade.h"
+#include <atomic>
+#include <bit>
 
 namespace parametric_eq {
 enum class Slope : uint8_t {
@@ -17,8 +23,24 @@ enum class Slope : uint8_t {
 };
 class ParametricEq {
 public:
-    static size_t const NUM_PEAKS = 4;
-    static std::array<double, NUM_PEAKS> constexpr DEFAULT_FREQS = {100.0, 250.0, 1050.0, 2500.0};
+    // The biquad engine designs at control rate and ramps the coefficients in between; the
+    // state-variable engine retunes every sample and suits audio-rate modulation. Steep HP/LP
+    // slopes are only available from the biquad engine; the state-variable engine falls back
+    // to the Butterworth slopes. The linear-phase engine convolves with an FIR kernel that has
+    // the biquad bands' magnitude response, at the cost of getLatencySamples() of delay. The
+    // parallel engine runs the biquad bands' cascade as a sum of parallel sections, redesigned
+    // once per control interval; see ParallelSections.
+    enum class Engine { biquad, stateVariable, linearPhase, parallel };
+
+    // The peaks are a pool of MAX_PEAKS preallocated bands, of which the first DEFAULT_NUM_PEAKS
+    // start enabled. Only the enabled ones, and those still fading out after being disabled, are
+    // designed, settled and processed, so the cost follows the number of bands in use.
+    static constexpr size_t MAX_PEAKS = 24;
+    static constexpr size_t DEFAULT_NUM_PEAKS = 4;
+    static std::array<double, MAX_PEAKS> constexpr DEFAULT_FREQS = {
+        100.0, 250.0, 1050.0, 2500.0, 50.0, 500.0, 5000.0, 10000.0, 160.0, 400.0, 700.0, 1600.0,
+        3500.0, 7000.0, 13000.0, 30.0, 70.0, 130.0, 200.0, 330.0, 800.0, 2000.0, 4500.0, 16000.0};
+    static constexpr int DEFAULT_CONTROL_INTERVAL = 32;
 
     ParametricEq() = default;
     ~ParametricEq() = default;
@@ -27,28 +49,178 @@ public:
     void reset();
     void processBlock(juce::AudioBuffer<float>& buffer);
 
+    /** Processes a double buffer. The biquad engine runs on it directly, with multirate too,
+        where only the low bands' changes go through float. The state-variable, linear-phase and
+        parallel engines work in float and take it through FLOAT_CHUNK_SIZE samples at a time. */
+    void processBlock(juce::AudioBuffer<double>& buffer);
+
+    static constexpr int FLOAT_CHUNK_SIZE = 256;
+
     void prepareFilters();
+    void setControlInterval(int numSamples);
+
+    /** Moves every band straight to its latest parameters, without the usual glide. Meant for
+        right after prepare(), which starts the bands from their defaults. */
+    void settleParameters();
+
+    void setEngine(Engine engine);
+    Engine getEngine() const noexcept { return engine_; }
+
+    /** Delay added by the current engine, in samples, a multiple of the latency multiple. */
+    int getLatencySamples() const noexcept;
+
+    /** Makes the latency a multiple of numSamples, a power of two, so that it comes to whole
+        samples at a rate that many times lower, as it has to inside an oversampler. Takes effect
+        at the next prepare(). */
+    void setLatencyMultiple(int numSamples);
+
+    // At 88.2 kHz and up, multirate processing runs the low shelf and the high-pass of the
+    // biquad engine at the rate halved until it is down to MULTIRATE_BASE_RATE, where their poles
+    // are further from z = 1 and cost a fraction of the CPU; see MultirateSplit. It adds the
+    // split's latency, and the two bands report their response at the reduced rate. A band that
+    // reaches up to the split's passband edge, within MULTIRATE_TOLERANCE_DB, stays at the full
+    // rate until it moves back down.
+    static constexpr double MULTIRATE_BASE_RATE = 44100.0;
+    static constexpr float MULTIRATE_TOLERANCE_DB = 0.1f;
+
+    void setMultirate(bool shouldUseMultirate);
+
+    /** True while the low bands run at a reduced rate: multirate is on, the biquad engine runs
+        and the sample rate is high enough. */
+    bool isMultirateActive() const noexcept;
+
+    /** Designs and runs the biquad bands in double rather than float, for float and double
+        buffers alike; see BiquadFilter::setDoublePrecision(). The state-variable and parallel
+        engines run in float regardless, and the linear-phase engine convolves in float, so a
+        double buffer only keeps its precision through the biquad engine. */
+    void setDoublePrecision(bool shouldUseDoublePrecision);
+    bool isUsingDoublePrecision() const noexcept { return doublePrecision_; }
+
+    /** Design mode of the biquad peaks and shelves; see BiquadFilter::DesignMode. */
+    void setDesignMode(BiquadFilter::DesignMode mode);
+
+    /** Adds a peak to the bands in use or takes it out, fading it like a bypass. Lock-free, and
+        safe to call from any thread; the audio thread picks the change up on its next block. */
+    void setPeakEnabled(size_t bandIndex, bool shouldBeEnabled) noexcept;
+    bool isPeakEnabled(size_t bandIndex) const noexcept;
 
     void setPeakParameters(size_t bandIndex, double frequency, double Q, float gainDb, bool isBypassed);
     void setLowShelfParameters(double frequency, double Q, float gainDb, bool isBypassed, int slopeIndex);
     void setHighShelfParameters(double frequency, double Q, float gainDb, bool isBypassed, int slopeIndex);
-    void setLowPassParameters(double frequency, double Q, bool isBypassed, int slopeIndex);
-    void setHighPassParameters(double frequency, double Q, bool isBypassed, int slopeIndex);
+    void setLowPassParameters(double frequency, double Q, bool isBypassed, int slopeIndex, bool isSteep = false);
+    void setHighPassParameters(double frequency, double Q, bool isBypassed, int slopeIndex, bool isSteep = false);
 
+    /** The enabled peaks followed by the shelves and the pass sections in use. The pass sections
+        are for their responses; see PassFilterCascade::getSection(). */
     std::vector<BiquadFilter*> getBands() noexcept;
 private:
-    static constexpr int MAX_SLOPE_SECTIONS = 8;
+    using PeakMask = uint32_t;
+    static_assert(MAX_PEAKS <= std::numeric_limits<PeakMask>::digits);
+    static constexpr PeakMask DEFAULT_PEAK_MASK = (PeakMask{1} << DEFAULT_NUM_PEAKS) - 1;
+
+    static constexpr PeakMask peakBit(size_t bandIndex) noexcept { return PeakMask{1} << bandIndex; }
+
+    template <typename Function>
+    static void forEachPeak(PeakMask mask, Function&& function) {
+        for (; mask != 0; mask &= mask - 1) {
+            function(static_cast<size_t>(std::countr_zero(mask)));
+        }
+    }
+
+    template <typename Function>
+    void forEachPooledPeak(Function&& function) { forEachPeak(peakPool_, std::forward<Function>(function)); }
 
-    int numLowPassSections_ = 1;
-    int numHighPassSections_ = 1;
+    void updatePeakPool();
+    void applyPeakBypass(size_t bandIndex);
+    bool isPeakIdle(size_t bandIndex) const noexcept;
 
-    std::array<PeakFilter, NUM_PEAKS> peakFilters_;
+    static constexpr int MAX_SLOPE_SECTIONS = PassFilterCascade::MAX_SECTIONS;
+    static constexpr size_t NUM_SLOPES = 5;
+
+    static constexpr size_t LOW_SHELF_SLOT = MAX_PEAKS;
+    static constexpr size_t HIGH_SHELF_SLOT = LOW_SHELF_SLOT + 1;
+    static constexpr size_t LOW_PASS_SLOT = HIGH_SHELF_SLOT + 1;
+    static constexpr size_t HIGH_PASS_SLOT = LOW_PASS_SLOT + MAX_SLOPE_SECTIONS;
+    static_assert(HIGH_PASS_SLOT + MAX_SLOPE_SECTIONS <= BiquadCascade::MAX_SECTIONS);
+
+    static std::array<EllipticPrototype, NUM_SLOPES> designSteepPrototypes();
+    const EllipticPrototype* getSteepPrototype(int slopeIndex, bool isSteep) const noexcept;
+
+    using SvfSlope = std::array<SvfFilter, MAX_SLOPE_SECTIONS>;
+
+    static SvfSlope makeSvfSlope(SvfFilter::Type type);
+
+    bool isLowBandSlot(size_t slot) const noexcept;
+    static bool isLeftAloneAboveEdge(float edgeDb, bool isReduced) noexcept;
+    int getMultirateStages() const noexcept;
+    MultirateSplit& getLowBandSplit() noexcept;
+    const MultirateSplit& getLowBandSplit() const noexcept;
+    void resetLowBandSplits() noexcept;
+    void updateLowBandRate();
+
+    void assignCascadeSlots();
+    void appendIfActive(size_t slot, BiquadFilter& section, size_t& numActive);
+    size_t collectActiveSlots();
+
+    template <typename SampleType>
+    void processBiquadEngine(juce::AudioBuffer<SampleType>& buffer);
+    void processStateVariableEngine(juce::AudioBuffer<float>& buffer);
+    void processLinearPhaseEngine(juce::AudioBuffer<float>& buffer);
+    void processParallelEngine(juce::AudioBuffer<float>& buffer);
+    void settleBiquadEngine();
+    void settleStateVariableEngine();
+    void setSvfSlopeParameters(SvfSlope& slope, int& numSections, double frequency, double Q, bool isBypassed,
+        int slopeIndex);
+
+    // Set from any thread; the rest of the pool state belongs to the audio thread. peakPool_ holds
+    // the enabled peaks and the disabled ones whose fade has not finished.
+    std::atomic<PeakMask> enabledPeaks_{DEFAULT_PEAK_MASK};
+    PeakMask appliedPeaks_{DEFAULT_PEAK_MASK};
+    PeakMask peakPool_{DEFAULT_PEAK_MASK};
+    std::array<bool, MAX_PEAKS> peakBypassed_{};
+
+    std::array<PeakFilter, MAX_PEAKS> peakFilters_;
     LowShelfFilter lowShelfFilter_;
     HighShelfFilter highShelfFilter_;
-    std::array<LowPassFilter, MAX_SLOPE_SECTIONS> lowPassFilters_;
-    std::array<HighPassFilter, MAX_SLOPE_SECTIONS> highPassFilters_;
+    PassFilterCascade lowPass_{PassFilterCascade::Type::lowPass};
+    PassFilterCascade highPass_{PassFilterCascade::Type::highPass};
+    const std::array<EllipticPrototype, NUM_SLOPES> steepPrototypes_{designSteepPrototypes()};
+
+    std::array<SvfFilter, MAX_PEAKS> svfPeaks_;
+    SvfFilter svfLowShelf_{SvfFilter::Type::lowShelf};
+    SvfFilter svfHighShelf_{SvfFilter::Type::highShelf};
+    SvfSlope svfLowPass_{makeSvfSlope(SvfFilter::Type::lowPass)};
+    SvfSlope svfHighPass_{makeSvfSlope(SvfFilter::Type::highPass)};
+    int svfLowPassSections_{1};
+    int svfHighPassSections_{1};
+
+    LinearPhaseEngine linearPhase_;
+    LinearPhaseEngine::Response linearPhaseResponse_{};
+
+    BiquadCascade cascade_;
+    ParallelSections parallel_;
+
+    // One split per stage count, indexed by the count less one; multirateStages_ picks the one
+    // for the sample rate.
+    std::array<MultirateSplit, MultirateSplit::MAX_STAGES> lowBandSplits_;
+    int multirateStages_{0};
+    BiquadCascade lowBandCascade_;
+    std::array<size_t, BiquadCascade::MAX_SECTIONS> lowBandSlots_{};
+    bool multirate_{false};
+    double reducedRate_{44100.0};
+    bool lowShelfReduced_{false};
+    bool highPassReduced_{false};
+
+    juce::AudioBuffer<float> floatBuffer_;
+
+    std::array<size_t, BiquadCascade::MAX_SECTIONS> activeSlots_{};
+    std::array<bool, BiquadCascade::MAX_SECTIONS> slotIdle_{};
 
     double sampleRate_{44100.0};
     int numChannels_;
+    int controlInterval_{DEFAULT_CONTROL_INTERVAL};
+    int latencyMultiple_{1};
+    Engine engine_{Engine::biquad};
+    bool doublePrecision_{false};
 };
 } // namespace parametric_eq
@@ -20,21 +20,33 @@ private:
   void timerCallback() override;
   void selectFilter(BandComponent& band, FilterSelection selection);
   void clearSelectedFilter();
+  void selectPeak(size_t index);
+  void addPeak();
+  void removeSelectedPeak();
+  void updatePeakBands();
+  std::vector<BandComponent*> getAllBands();
 
   AudioPluginAudioProcessor& processorRef;
   juce::TextButton postButton_{"Post"};
   juce::TextButton bypassButton_{"Bypass"};
+  juce::TextButton linearPhaseButton_{"Linear"};
+  juce::TextButton addPeakButton_{"+ Band"};
+  juce::TextButton removePeakButton_{"- Band"};
+  juce::ComboBox oversamplingBox_;
+  juce::ComboBox smoothingBox_;
   std::unique_ptr<juce::ButtonParameterAttachment> postAttachment_;
   std::unique_ptr<juce::ButtonParameterAttachment> bypassAttachment_;
+  std::unique_ptr<juce::ButtonParameterAttachment> linearPhaseAttachment_;
+  std::unique_ptr<juce::ComboBoxParameterAttachment> oversamplingAttachment_;
+  std::unique_ptr<juce::ComboBoxParameterAttachment> smoothingAttachment_;
 
   FrequencyAxis frequencyAxis_;
   FrequencyResponseGUI frequencyResponseGUI_;
   FilterInspectorPanel filterInspectorPanel_;
 
-  BandComponent peakBand0_;
-  BandComponent peakBand1_;
-  BandComponent peakBand2_;
-  BandComponent peakBand3_;
+  // One per peak of the pool, shown while the peak is enabled.
+  std::array<std::unique_ptr<BandComponent>, ParametricEq::MAX_PEAKS> peakBands_;
+  std::vector<BiquadFilter*> referenceBands_;
 
   BandComponent lowPassBand_;
   BandComponent highPassBand_;
@@ -6,6 +6,8 @@
 #include "SpectrumAnalyzer.h"
 #include "BypassTransitioner.h"
 #include "Lfo.h"
+#include <type_traits>
+#include <vector>
 
 namespace parametric_eq {
 class AudioPluginAudioProcessor : public juce::AudioProcessor {
@@ -19,7 +21,8 @@ public:
   bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
   void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-  using AudioProcessor::processBlock;
+  void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+  bool supportsDoublePrecisionProcessing() const override { return true; }
 
   juce::AudioProcessorEditor* createEditor() override;
   bool hasEditor() const override;
@@ -51,15 +54,66 @@ public:
   const ParametricEq& getParametricEq() const noexcept { return parametricEq_; }
 
 private:
+  // The 2x and 4x settings, plus the 8x an offline render of the 4x setting switches to.
+  static constexpr int MAX_OVERSAMPLING_STAGES = 3;
+
+  // The oversamplers and the dry path, in the sample type the host processes in. Only the path for
+  // the current precision is prepared.
+  template <typename SampleType>
+  struct SignalPath {
+    std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, MAX_OVERSAMPLING_STAGES> oversamplers;
+    juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
+    juce::AudioBuffer<SampleType> delayedDryBuffer;
+    juce::AudioBuffer<SampleType> discardedWetBuffer;
+    // The oversampled block's channels, one per channel the EQ was prepared for.
+    std::vector<SampleType*> oversampledChannels;
+  };
+
+  template <typename SampleType>
+  SignalPath<SampleType>& getSignalPath() noexcept {
+    if constexpr (std::is_same_v<SampleType, double>) {
+      return doublePath_;
+    } else {
+      return floatPath_;
+    }
+  }
+
+  template <typename Function>
+  decltype(auto) withActiveSignalPath(Function&& function) {
+    return isUsingDoublePrecision() ? function(doublePath_) : function(floatPath_);
+  }
+
+  template <typename SampleType>
+  void prepareSignalPath(SignalPath<SampleType>& path, int numChannels, int totalNumChannels, double sampleRate,
+                         int samplesPerBlock);
+
+  int getOversamplingStages() const;
+  void setOversamplingStages(int numStages);
+  void updateProcessingMode();
+  void updateEqParameters(int numSamples);
+  template <typename SampleType>
+  void processBlockInPrecision(juce::AudioBuffer<SampleType>& buffer);
+  template <typename SampleType>
+  void processOversampled(juce::AudioBuffer<SampleType>& buffer);
+  template <typename SampleType>
+  void delayDrySignal(juce::AudioBuffer<SampleType>& buffer) noexcept;
+
   ParametricEq parametricEq_;
   Parameters parameters_{*this};
   SpectrumAnalyzer spectrumAnalyzer_{12}; 
 
   BypassTransitioner bypassTransitioner_{0.02};
-  std::array<Lfo, ParametricEq::NUM_PEAKS> peakGainLfos_;
+  std::array<Lfo, ParametricEq::MAX_PEAKS> peakGainLfos_;
   Lfo lowShelfGainLfo_;
   Lfo highShelfGainLfo_;
 
+  SignalPath<float> floatPath_;
+  SignalPath<double> doublePath_;
+  double baseSampleRate_{44100.0};
+  int oversamplingStages_{0};
+  int numEqChannels_{0};
+  bool eqNeedsSettling_{false};
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
 };
 }  // namespace parametric_eq
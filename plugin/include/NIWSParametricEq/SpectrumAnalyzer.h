@@ -1,32 +1,163 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
 #include "utils/RingBuffer.h"
+#include "utils/TripleBuffer.h"
 
+// The audio thread only queues its samples, into a lock-free single-producer FIFO. A background
+// thread drains it, runs the FFTs and publishes the spectrum through a triple buffer, so the GUI
+// reads whole frames without locking and without tearing.
+//
+// The spectrum comes out as NUM_POINTS levels evenly spaced in log frequency; see
+// getPointFrequency(). Successive FFTs overlap by getOverlap(). In multi-resolution mode, each
+// point takes its level from the shortest of the NUM_RESOLUTIONS transforms, each a quarter the
+// length of the one before, that still has MIN_BINS_BELOW bins below it: the low octaves keep the
+// frequency resolution of the longest FFT and the high ones get the time response of the short
+// ones. Otherwise every point comes from the longest.
+//
+// Whatever shows the spectrum registers as a consumer. With none, the caller skips pushBlock()
+// and the analysis thread sleeps; the ring keeps the samples it last had, so a new consumer sees
+// frames again after the shortest hop instead of a whole transform.
 class SpectrumAnalyzer {
 public:
+    static constexpr size_t NUM_POINTS = 512;
+    static constexpr double MIN_FREQUENCY = 20.0;
+    static constexpr double MAX_FREQUENCY = 20000.0;
+
+    static constexpr int NUM_RESOLUTIONS = 3;
+    static constexpr int ORDER_STEP = 2;
+    static constexpr double MIN_BINS_BELOW = 8.0;
+
+    static constexpr float MIN_OVERLAP = 0.5f;
+    static constexpr float MAX_OVERLAP = 0.875f;
+    static constexpr float DEFAULT_OVERLAP = 0.75f;
+
+    /** Cost of the analysis, measured on its thread over the last STATS_INTERVAL_MS. */
+    struct Stats {
+        double framesPerSecond{0.0};
+        double transformsPerSecond{0.0};
+        // Share of the analysis thread's time spent working rather than waiting for samples.
+        double threadLoad{0.0};
+    };
+
+    /** fftOrder is the order of the longest transform. */
     SpectrumAnalyzer(int fftOrder);
+    ~SpectrumAnalyzer();
 
+    /** Restarts the analysis thread for the new rate and channel count. Not on the audio thread. */
     void prepare(double sampleRate, int numInputChannels);
-    void pushBlock(const juce::AudioBuffer<float>& buffer);
 
-    bool isNewFFTReady() const noexcept { return newFFTReady_; }
-    const std::vector<float>& getMagnitudesDb() const { return magnitudeDb_; }
-    void clearNewFFTFlag() noexcept { newFFTReady_ = false; }
+    /** Queues the block for analysis without locking or allocating. What the FIFO has no room
+        for, while the analysis thread is behind, is dropped. */
+    template <typename SampleType>
+    void pushBlock(const juce::AudioBuffer<SampleType>& buffer) noexcept;
+
+    /** GUI thread. Takes the newest levels, if a frame came in since the last call, and says
+        whether one did. */
+    bool updateMagnitudesDb() noexcept { return magnitudesDb_.update(); }
+    const std::vector<float>& getMagnitudesDb() const noexcept { return magnitudesDb_.getReadBuffer(); }
+
+    static double getPointFrequency(size_t point) noexcept;
+
+    /** Fraction by which successive transforms overlap, from MIN_OVERLAP to MAX_OVERLAP. Safe to
+        call from any thread. */
+    void setOverlap(float overlap) noexcept;
+    float getOverlap() const noexcept { return overlap_.load(std::memory_order_relaxed); }
+
+    /** Safe to call from any thread. */
+    void setMultiResolution(bool shouldUseMultiResolution) noexcept;
+    bool isMultiResolution() const noexcept { return multiResolution_.load(std::memory_order_relaxed); }
+
+    Stats getStats() const noexcept;
+
+    /** Counts a reader of the spectrum in or out, and wakes the analysis thread for the first.
+        Message thread. */
+    void addConsumer() noexcept;
+    void removeConsumer() noexcept;
+
+    /** Whether anyone reads the spectrum. Cheap enough to check on the audio thread before
+        every pushBlock(). */
+    bool hasConsumers() const noexcept { return numConsumers_.load(std::memory_order_relaxed) > 0; }
 
 private:
-    void performFFT();
+    class AnalysisThread : public juce::Thread {
+    public:
+        explicit AnalysisThread(SpectrumAnalyzer& analyzer)
+            : juce::Thread("Spectrum analysis"), analyzer_(analyzer) {}
+
+        void run() override { analyzer_.analyze(); }
+
+    private:
+        SpectrumAnalyzer& analyzer_;
+    };
+
+    // One transform length, with its levels in dB per bin. Shorter transforms gather less energy
+    // from a tone, which levelOffsetDb makes up for, so that all of them read alike.
+    struct Resolution {
+        explicit Resolution(int order, size_t longestSize);
+
+        size_t size;
+        juce::dsp::FFT fft;
+        juce::dsp::WindowingFunction<float> window;
+        std::vector<float> buffer;
+        std::vector<float> magnitudesDb;
+        float levelOffsetDb;
+        RingBuffer::Cursor cursor;
+    };
+
+    // Where a display point takes its level from: the loudest of the bins from firstBin to
+    // lastBin of one resolution, or, when no bin falls within the point, the level interpolated
+    // at binPosition.
+    struct Point {
+        size_t resolution{0};
+        size_t firstBin{0};
+        size_t lastBin{0};
+        float binPosition{0.0f};
+    };
+
+    using PointMap = std::array<Point, NUM_POINTS>;
+
+    // The analysis thread looks for new samples this often; the audio thread never wakes it,
+    // since signalling takes a lock.
+    static constexpr int POLL_INTERVAL_MS = 10;
+    static constexpr double STATS_INTERVAL_MS = 1000.0;
+
+    void analyze();
+    int getHopSize(const Resolution& resolution) const noexcept;
+    void restartCursors() noexcept;
+    void drainFifo();
+    void performFFT(Resolution& resolution);
+    void publishPoints(const PointMap& points);
+    void buildPointMap(PointMap& points, bool isMultiResolution) const;
+    void resetStats() noexcept;
+    void updateStats(juce::int64 workTicks, int numTransforms, bool published);
 
-    int fftOrder_;
     size_t fftSize_;
+    double sampleRate_{44100.0};
 
-    juce::dsp::FFT fft_;
-    juce::dsp::WindowingFunction<float> window_;
+    std::atomic<float> overlap_{DEFAULT_OVERLAP};
+    std::atomic<bool> multiResolution_{true};
+    std::atomic<int> numConsumers_{0};
 
+    // Audio thread to analysis thread.
+    juce::AbstractFifo fifo_{1};
+    juce::AudioBuffer<float> fifoBuffer_;
+
+    // Analysis thread.
     RingBuffer ringBuffer_;
-    int samplesSinceLastFFT_{0};
+    std::array<std::unique_ptr<Resolution>, NUM_RESOLUTIONS> resolutions_;
+    PointMap singleResolutionPoints_{};
+    PointMap multiResolutionPoints_{};
+
+    double statsStartMs_{0.0};
+    juce::int64 statsWorkTicks_{0};
+    int statsTransforms_{0};
+    int statsFrames_{0};
 
-    std::vector<float> fftBuffer_; 
-    std::vector<float> magnitudeDb_; 
+    // Analysis thread to GUI.
+    TripleBuffer<std::vector<float>> magnitudesDb_;
+    std::atomic<double> framesPerSecond_{0.0};
+    std::atomic<double> transformsPerSecond_{0.0};
+    std::atomic<double> threadLoad_{0.0};
 
-    std::atomic<bool> newFFTReady_{false};
-};
\ No newline at end of file
+    AnalysisThread analysisThread_{*this};
+};
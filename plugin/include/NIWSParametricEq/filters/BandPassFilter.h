@@ -2,33 +2,31 @@
 #include <numbers>
 
 #include "FilterParameters.h"
-class BandPassFilter : public BiquadFilter {
+class BandPassFilter : public BiquadFilterDesign<BandPassFilter> {
 public:
     BandPassFilter() = default;
     ~BandPassFilter() override = default;
 private:
-    void calculateAndSetCoefficients(float Q, float amplitude, float frequency) override {
-        juce::ignoreUnused(amplitude);
+    friend class BiquadFilter;
 
-        const auto sampleRate = static_cast<float>(sampleRate_);
-        const auto w0 = 2.0f * std::numbers::pi_v<float> * frequency / sampleRate;
-        const auto cos_w = static_cast<float>(std::cos(w0));
-        const auto alpha = std::sin(w0) / (2.0f * Q);
+    void calculateAndSetCoefficients(float Q, float amplitude, float frequency) override {
+        designInPrecision([this](auto q, auto, auto f) { return design(q, f); }, Q, amplitude, frequency);
+    }
 
-        float a0 = 1.f + alpha;
+    template <typename T>
+    BiquadCoefficients<T> design(T Q, T frequency) const noexcept {
+        const auto w0 = getOmega(frequency);
+        const auto [sin_w, cos_w] = fast_math::sinCosFor(w0);
+        const auto alpha = sin_w / (T(2) * Q);
 
-        float b0 = alpha;
-        float b1 = 0.f;
-        float b2 = -alpha;
-        float a1 = -2.f * cos_w;
-        float a2 = 1.f - alpha;
+        T a0 = T(1) + alpha;
 
-        b0 /= a0;
-        b1 /= a0;
-        b2 /= a0;
-        a1 /= a0;
-        a2 /= a0;
+        T b0 = alpha;
+        T b1 = T(0);
+        T b2 = -alpha;
+        T a1 = T(-2) * cos_w;
+        T a2 = T(1) - alpha;
 
-        setCoefficients(b0, b1, b2, a0, a1, a2);
+        return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
     }
 };
\ No newline at end of file
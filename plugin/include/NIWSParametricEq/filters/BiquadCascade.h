@@ -0,0 +1,433 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+
+#include "BiquadFilter.h"
+
+// Runs a chain of BiquadFilter sections in a single pass over the buffer. Each sample travels
+// through the whole active cascade while it is still in registers; the sections only supply
+// their smoothed coefficients and bypass mix, which are mirrored into structure-of-arrays slots
+// together with the per-channel states. Slots are fixed; a section that drops out of the active
+// list keeps its state until the owner clears it with resetSection().
+//
+// Several channels run side by side in SIMD lanes; a single channel runs through a pipeline that
+// puts consecutive sections in the lanes instead, see processPipelined(). In double precision,
+// or on double buffers, the cascade runs the scalar kernel, whose arithmetic follows the
+// precision and not the buffer; the states are kept in double for both.
+class BiquadCascade {
+public:
+    static constexpr size_t MAX_SECTIONS = 48;
+
+    BiquadCascade() = default;
+    ~BiquadCascade() = default;
+
+    void prepare(int numChannels) {
+        numChannels_ = numChannels;
+
+        const auto stateSize = MAX_SECTIONS * static_cast<size_t>(numChannels_);
+        z1_.assign(stateSize, 0.0);
+        z2_.assign(stateSize, 0.0);
+    }
+
+    void reset() noexcept {
+        std::fill(z1_.begin(), z1_.end(), 0.0);
+        std::fill(z2_.begin(), z2_.end(), 0.0);
+    }
+
+    void resetSection(size_t slot) noexcept {
+        jassert(slot < MAX_SECTIONS);
+        const auto first = static_cast<std::ptrdiff_t>(slot * static_cast<size_t>(numChannels_));
+        std::fill_n(z1_.begin() + first, numChannels_, 0.0);
+        std::fill_n(z2_.begin() + first, numChannels_, 0.0);
+    }
+
+    /** Runs the sections in double instead of float; the sections design in their own precision. */
+    void setDoublePrecision(bool shouldUseDoublePrecision) noexcept { doublePrecision_ = shouldUseDoublePrecision; }
+
+    void setSection(size_t slot, BiquadFilter* section) noexcept {
+        jassert(slot < MAX_SECTIONS);
+        sections_[slot] = section;
+
+        if (section != nullptr) {
+            loadCoefficients(slot);
+        }
+    }
+
+    BiquadFilter* getSection(size_t slot) const noexcept {
+        jassert(slot < MAX_SECTIONS);
+        return sections_[slot];
+    }
+
+    /** Filters the buffer through the sections in activeSlots, in that order. Only the channels
+        the cascade was prepared for are filtered; any others pass through. */
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, std::span<const size_t> activeSlots) noexcept {
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), numChannels_);
+
+        for (auto slot : activeSlots) {
+            jassert(slot < MAX_SECTIONS && sections_[slot] != nullptr);
+            if (sections_[slot]->consumeCoefficientsChanged()) {
+                loadCoefficients(slot);
+            }
+        }
+
+        if (doublePrecision_) {
+            processScalar<double>(buffer, activeSlots, numChannels);
+            return;
+        }
+
+#if JUCE_USE_SIMD
+        if constexpr (std::is_same_v<SampleType, float>) {
+            if (numChannels == 1 && isSteady(activeSlots)) {
+                processPipelined(buffer, activeSlots);
+                return;
+            }
+
+            if (numChannels > 1 && numChannels <= MAX_SIMD_CHANNELS) {
+                processSIMD(buffer, activeSlots, numChannels);
+                return;
+            }
+        }
+#endif
+        processScalar<float>(buffer, activeSlots, numChannels);
+    }
+
+private:
+    // The states of a slot sit side by side, one per prepared channel.
+    size_t getStateIndex(size_t slot, size_t channel) const noexcept {
+        return slot * static_cast<size_t>(numChannels_) + channel;
+    }
+
+    void loadCoefficients(size_t slot) noexcept {
+        const auto c = sections_[slot]->getCoefficients<double>();
+        b0_[slot] = c.b0;
+        b1_[slot] = c.b1;
+        b2_[slot] = c.b2;
+        a1_[slot] = c.a1;
+        a2_[slot] = c.a2;
+
+#if JUCE_USE_SIMD
+        const auto rounded = c.convertTo<float>();
+        b0v_[slot] = SIMDFloat::expand(rounded.b0);
+        b1v_[slot] = SIMDFloat::expand(rounded.b1);
+        b2v_[slot] = SIMDFloat::expand(rounded.b2);
+        a1v_[slot] = SIMDFloat::expand(rounded.a1);
+        a2v_[slot] = SIMDFloat::expand(rounded.a2);
+#endif
+    }
+
+    void advanceSections(std::span<const size_t> activeSlots) noexcept {
+        for (auto slot : activeSlots) {
+            auto& section = *sections_[slot];
+            mix_[slot] = section.advanceSample();
+
+            if (section.consumeCoefficientsChanged()) {
+                loadCoefficients(slot);
+            }
+        }
+    }
+
+    // Runs in T whatever the buffer holds; in float, the coefficients and states are rounded to
+    // float as they are used, which is exact for a float design.
+    template <typename T, typename SampleType>
+    void processScalar(juce::AudioBuffer<SampleType>& buffer, std::span<const size_t> activeSlots,
+                       int channelCount) noexcept {
+        const auto numChannels = static_cast<size_t>(channelCount);
+        const auto numSamples = buffer.getNumSamples();
+        auto* const* channelData = buffer.getArrayOfWritePointers();
+
+        for (int n = 0; n < numSamples; ++n) {
+            advanceSections(activeSlots);
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                auto x = static_cast<T>(channelData[ch][n]);
+
+                for (auto slot : activeSlots) {
+                    const auto mix = mix_[slot];
+                    if (mix <= BiquadFilter::EPSILON) {
+                        continue;
+                    }
+
+                    auto& z1 = z1_[getStateIndex(slot, ch)];
+                    auto& z2 = z2_[getStateIndex(slot, ch)];
+
+                    const auto y = static_cast<T>(b0_[slot]) * x + static_cast<T>(z1);
+                    z1 = static_cast<T>(b1_[slot]) * x - static_cast<T>(a1_[slot]) * y + static_cast<T>(z2);
+                    z2 = static_cast<T>(b2_[slot]) * x - static_cast<T>(a2_[slot]) * y;
+
+                    x = x + static_cast<T>(mix) * (y - x);
+                }
+
+                channelData[ch][n] = static_cast<SampleType>(x);
+            }
+        }
+    }
+
+#if JUCE_USE_SIMD
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int MAX_SIMD_CHANNELS = 8;
+    static constexpr size_t SIMD_LANES = SIMDFloat::size();
+    static constexpr size_t MAX_SIMD_GROUPS = (MAX_SIMD_CHANNELS + SIMD_LANES - 1) / SIMD_LANES;
+
+    static_assert(MAX_SECTIONS % SIMD_LANES == 0);
+
+    using StateRegisters = std::array<SIMDFloat, MAX_SECTIONS * MAX_SIMD_GROUPS>;
+    using Lanes = std::array<float, MAX_SIMD_GROUPS * SIMD_LANES>;
+
+    void loadStates(const std::vector<double>& states, StateRegisters& registers, Lanes& lanes,
+                    std::span<const size_t> activeSlots, size_t numChannels, size_t numGroups) const noexcept {
+        std::fill(lanes.begin(), lanes.end(), 0.0f);
+
+        for (auto slot : activeSlots) {
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                lanes[ch] = static_cast<float>(states[getStateIndex(slot, ch)]);
+            }
+
+            for (size_t g = 0; g < numGroups; ++g) {
+                registers[slot * MAX_SIMD_GROUPS + g] = SIMDFloat::fromRawArray(lanes.data() + g * SIMD_LANES);
+            }
+        }
+    }
+
+    void storeStates(std::vector<double>& states, const StateRegisters& registers, Lanes& lanes,
+                     std::span<const size_t> activeSlots, size_t numChannels, size_t numGroups) const noexcept {
+        for (auto slot : activeSlots) {
+            for (size_t g = 0; g < numGroups; ++g) {
+                registers[slot * MAX_SIMD_GROUPS + g].copyToRawArray(lanes.data() + g * SIMD_LANES);
+            }
+            std::copy_n(lanes.begin(), numChannels, states.begin() + static_cast<std::ptrdiff_t>(getStateIndex(slot, 0)));
+        }
+    }
+
+    // Lane k of group g carries channel g * SIMD_LANES + k; the coefficients are kept
+    // pre-broadcast per slot, so the inner loop is nothing but register arithmetic.
+    void processSIMD(juce::AudioBuffer<float>& buffer, std::span<const size_t> activeSlots, int channelCount) noexcept {
+        const auto numChannels = static_cast<size_t>(channelCount);
+        const auto numSamples = buffer.getNumSamples();
+        const auto numGroups = (numChannels + SIMD_LANES - 1) / SIMD_LANES;
+        auto* const* channelData = buffer.getArrayOfWritePointers();
+
+        alignas(SIMDFloat::SIMDRegisterSize) Lanes lanes{};
+        StateRegisters z1;
+        StateRegisters z2;
+
+        loadStates(z1_, z1, lanes, activeSlots, numChannels, numGroups);
+        loadStates(z2_, z2, lanes, activeSlots, numChannels, numGroups);
+        std::fill(lanes.begin(), lanes.end(), 0.0f);
+
+        for (int n = 0; n < numSamples; ++n) {
+            advanceSections(activeSlots);
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                lanes[ch] = channelData[ch][n];
+            }
+
+            for (size_t g = 0; g < numGroups; ++g) {
+                auto* groupLanes = lanes.data() + g * SIMD_LANES;
+                auto x = SIMDFloat::fromRawArray(groupLanes);
+
+                for (auto slot : activeSlots) {
+                    const auto mix = mix_[slot];
+                    if (mix <= BiquadFilter::EPSILON) {
+                        continue;
+                    }
+
+                    auto& s1 = z1[slot * MAX_SIMD_GROUPS + g];
+                    auto& s2 = z2[slot * MAX_SIMD_GROUPS + g];
+
+                    const auto y = b0v_[slot] * x + s1;
+                    s1 = b1v_[slot] * x - a1v_[slot] * y + s2;
+                    s2 = b2v_[slot] * x - a2v_[slot] * y;
+
+                    x = x + (y - x) * mix;
+                }
+
+                x.copyToRawArray(groupLanes);
+            }
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                channelData[ch][n] = lanes[ch];
+            }
+        }
+
+        storeStates(z1_, z1, lanes, activeSlots, numChannels, numGroups);
+        storeStates(z2_, z2, lanes, activeSlots, numChannels, numGroups);
+    }
+
+    bool isSteady(std::span<const size_t> activeSlots) const noexcept {
+        return std::all_of(activeSlots.begin(), activeSlots.end(),
+                           [this](size_t slot) { return sections_[slot]->isSteady(); });
+    }
+
+    // One stage of the mono pipeline per lane. Lanes past the last stage pass their input through.
+    struct Stages {
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> b0{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> b1{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> b2{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> a1{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> a2{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> mix{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> z1{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> z2{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> input{};
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SECTIONS> output{};
+        std::array<size_t, MAX_SECTIONS> slots{};
+        size_t numStages{0};
+    };
+
+    // Runs the stages from first to last of one step, as the vector step below does for all.
+    static void processStagesScalar(Stages& stages, size_t first, size_t last) noexcept {
+        for (auto k = first; k <= last; ++k) {
+            const auto x = stages.input[k];
+            const auto y = stages.b0[k] * x + stages.z1[k];
+            stages.z1[k] = stages.b1[k] * x - stages.a1[k] * y + stages.z2[k];
+            stages.z2[k] = stages.b2[k] * x - stages.a2[k] * y;
+            stages.output[k] = x + stages.mix[k] * (y - x);
+        }
+    }
+
+    // A mono signal leaves the lanes nothing to run side by side, as the sections of a cascade
+    // wait for each other. Skewing them in time does: stage k runs section k on sample n - k,
+    // which stage k - 1 finished on the step before, so every lane of a step is independent and
+    // each step moves every sample in flight one section on. The first and last steps of a block
+    // only have some of the stages filled and run those one by one, so nothing is held over to
+    // the next block and the latency stays zero.
+    //
+    // Stage k would see the coefficients for sample n rather than n - k, so this only runs while
+    // every section holds still; a glide or a bypass fade takes the scalar path. Holding still
+    // also lets the sections skip the whole block in one go instead of advancing per sample.
+    void processPipelined(juce::AudioBuffer<float>& buffer, std::span<const size_t> activeSlots) noexcept {
+        const auto numSamples = buffer.getNumSamples();
+        auto* data = buffer.getWritePointer(0);
+
+        Stages stages;
+
+        for (auto slot : activeSlots) {
+            mix_[slot] = sections_[slot]->advanceSteady(numSamples);
+
+            if (mix_[slot] <= BiquadFilter::EPSILON) {
+                continue;
+            }
+
+            const auto k = stages.numStages++;
+            stages.slots[k] = slot;
+            stages.b0[k] = static_cast<float>(b0_[slot]);
+            stages.b1[k] = static_cast<float>(b1_[slot]);
+            stages.b2[k] = static_cast<float>(b2_[slot]);
+            stages.a1[k] = static_cast<float>(a1_[slot]);
+            stages.a2[k] = static_cast<float>(a2_[slot]);
+            stages.mix[k] = mix_[slot];
+            stages.z1[k] = static_cast<float>(z1_[getStateIndex(slot, 0)]);
+            stages.z2[k] = static_cast<float>(z2_[getStateIndex(slot, 0)]);
+        }
+
+        const auto numStages = stages.numStages;
+        if (numStages == 0) {
+            return;
+        }
+
+        const auto numGroups = (numStages + SIMD_LANES - 1) / SIMD_LANES;
+        std::fill(stages.b0.begin() + static_cast<std::ptrdiff_t>(numStages), stages.b0.end(), 1.0f);
+        std::fill(stages.mix.begin() + static_cast<std::ptrdiff_t>(numStages), stages.mix.end(), 1.0f);
+
+        // Step t feeds sample t to the first stage and takes sample t - (numStages - 1) from the
+        // last. Every stage is busy from the step the pipeline fills until the input runs out.
+        const auto lastStage = static_cast<int>(numStages) - 1;
+        const auto numSteps = numSamples + lastStage;
+        const auto endOfFullSteps = juce::jmax(lastStage, numSamples);
+
+        const auto finishStep = [&](int t) {
+            if (t >= lastStage) {
+                data[t - lastStage] = stages.output[numStages - 1];
+            }
+
+            std::copy_n(stages.output.begin(), numStages - 1, stages.input.begin() + 1);
+        };
+
+        const auto runPartialStep = [&](int t) {
+            if (t < numSamples) {
+                stages.input[0] = data[t];
+            }
+
+            const auto first = static_cast<size_t>(juce::jmax(0, t - numSamples + 1));
+            const auto last = static_cast<size_t>(juce::jmin(t, lastStage));
+            processStagesScalar(stages, first, last);
+            finishStep(t);
+        };
+
+        int t = 0;
+
+        for (; t < lastStage; ++t) {
+            runPartialStep(t);
+        }
+
+        if (t < endOfFullSteps) {
+            std::array<SIMDFloat, MAX_SECTIONS / SIMD_LANES> z1;
+            std::array<SIMDFloat, MAX_SECTIONS / SIMD_LANES> z2;
+
+            for (size_t g = 0; g < numGroups; ++g) {
+                z1[g] = SIMDFloat::fromRawArray(stages.z1.data() + g * SIMD_LANES);
+                z2[g] = SIMDFloat::fromRawArray(stages.z2.data() + g * SIMD_LANES);
+            }
+
+            for (; t < endOfFullSteps; ++t) {
+                stages.input[0] = data[t];
+
+                for (size_t g = 0; g < numGroups; ++g) {
+                    const auto lane = g * SIMD_LANES;
+                    const auto x = SIMDFloat::fromRawArray(stages.input.data() + lane);
+                    const auto y = SIMDFloat::fromRawArray(stages.b0.data() + lane) * x + z1[g];
+                    z1[g] = SIMDFloat::fromRawArray(stages.b1.data() + lane) * x
+                            - SIMDFloat::fromRawArray(stages.a1.data() + lane) * y + z2[g];
+                    z2[g] = SIMDFloat::fromRawArray(stages.b2.data() + lane) * x
+                            - SIMDFloat::fromRawArray(stages.a2.data() + lane) * y;
+                    (x + (y - x) * SIMDFloat::fromRawArray(stages.mix.data() + lane))
+                        .copyToRawArray(stages.output.data() + lane);
+                }
+
+                finishStep(t);
+            }
+
+            for (size_t g = 0; g < numGroups; ++g) {
+                z1[g].copyToRawArray(stages.z1.data() + g * SIMD_LANES);
+                z2[g].copyToRawArray(stages.z2.data() + g * SIMD_LANES);
+            }
+        }
+
+        for (; t < numSteps; ++t) {
+            runPartialStep(t);
+        }
+
+        for (size_t k = 0; k < numStages; ++k) {
+            z1_[getStateIndex(stages.slots[k], 0)] = stages.z1[k];
+            z2_[getStateIndex(stages.slots[k], 0)] = stages.z2[k];
+        }
+    }
+
+    std::array<SIMDFloat, MAX_SECTIONS> b0v_{};
+    std::array<SIMDFloat, MAX_SECTIONS> b1v_{};
+    std::array<SIMDFloat, MAX_SECTIONS> b2v_{};
+    std::array<SIMDFloat, MAX_SECTIONS> a1v_{};
+    std::array<SIMDFloat, MAX_SECTIONS> a2v_{};
+#endif
+
+    std::array<BiquadFilter*, MAX_SECTIONS> sections_{};
+
+    std::array<double, MAX_SECTIONS> b0_{};
+    std::array<double, MAX_SECTIONS> b1_{};
+    std::array<double, MAX_SECTIONS> b2_{};
+    std::array<double, MAX_SECTIONS> a1_{};
+    std::array<double, MAX_SECTIONS> a2_{};
+    std::array<float, MAX_SECTIONS> mix_{};
+
+    std::vector<double> z1_;
+    std::vector<double> z2_;
+    int numChannels_{0};
+    bool doublePrecision_{false};
+};
@@ -1,9 +1,37 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <cmath>
+#include <numbers>
+#include <type_traits>
+#include <utility>
 #include <juce_dsp/juce_dsp.h>
 
+#include "../utils/FastMath.h"
+
+/** Normalised biquad coefficients (a0 = 1) in the precision of T. */
+template <typename T>
+struct BiquadCoefficients {
+    T b0;
+    T b1;
+    T b2;
+    T a1;
+    T a2;
+
+    template <typename U>
+    BiquadCoefficients<U> convertTo() const noexcept {
+        return {static_cast<U>(b0), static_cast<U>(b1), static_cast<U>(b2), static_cast<U>(a1), static_cast<U>(a2)};
+    }
+};
+
+// The parameters are smoothed in float, but the coefficients are designed and the signal is
+// filtered in float or in double, see setDoublePrecision(). Coefficients and states are kept in
+// double either way, which holds a float design exactly, so the float kernels lose nothing by it.
+//
+// Through this class the design is a virtual call. The concrete filter types derive from
+// BiquadFilterDesign below, whose processBlock() instantiates the kernels for that type, so the
+// design inlines into the per-sample loop; see designAs().
 class BiquadFilter {
 public:
     virtual ~BiquadFilter() = default;
@@ -11,47 +39,22 @@ public:
         sampleRate_ = sampleRate;
         numChannels_ = numChannels;
 
-        z1_.assign(static_cast<size_t>(numChannels_), 0.0f);
-        z2_.assign(static_cast<size_t>(numChannels_), 0.0f);
+        z1_.assign(static_cast<size_t>(numChannels_), 0.0);
+        z2_.assign(static_cast<size_t>(numChannels_), 0.0);
 
         bypassMix_.reset(sampleRate_, 0.005);
         bypassMix_.setCurrentAndTargetValue(isBypassed_ ? 0.0f : 1.0f); 
     }
 
     virtual void reset() {
-        std::fill(z1_.begin(), z1_.end(), 0.0f);
-        std::fill(z2_.begin(), z2_.end(), 0.0f);
+        std::fill(z1_.begin(), z1_.end(), 0.0);
+        std::fill(z2_.begin(), z2_.end(), 0.0);
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer) {
-        const auto numChannels = buffer.getNumChannels();
-        const auto numSamples = buffer.getNumSamples();
-
-        if (numChannels != numChannels_) {
-            prepare(sampleRate_, numChannels);
-        }
-
-        for (int n = 0; n < numSamples; ++n) {
-            updateSmoothedParameters();
-            float mix = bypassMix_.getNextValue();
-            if (mix <= EPSILON) {
-                continue;
-            }
-
-            for (int ch = 0; ch < numChannels; ++ch) {
-                auto* channelData = buffer.getWritePointer(ch);
-                auto x = channelData[n];
-
-                auto& z1 = z1_[static_cast<size_t>(ch)];
-                auto& z2 = z2_[static_cast<size_t>(ch)];
-
-                const auto y = b0_ * x + z1;
-                z1 = b1_ * x - a1_ * y + z2;
-                z2 = b2_ * x - a2_ * y;
-
-                channelData[n] = x + mix * (y - x);
-            }
-        }
+    /** Filters a float or a double buffer, in the filter's precision. */
+    template <typename SampleType>
+    void processBlock(juce::AudioBuffer<SampleType>& buffer) {
+        processBlockAs<BiquadFilter>(buffer);
     }
 
     void setParametersAndReset(double frequency, double Q, float amplitude = 0.0f) {
@@ -59,9 +62,7 @@ public:
         QRaw_ = Q;
         gainDbRaw_ = amplitude;
 
-        qSmoothed_.reset(sampleRate_, 0.02); 
-        gainSmoothed_.reset(sampleRate_, 0.01);
-        freqSmoothed_.reset(sampleRate_, 0.01);
+        resetSmoothers();
 
         qSmoothed_.setCurrentAndTargetValue(static_cast<float>(QRaw_));
         freqSmoothed_.setCurrentAndTargetValue(static_cast<float>(freqRaw_));
@@ -74,21 +75,81 @@ public:
         lastFreq_ = freqSmoothed_.getCurrentValue();
 
         calculateAndSetCoefficients(lastQ_, lastA_, lastFreq_);
+        coeffsDirty_ = false;
+        rampSamplesRemaining_ = 0;
+        samplesUntilControlUpdate_ = 0;
+        onCoefficientsDesigned(0);
 
         reset();
     }
 
+    /** Moves the filter to another sample rate, keeping its parameters: the glides finish at
+        once, the filter is designed for the new rate and its state is cleared. */
+    void setSampleRate(double sampleRate) {
+        prepare(sampleRate, numChannels_);
+        resetSmoothers();
+        coeffsDirty_ = true;
+        updateSmoothedParameters();
+    }
+
+    double getSampleRate() const noexcept { return sampleRate_; }
+
     void setBypassed(bool shouldBypass) noexcept {
         isBypassed_ = shouldBypass;
         bypassMix_.setTargetValue(shouldBypass ? 0.0f : 1.0f);
     }
 
+    bool isBypassed() const noexcept { return isBypassed_; }
+
     void setFrequency(double frequency) {
+        if (juce::exactlyEqual(freqRaw_, frequency)) {
+            return;
+        }
+
         freqRaw_ = frequency;
         freqSmoothed_.setTargetValue(static_cast<float>(freqRaw_));
         coeffsDirty_ = true;
     }
 
+    /** Sets how often, in samples, the coefficients are redesigned while parameters glide.
+        Values above 1 design once per interval and ramp the coefficients linearly in between;
+        1 keeps the per-sample update. */
+    void setControlInterval(int numSamples) noexcept {
+        controlInterval_ = juce::jmax(1, numSamples);
+        samplesUntilControlUpdate_ = 0;
+    }
+
+    int getControlInterval() const noexcept { return controlInterval_; }
+
+    // How the peak and shelf designs map their analog prototypes: the RBJ bilinear formulas, or
+    // the matched-magnitude design of MatchedDesign.h, which avoids cramping near Nyquist.
+    // The other filter types always use the bilinear transform.
+    enum class DesignMode { bilinear, matchedMagnitude };
+
+    void setDesignMode(DesignMode mode) noexcept {
+        if (mode == designMode_) {
+            return;
+        }
+
+        designMode_ = mode;
+        coeffsDirty_ = true;
+    }
+
+    DesignMode getDesignMode() const noexcept { return designMode_; }
+
+    /** Designs the coefficients and runs the filter state in double instead of float, whatever
+        the type of the buffers processed. Redesigns at the next update. */
+    void setDoublePrecision(bool shouldUseDoublePrecision) noexcept {
+        if (shouldUseDoublePrecision == doublePrecision_) {
+            return;
+        }
+
+        doublePrecision_ = shouldUseDoublePrecision;
+        coeffsDirty_ = true;
+    }
+
+    bool isUsingDoublePrecision() const noexcept { return doublePrecision_; }
+
     void setQ(double Q) {
         QRaw_ = Q;
         qSmoothed_.setTargetValue(static_cast<float>(QRaw_));
@@ -106,30 +167,52 @@ public:
         gainSmoothed_.setTargetValue(A);
     }
 
+    // Above its Nyquist frequency the filter leaves the signal alone: either nothing is there,
+    // or it runs at a reduced rate in a MultirateSplit, which passes that range through.
     float getMagnitudeAtFrequency(double freq) const {
-        if (sampleRate_ <= 0.0 || isBypassed_) {
+        if (sampleRate_ <= 0.0 || isBypassed_ || freq > 0.5 * sampleRate_) {
             return 1.0f;
         }
 
-        const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate_;
-        const double cos1  = std::cos(omega);
-        const double cos2  = std::cos(2.0 * omega);
+        return getMagnitude(getCoefficients<double>(), juce::MathConstants<double>::twoPi * freq / sampleRate_);
+    }
 
-        const auto b0 = static_cast<double>(b0_);
-        const auto b1 = static_cast<double>(b1_);
-        const auto b2 = static_cast<double>(b2_);
-        const auto a1 = static_cast<double>(a1_);
-        const auto a2 = static_cast<double>(a2_);
+    float getMagnitudeDbAt(double frequencyHz) const noexcept {
+        return juce::Decibels::gainToDecibels(getMagnitudeAtFrequency(frequencyHz));
+    }
+
+    using Coefficients = BiquadCoefficients<float>;
 
-        const auto numerator =
-            b0*b0 + b1*b1 + b2*b2
-            + 2.0 * (b0*b1 + b1*b2) * cos1
-            + 2.0 *  b0*b2 * cos2;
+    /** The current coefficients, rounded to T. */
+    template <typename T = float>
+    BiquadCoefficients<T> getCoefficients() const noexcept {
+        return BiquadCoefficients<double>{b0_, b1_, b2_, a1_, a2_}.convertTo<T>();
+    }
 
-        const double denominator =
-            1.0 + a1*a1 + a2*a2
-            + 2.0 * (a1 + a1*a2) * cos1
-            + 2.0 * a2 * cos2;
+    /** Magnitude of a biquad with coefficients c at omega radians per sample. The squared
+        magnitude is taken in the form (B0 phi0 + B1 phi1 + B2 phi2) / (A0 phi0 + A1 phi1 + A2 phi2)
+        of MatchedDesign.h: near DC, the expansion in cos(omega) cancels to nothing, while this
+        keeps the precision the coefficients have. */
+    template <typename T>
+    static float getMagnitude(const BiquadCoefficients<T>& c, double omega) noexcept {
+        const auto b0 = static_cast<double>(c.b0);
+        const auto b1 = static_cast<double>(c.b1);
+        const auto b2 = static_cast<double>(c.b2);
+        const auto a1 = static_cast<double>(c.a1);
+        const auto a2 = static_cast<double>(c.a2);
+
+        const auto sinHalf = std::sin(0.5 * omega);
+        const auto phi1 = sinHalf * sinHalf;
+        const auto phi0 = 1.0 - phi1;
+        const auto phi2 = 4.0 * phi0 * phi1;
+
+        const auto numerator = (b0 + b1 + b2) * (b0 + b1 + b2) * phi0
+                               + (b0 - b1 + b2) * (b0 - b1 + b2) * phi1
+                               - 4.0 * b0 * b2 * phi2;
+
+        const auto denominator = (1.0 + a1 + a2) * (1.0 + a1 + a2) * phi0
+                                 + (1.0 - a1 + a2) * (1.0 - a1 + a2) * phi1
+                                 - 4.0 * a2 * phi2;
 
         if (denominator <= 0.0 || numerator <= 0.0) {
             return 1.0f; 
@@ -139,47 +222,308 @@ public:
         return static_cast<float>(mag);
     }
 
-    float getMagnitudeDbAt(double frequencyHz) const noexcept {
-        return juce::Decibels::gainToDecibels(getMagnitudeAtFrequency(frequencyHz));
+    /** Moves the coefficients to target over numSamples samples, one step per advanceSample(),
+        or immediately when numSamples is 1 or less. Lets a filter designed elsewhere follow
+        another filter's control-rate ramps. */
+    void rampCoefficientsTo(const BiquadCoefficients<double>& target, int numSamples) noexcept {
+        if (numSamples <= 1) {
+            b0_ = target.b0;
+            b1_ = target.b1;
+            b2_ = target.b2;
+            a1_ = target.a1;
+            a2_ = target.a2;
+            rampSamplesRemaining_ = 0;
+            coefficientsChanged_ = true;
+            return;
+        }
+
+        const auto steps = static_cast<double>(numSamples);
+        rampTarget_ = target;
+        rampStep_ = {(target.b0 - b0_) / steps,
+                     (target.b1 - b1_) / steps,
+                     (target.b2 - b2_) / steps,
+                     (target.a1 - a1_) / steps,
+                     (target.a2 - a2_) / steps};
+        rampSamplesRemaining_ = numSamples;
+    }
+
+    /** Returns true once after every coefficient update, so an engine that mirrors the
+        coefficients elsewhere only copies them when they actually moved. */
+    bool consumeCoefficientsChanged() noexcept { return std::exchange(coefficientsChanged_, false); }
+
+    /** Advances the parameter smoothing and the bypass fade by one sample and returns the wet
+        mix for that sample. Lets an external engine drive the filter without processBlock. */
+    float advanceSample() noexcept {
+        return advanceSampleAs<BiquadFilter>();
+    }
+
+    /** True when processing would leave the signal untouched, so the filter can be skipped:
+        either the bypass fade has finished, or the coefficients are an exact identity (a peak or
+        shelf at 0 dB) and nothing is still gliding. */
+    bool isIdle() const noexcept {
+        if (bypassMix_.isSmoothing()) {
+            return false;
+        }
+
+        if (bypassMix_.getCurrentValue() <= EPSILON) {
+            return true;
+        }
+
+        return !coeffsDirty_ && rampSamplesRemaining_ == 0 && !isSmoothingParameters() && hasIdentityCoefficients();
+    }
+
+    /** Does what numSamples calls of advanceSample() would while the filter is steady, at once. */
+    float advanceSteady(int numSamples) noexcept {
+        jassert(isSteady());
+        samplesUntilControlUpdate_ = juce::jmax(0, samplesUntilControlUpdate_ - numSamples);
+        return bypassMix_.getCurrentValue();
+    }
+
+    /** True when neither the parameters nor the bypass fade are moving, so the coefficients and
+        the wet mix stay where they are until a parameter is set again. */
+    bool isSteady() const noexcept {
+        return !bypassMix_.isSmoothing() && !coeffsDirty_ && rampSamplesRemaining_ == 0 && !isSmoothingParameters();
+    }
+
+    /** Prepares a filter that was skipped while idle to run again. The state is cleared, and a
+        band coming back from bypass starts from its current parameter targets instead of
+        finishing glides that were frozen while it was skipped. */
+    void resumeFromIdle() noexcept {
+        if (bypassMix_.getCurrentValue() <= EPSILON) {
+            qSmoothed_.setCurrentAndTargetValue(qSmoothed_.getTargetValue());
+            gainSmoothed_.setCurrentAndTargetValue(gainSmoothed_.getTargetValue());
+            freqSmoothed_.setCurrentAndTargetValue(freqSmoothed_.getTargetValue());
+            coeffsDirty_ = true;
+        }
+
+        reset();
+    }
+
+    /** Finishes the parameter glides, any coefficient ramp and the bypass fade at once, and
+        designs for the targets. Keeps the response current for a filter that is not being
+        processed, e.g. while ParametricEq runs its state-variable engine. */
+    void settleParameters() {
+        bypassMix_.setCurrentAndTargetValue(bypassMix_.getTargetValue());
+
+        if (!coeffsDirty_ && rampSamplesRemaining_ == 0 && !isSmoothingParameters()) {
+            return;
+        }
+
+        qSmoothed_.setCurrentAndTargetValue(qSmoothed_.getTargetValue());
+        gainSmoothed_.setCurrentAndTargetValue(gainSmoothed_.getTargetValue());
+        freqSmoothed_.setCurrentAndTargetValue(freqSmoothed_.getTargetValue());
+        coeffsDirty_ = true;
+        updateSmoothedParameters();
     }
 
-protected:
     static constexpr float EPSILON = 1e-3f;
 
+private:
+    // Runs in T whatever the buffer holds; the states are only rounded to T while they are used.
+    template <typename Self, typename T, typename SampleType>
+    void processBlockScalar(juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept {
+        const auto numSamples = buffer.getNumSamples();
+        auto* const* channelData = buffer.getArrayOfWritePointers();
+
+        for (int n = 0; n < numSamples; ++n) {
+            updateSmoothedParameters<Self>();
+            const auto mix = static_cast<T>(bypassMix_.getNextValue());
+            if (mix <= static_cast<T>(EPSILON)) {
+                continue;
+            }
+
+            const auto c = getCoefficients<T>();
+
+            for (int ch = 0; ch < numChannels; ++ch) {
+                const auto x = static_cast<T>(channelData[ch][n]);
+
+                auto& z1 = z1_[static_cast<size_t>(ch)];
+                auto& z2 = z2_[static_cast<size_t>(ch)];
+
+                const auto y = c.b0 * x + static_cast<T>(z1);
+                z1 = c.b1 * x - c.a1 * y + static_cast<T>(z2);
+                z2 = c.b2 * x - c.a2 * y;
+
+                channelData[ch][n] = static_cast<SampleType>(x + mix * (y - x));
+            }
+        }
+    }
+
+#if JUCE_USE_SIMD
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int MAX_SIMD_CHANNELS = 8;
+    static constexpr size_t SIMD_LANES = SIMDFloat::size();
+    static constexpr size_t MAX_SIMD_GROUPS = (MAX_SIMD_CHANNELS + SIMD_LANES - 1) / SIMD_LANES;
+
+    // Channels are filtered in lockstep: lane k of group g holds channel g * SIMD_LANES + k,
+    // so the coefficients are broadcast once per sample and the states never leave registers
+    // for the duration of the block. Unused lanes run on zeros and stay silent.
+    template <typename Self>
+    void processBlockSIMD(juce::AudioBuffer<float>& buffer, int channelCount) noexcept {
+        const auto numChannels = static_cast<size_t>(channelCount);
+        const auto numSamples = buffer.getNumSamples();
+        const auto numGroups = (numChannels + SIMD_LANES - 1) / SIMD_LANES;
+        auto* const* channelData = buffer.getArrayOfWritePointers();
+
+        alignas(SIMDFloat::SIMDRegisterSize) std::array<float, MAX_SIMD_GROUPS * SIMD_LANES> lanes{};
+        std::array<SIMDFloat, MAX_SIMD_GROUPS> z1;
+        std::array<SIMDFloat, MAX_SIMD_GROUPS> z2;
+
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            lanes[ch] = static_cast<float>(z1_[ch]);
+        }
+        for (size_t g = 0; g < numGroups; ++g) {
+            z1[g] = SIMDFloat::fromRawArray(lanes.data() + g * SIMD_LANES);
+        }
+
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            lanes[ch] = static_cast<float>(z2_[ch]);
+        }
+        for (size_t g = 0; g < numGroups; ++g) {
+            z2[g] = SIMDFloat::fromRawArray(lanes.data() + g * SIMD_LANES);
+        }
+
+        std::fill(lanes.begin(), lanes.end(), 0.0f);
+
+        for (int n = 0; n < numSamples; ++n) {
+            updateSmoothedParameters<Self>();
+            float mix = bypassMix_.getNextValue();
+            if (mix <= EPSILON) {
+                continue;
+            }
+
+            const auto c = getCoefficients();
+            const auto b0 = SIMDFloat::expand(c.b0);
+            const auto b1 = SIMDFloat::expand(c.b1);
+            const auto b2 = SIMDFloat::expand(c.b2);
+            const auto a1 = SIMDFloat::expand(c.a1);
+            const auto a2 = SIMDFloat::expand(c.a2);
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                lanes[ch] = channelData[ch][n];
+            }
+
+            for (size_t g = 0; g < numGroups; ++g) {
+                auto* groupLanes = lanes.data() + g * SIMD_LANES;
+                const auto x = SIMDFloat::fromRawArray(groupLanes);
+
+                const auto y = b0 * x + z1[g];
+                z1[g] = b1 * x - a1 * y + z2[g];
+                z2[g] = b2 * x - a2 * y;
+
+                (x + (y - x) * mix).copyToRawArray(groupLanes);
+            }
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                channelData[ch][n] = lanes[ch];
+            }
+        }
+
+        for (size_t g = 0; g < numGroups; ++g) {
+            z1[g].copyToRawArray(lanes.data() + g * SIMD_LANES);
+        }
+        std::copy_n(lanes.begin(), numChannels, z1_.begin());
+
+        for (size_t g = 0; g < numGroups; ++g) {
+            z2[g].copyToRawArray(lanes.data() + g * SIMD_LANES);
+        }
+        std::copy_n(lanes.begin(), numChannels, z2_.begin());
+    }
+#endif
+
+protected:
     double freqRaw_{1000.0};
     double QRaw_{1.0};
     float gainDbRaw_{0.0f};
 
-    void setCoefficients(float b0, float b1, float b2, float a0, float a1, float a2) {
-        b0_ = b0;
-        b1_ = b1;
-        b2_ = b2;
-        a0_ = a0;
-        a1_ = a1;
-        a2_ = a2;
+    // Only the channels the filter was prepared for are filtered; preparing here would allocate
+    // on the audio thread.
+    template <typename Self, typename SampleType>
+    void processBlockAs(juce::AudioBuffer<SampleType>& buffer) noexcept {
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), numChannels_);
+
+        if (isIdle()) {
+            wasIdle_ = true;
+            return;
+        }
+
+        if (wasIdle_) {
+            resumeFromIdle();
+            wasIdle_ = false;
+        }
+
+        if (doublePrecision_) {
+            processBlockScalar<Self, double>(buffer, numChannels);
+            return;
+        }
+
+#if JUCE_USE_SIMD
+        if constexpr (std::is_same_v<SampleType, float>) {
+            if (numChannels > 1 && numChannels <= MAX_SIMD_CHANNELS) {
+                processBlockSIMD<Self>(buffer, numChannels);
+                return;
+            }
+        }
+#endif
+        processBlockScalar<Self, float>(buffer, numChannels);
     }
 
-    float shelfSlopeS_from_Q(float Q, float A) {
-        const float invQ2 = 1.0f / (Q * Q);
-        const float ApInvA = A + 1.0f / A;
 
-        const float invS = 1.0f + (invQ2 - 2.0f) / ApInvA;
+    template <typename Self>
+    float advanceSampleAs() noexcept {
+        updateSmoothedParameters<Self>();
+        return bypassMix_.getNextValue();
+    }
 
-        return 1.0f / juce::jmax(invS, 1e-6f);
+    template <typename T>
+    void setCoefficients(const BiquadCoefficients<T>& c) {
+        b0_ = static_cast<double>(c.b0);
+        b1_ = static_cast<double>(c.b1);
+        b2_ = static_cast<double>(c.b2);
+        a1_ = static_cast<double>(c.a1);
+        a2_ = static_cast<double>(c.a2);
+        coefficientsChanged_ = true;
+    }
+
+    /** Sets the result of design(Q, amplitude, frequency), a callable taking the three in float
+        or in double, run in the filter's precision. */
+    template <typename Design>
+    void designInPrecision(Design&& design, float Q, float amplitude, float frequency) {
+        if (doublePrecision_) {
+            setCoefficients(design(static_cast<double>(Q), static_cast<double>(amplitude), static_cast<double>(frequency)));
+        } else {
+            setCoefficients(design(Q, amplitude, frequency));
+        }
+    }
+
+    template <typename T>
+    static T shelfSlopeS_from_Q(T Q, T A) {
+        const T invQ2 = T(1) / (Q * Q);
+        const T ApInvA = A + T(1) / A;
+
+        const T invS = T(1) + (invQ2 - T(2)) / ApInvA;
+
+        return T(1) / juce::jmax(invS, T(1e-6));
+    }
+
+    /** Angular frequency of frequency at the current rate, in radians per sample. */
+    template <typename T>
+    T getOmega(T frequency) const noexcept {
+        return T(2) * std::numbers::pi_v<T> * frequency / static_cast<T>(sampleRate_);
     }
 
     double sampleRate_{44100.0};
     int numChannels_{0};
 
-    float b0_{1.0f};
-    float b1_{0.0f};
-    float b2_{0.0f};
-    float a0_{0.0f};
-    float a1_{0.0f};
-    float a2_{0.0f};
+    double b0_{1.0};
+    double b1_{0.0};
+    double b2_{0.0};
+    double a1_{0.0};
+    double a2_{0.0};
 
-    std::vector<float> z1_;
-    std::vector<float> z2_;
+    std::vector<double> z1_;
+    std::vector<double> z2_;
 
     juce::LinearSmoothedValue<float> bypassMix_{1.0f};
     bool isBypassed_{false};
@@ -192,19 +536,69 @@ protected:
     float lastA_{1.0f};
     float lastFreq_{1000.0f};
 
+    DesignMode designMode_{DesignMode::bilinear};
+    bool doublePrecision_{false};
     bool coeffsDirty_{true};
+    bool coefficientsChanged_{true};
+    bool wasIdle_{false};
 
     virtual void calculateAndSetCoefficients(float Q, float amplitude, float frequency) = 0;
 
+    /** Called after every design made while updating the parameters, with the number of
+        samples the coefficients are ramped over to reach it (0 when they were set directly). */
+    virtual void onCoefficientsDesigned(int rampSamples) { juce::ignoreUnused(rampSamples); }
+
+    /** Designs through a direct call to Self's calculateAndSetCoefficients(), or a virtual one
+        when Self is BiquadFilter. Self befriends BiquadFilter for the direct call. */
+    template <typename Self>
+    void designAs(float Q, float amplitude, float frequency) {
+        if constexpr (std::is_same_v<Self, BiquadFilter>) {
+            calculateAndSetCoefficients(Q, amplitude, frequency);
+        } else {
+            static_cast<Self*>(this)->Self::calculateAndSetCoefficients(Q, amplitude, frequency);
+        }
+    }
+
+    template <typename Self>
+    void notifyDesignedAs(int rampSamples) {
+        if constexpr (std::is_same_v<Self, BiquadFilter>) {
+            onCoefficientsDesigned(rampSamples);
+        } else {
+            static_cast<Self*>(this)->Self::onCoefficientsDesigned(rampSamples);
+        }
+    }
+
+    template <typename Self = BiquadFilter>
     void updateSmoothedParameters() {
         if (coeffsDirty_) {
-            calculateAndSetCoefficients(qSmoothed_.getCurrentValue(),
+            designAs<Self>(qSmoothed_.getCurrentValue(),
                                         gainSmoothed_.getCurrentValue(),
                                         freqSmoothed_.getCurrentValue());
             lastQ_ = qSmoothed_.getCurrentValue();
             lastA_ = gainSmoothed_.getCurrentValue();
             lastFreq_ = freqSmoothed_.getCurrentValue();
             coeffsDirty_ = false;
+            rampSamplesRemaining_ = 0;
+            samplesUntilControlUpdate_ = 0;
+            notifyDesignedAs<Self>(0);
+            return;
+        }
+
+        if (rampSamplesRemaining_ > 0) {
+            advanceCoefficientRamp();
+        }
+
+        if (samplesUntilControlUpdate_ > 0) {
+            --samplesUntilControlUpdate_;
+            return;
+        }
+
+        if (!isSmoothingParameters()) {
+            return;
+        }
+
+        if (controlInterval_ > 1) {
+            startCoefficientRamp<Self>();
             return;
         }
 
@@ -216,11 +610,100 @@ protected:
         const auto aDiff = std::abs(aNow - lastA_);
         const auto freqDiff = std::abs(freqNow - lastFreq_);
 
-        if (qDiff > EPSILON || aDiff > EPSILON || freqDiff > EPSILON) {
-            calculateAndSetCoefficients(qNow, aNow, freqNow);
+        // Once the ramps land, the exact target is designed even if the last step was tiny.
+        const auto settled = !isSmoothingParameters() && (qDiff > 0.0f || aDiff > 0.0f || freqDiff > 0.0f);
+
+        if (settled || qDiff > EPSILON || aDiff > EPSILON || freqDiff > EPSILON) {
+            designAs<Self>(qNow, aNow, freqNow);
             lastQ_ = qNow;
             lastA_ = aNow;
             lastFreq_ = freqNow;
+            notifyDesignedAs<Self>(0);
+        }
+    }
+
+    // Glide times are in seconds, so the smoothers are re-timed whenever the rate changes. Their
+    // values jump to the targets.
+    void resetSmoothers() noexcept {
+        qSmoothed_.reset(sampleRate_, 0.02);
+        gainSmoothed_.reset(sampleRate_, 0.01);
+        freqSmoothed_.reset(sampleRate_, 0.01);
+    }
+
+    bool hasIdentityCoefficients() const noexcept {
+        return juce::exactlyEqual(b0_, 1.0) && juce::exactlyEqual(b1_, a1_) && juce::exactlyEqual(b2_, a2_);
+    }
+
+    bool isSmoothingParameters() const noexcept {
+        return qSmoothed_.isSmoothing() || gainSmoothed_.isSmoothing() || freqSmoothed_.isSmoothing();
+    }
+
+private:
+    // Control-rate update: the smoothers jump a whole interval ahead, the filter is designed once
+    // for the values at the end of it, and the coefficients are ramped linearly towards that
+    // design one sample at a time.
+    template <typename Self>
+    void startCoefficientRamp() noexcept {
+        const auto qNext = qSmoothed_.skip(controlInterval_);
+        const auto aNext = gainSmoothed_.skip(controlInterval_);
+        const auto freqNext = freqSmoothed_.skip(controlInterval_);
+
+        const auto from = getCoefficients<double>();
+        designAs<Self>(qNext, aNext, freqNext);
+        const auto target = getCoefficients<double>();
+
+        b0_ = from.b0;
+        b1_ = from.b1;
+        b2_ = from.b2;
+        a1_ = from.a1;
+        a2_ = from.a2;
+        rampCoefficientsTo(target, controlInterval_);
+
+        lastQ_ = qNext;
+        lastA_ = aNext;
+        lastFreq_ = freqNext;
+
+        samplesUntilControlUpdate_ = controlInterval_ - 1;
+        advanceCoefficientRamp();
+        notifyDesignedAs<Self>(controlInterval_);
+    }
+
+    void advanceCoefficientRamp() noexcept {
+        if (--rampSamplesRemaining_ == 0) {
+            b0_ = rampTarget_.b0;
+            b1_ = rampTarget_.b1;
+            b2_ = rampTarget_.b2;
+            a1_ = rampTarget_.a1;
+            a2_ = rampTarget_.a2;
+        } else {
+            b0_ += rampStep_.b0;
+            b1_ += rampStep_.b1;
+            b2_ += rampStep_.b2;
+            a1_ += rampStep_.a1;
+            a2_ += rampStep_.a2;
         }
+
+        coefficientsChanged_ = true;
     }
+
+    int controlInterval_{1};
+    int samplesUntilControlUpdate_{0};
+    int rampSamplesRemaining_{0};
+    BiquadCoefficients<double> rampTarget_{};
+    BiquadCoefficients<double> rampStep_{};
+};
+
+/** Base of the concrete filter types, with Derived the type itself. processBlock() and
+    advanceSample() on a Derived design through direct calls; through a BiquadFilter pointer or
+    reference, as the GUI and the fused cascade hold the bands, they stay virtual. Derived
+    befriends BiquadFilter, which makes the call. */
+template <typename Derived>
+class BiquadFilterDesign : public BiquadFilter {
+public:
+    template <typename SampleType>
+    void processBlock(juce::AudioBuffer<SampleType>& buffer) {
+        processBlockAs<Derived>(buffer);
+    }
+
+    float advanceSample() noexcept { return advanceSampleAs<Derived>(); }
 };
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <numbers>
+
+// Analog elliptic (Cauer) low-pass prototype of even order, normalised to a passband edge of
+// 1 rad/s and split into second-order sections
+//
+//     H_k(s) = g_k * (s^2 + zeroFrequency^2) / (s^2 + (poleFrequency / poleQ) * s + poleFrequency^2)
+//
+// with g_k chosen so every section has unity gain at DC; the passband ripple offset is carried
+// separately in `gain`. The design follows Orfanidis, "Lecture Notes on Elliptic Filter Design",
+// with the Jacobi elliptic functions evaluated through descending Landen transformations. It
+// iterates, so prototypes are built once up front and only frequency-scaled afterwards.
+struct EllipticPrototype {
+    static constexpr int MAX_SECTIONS = 4;
+
+    struct Section {
+        double zeroFrequency;
+        double poleFrequency;
+        double poleQ;
+    };
+
+    std::array<Section, MAX_SECTIONS> sections{};
+    int numSections{0};
+    double gain{1.0};
+    double stopbandEdge{1.0};
+
+    static EllipticPrototype design(int numSections, double passbandRippleDb, double stopbandAttenuationDb) {
+        EllipticPrototype prototype;
+        prototype.numSections = std::clamp(numSections, 1, MAX_SECTIONS);
+
+        const auto order = 2 * prototype.numSections;
+        const auto passbandEpsilon = std::sqrt(std::pow(10.0, passbandRippleDb / 10.0) - 1.0);
+        const auto stopbandEpsilon = std::sqrt(std::pow(10.0, stopbandAttenuationDb / 10.0) - 1.0);
+        const auto k1 = passbandEpsilon / stopbandEpsilon;
+        const auto k = solveDegreeEquation(order, k1);
+        prototype.stopbandEdge = 1.0 / k;
+
+        const auto v0 = -asne(Complex{0.0, 1.0 / passbandEpsilon}, k1) * Complex{0.0, 1.0 / static_cast<double>(order)};
+
+        for (int i = 0; i < prototype.numSections; ++i) {
+            const auto u = static_cast<double>(2 * i + 1) / static_cast<double>(order);
+            const auto zero = 1.0 / (k * cde(Complex{u, 0.0}, k).real());
+            const auto pole = Complex{0.0, 1.0} * cde(Complex{u, 0.0} - Complex{0.0, 1.0} * v0, k);
+
+            prototype.sections[static_cast<size_t>(i)] = {zero, std::abs(pole), std::abs(pole) / (-2.0 * pole.real())};
+        }
+
+        // Low-Q sections first keeps the intermediate signal levels down inside the cascade.
+        std::sort(prototype.sections.begin(), prototype.sections.begin() + prototype.numSections,
+                  [](const Section& a, const Section& b) { return a.poleQ < b.poleQ; });
+
+        // An even-order elliptic response starts at the bottom of the passband ripple.
+        prototype.gain = 1.0 / std::sqrt(1.0 + passbandEpsilon * passbandEpsilon);
+        return prototype;
+    }
+
+    /** Magnitude of the prototype at the normalised analog frequency omega. */
+    double getMagnitude(double omega) const noexcept {
+        auto magnitude = gain;
+        const auto s = Complex{0.0, omega};
+
+        for (int i = 0; i < numSections; ++i) {
+            const auto& section = sections[static_cast<size_t>(i)];
+            const auto wz2 = section.zeroFrequency * section.zeroFrequency;
+            const auto wp2 = section.poleFrequency * section.poleFrequency;
+            const auto numerator = s * s + wz2;
+            const auto denominator = s * s + (section.poleFrequency / section.poleQ) * s + wp2;
+            magnitude *= (wp2 / wz2) * std::abs(numerator / denominator);
+        }
+
+        return magnitude;
+    }
+
+private:
+    using Complex = std::complex<double>;
+
+    static constexpr int NUM_LANDEN_STEPS = 8;
+
+    static std::array<double, NUM_LANDEN_STEPS> landen(double k) noexcept {
+        std::array<double, NUM_LANDEN_STEPS> moduli{};
+
+        for (auto& modulus : moduli) {
+            const auto kp = std::sqrt(1.0 - k * k);
+            k = (k / (1.0 + kp)) * (k / (1.0 + kp));
+            modulus = k;
+        }
+
+        return moduli;
+    }
+
+    // cd(u K, k), with u in units of the quarter period K.
+    static Complex cde(Complex u, double k) noexcept {
+        const auto moduli = landen(k);
+        auto w = std::cos(u * (std::numbers::pi / 2.0));
+
+        for (auto it = moduli.rbegin(); it != moduli.rend(); ++it) {
+            w = (1.0 + *it) * w / (1.0 + *it * w * w);
+        }
+
+        return w;
+    }
+
+    static Complex sne(Complex u, double k) noexcept {
+        const auto moduli = landen(k);
+        auto w = std::sin(u * (std::numbers::pi / 2.0));
+
+        for (auto it = moduli.rbegin(); it != moduli.rend(); ++it) {
+            w = (1.0 + *it) * w / (1.0 + *it * w * w);
+        }
+
+        return w;
+    }
+
+    // Inverse of sne: returns u such that sn(u K, k) = w.
+    static Complex asne(Complex w, double k) noexcept {
+        const auto moduli = landen(k);
+        auto previous = k;
+
+        for (auto modulus : moduli) {
+            w = w / (1.0 + std::sqrt(1.0 - w * w * previous * previous)) * (2.0 / (1.0 + modulus));
+            previous = modulus;
+        }
+
+        return std::asin(w) * (2.0 / std::numbers::pi);
+    }
+
+    // Selectivity k of the order-N filter whose discrimination is k1.
+    static double solveDegreeEquation(int order, double k1) noexcept {
+        const auto k1p = std::sqrt(1.0 - k1 * k1);
+        auto kp = std::pow(k1p, static_cast<double>(order));
+
+        for (int i = 1; i <= order / 2; ++i) {
+            const auto u = static_cast<double>(2 * i - 1) / static_cast<double>(order);
+            kp *= std::pow(sne(Complex{u, 0.0}, k1p).real(), 4.0);
+        }
+
+        return std::sqrt(1.0 - kp * kp);
+    }
+};
@@ -2,39 +2,44 @@
 #include <numbers>
 
 #include "FilterParameters.h"
-class LowShelfFilter : public BiquadFilter {
+#include "MatchedDesign.h"
+class LowShelfFilter : public BiquadFilterDesign<LowShelfFilter> {
 public:
     LowShelfFilter() = default;
     ~LowShelfFilter() override = default;
 private:
+    friend class BiquadFilter;
+
 
     void calculateAndSetCoefficients(float Q, float A, float frequency) override {
-        const auto sampleRate = static_cast<float>(sampleRate_);
-        const auto w0 = 2.0f * std::numbers::pi_v<float> * frequency / sampleRate;
+        designInPrecision([this](auto q, auto a, auto f) { return design(q, a, f); }, Q, A, frequency);
+    }
 
-        const auto cos_w = static_cast<float>(std::cos(w0));
-        const auto sin_w = static_cast<float>(std::sin(w0));
+    template <typename T>
+    BiquadCoefficients<T> design(T Q, T A, T frequency) const noexcept {
+        const auto w0 = getOmega(frequency);
 
-        auto S = shelfSlopeS_from_Q(Q, A);
+        if (designMode_ == DesignMode::matchedMagnitude) {
+            return MatchedDesign::designLowShelf(static_cast<double>(Q), static_cast<double>(A), static_cast<double>(w0))
+                .template convertTo<T>();
+        }
 
-        const float alpha = (sin_w * 0.5f) 
-            * std::sqrt((A + 1.0f / A) * (1.0f / S - 1.0f) + 2.0f);
+        const auto [sin_w, cos_w] = fast_math::sinCosFor(w0);
+
+        auto S = shelfSlopeS_from_Q(Q, A);
 
-        const auto twoSqrtAlpha = 2.f * std::sqrt(A) * alpha;
+        const T alpha = (sin_w * T(0.5)) 
+            * std::sqrt((A + T(1) / A) * (T(1) / S - T(1)) + T(2));
 
-        float b0 = A * ((A + 1.f) - (A - 1.f) * cos_w + twoSqrtAlpha);
-        float b1 = 2.f * A * ((A - 1.f) - (A + 1.f) * cos_w);
-        float b2 = A * ((A + 1.f) - (A - 1.f) * cos_w - twoSqrtAlpha);
-        float a0 = (A + 1.f) + (A - 1.f) * cos_w + twoSqrtAlpha;
-        float a1 = -2.f * ((A - 1.f) + (A + 1.f) * cos_w);
-        float a2 = (A + 1.f) + (A - 1.f) * cos_w - twoSqrtAlpha;
+        const auto twoSqrtAlpha = T(2) * std::sqrt(A) * alpha;
 
-        b0 /= a0;
-        b1 /= a0;
-        b2 /= a0;
-        a1 /= a0;
-        a2 /= a0;
+        T b0 = A * ((A + T(1)) - (A - T(1)) * cos_w + twoSqrtAlpha);
+        T b1 = T(2) * A * ((A - T(1)) - (A + T(1)) * cos_w);
+        T b2 = A * ((A + T(1)) - (A - T(1)) * cos_w - twoSqrtAlpha);
+        T a0 = (A + T(1)) + (A - T(1)) * cos_w + twoSqrtAlpha;
+        T a1 = T(-2) * ((A - T(1)) + (A + T(1)) * cos_w);
+        T a2 = (A + T(1)) + (A - T(1)) * cos_w - twoSqrtAlpha;
 
-        setCoefficients(b0, b1, b2, a0, a1, a2);
+        return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
     }
 };
\ No newline at end of file
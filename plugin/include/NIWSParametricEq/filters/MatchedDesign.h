@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "BiquadFilter.h"
+
+// Matched-magnitude biquad design after Vicanek, "Matched Second Order Digital Filters" (2016).
+// The poles are the analog poles mapped through z = exp(s T), and the numerator is solved so the
+// squared magnitude equals the analog prototype's at DC, at one frequency inside the band and at
+// Nyquist. There is no frequency warping, so a band close to Nyquist keeps its analog shape
+// instead of cramping the way the bilinear designs do.
+//
+// The squared magnitude of a biquad is A0 phi0 + A1 phi1 + A2 phi2 over the same form in the
+// denominator, with phi1 = sin^2(w / 2), phi0 = 1 - phi1 and phi2 = 4 phi0 phi1; matching at
+// the three frequencies is a linear solve for B0, B1 and B2, from which b0, b1 and b2 follow.
+// Everything is done in double, since (1 + a1 + a2)^2 keeps little float precision at low
+// cutoffs.
+struct MatchedDesign {
+    /** Analog section (n2 s^2 + n1 s + n0) / (s^2 + d1 s + d0), normalised to a cutoff of 1. */
+    struct AnalogPrototype {
+        double n2;
+        double n1;
+        double n0;
+        double d1;
+        double d0;
+
+        double getMagnitudeSquared(double omega) const noexcept {
+            const auto omega2 = omega * omega;
+            const auto numerator = (n0 - n2 * omega2) * (n0 - n2 * omega2) + n1 * n1 * omega2;
+            const auto denominator = (d0 - omega2) * (d0 - omega2) + d1 * d1 * omega2;
+            return numerator / denominator;
+        }
+    };
+
+    /** Designs the prototype at cutoff w0 (radians per sample), matching it at w0 as well. */
+    static BiquadCoefficients<double> design(const AnalogPrototype& prototype, double w0) noexcept {
+        w0 = std::clamp(w0, 1e-6, 0.98 * std::numbers::pi);
+
+        const auto poleFrequency = std::sqrt(prototype.d0) * w0;
+        const auto damping = prototype.d1 / (2.0 * std::sqrt(prototype.d0));
+        const auto decay = std::exp(-damping * poleFrequency);
+
+        const auto a1 = damping <= 1.0
+            ? -2.0 * decay * std::cos(poleFrequency * std::sqrt(1.0 - damping * damping))
+            : -2.0 * decay * std::cosh(poleFrequency * std::sqrt(damping * damping - 1.0));
+        const auto a2 = decay * decay;
+
+        const auto A0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+        const auto A1 = (1.0 - a1 + a2) * (1.0 - a1 + a2);
+        const auto A2 = -4.0 * a2;
+
+        const auto sinHalf = std::sin(0.5 * w0);
+        const auto phi1 = sinHalf * sinHalf;
+        const auto phi0 = 1.0 - phi1;
+        const auto phi2 = 4.0 * phi0 * phi1;
+
+        const auto B0 = A0 * prototype.getMagnitudeSquared(0.0);
+        const auto B1 = A1 * prototype.getMagnitudeSquared(std::numbers::pi / w0);
+        const auto B2 = ((A0 * phi0 + A1 * phi1 + A2 * phi2) * prototype.getMagnitudeSquared(1.0)
+                         - B0 * phi0 - B1 * phi1) / phi2;
+
+        const auto sqrtB0 = std::sqrt(B0);
+        const auto sqrtB1 = std::sqrt(B1);
+        const auto W = 0.5 * (sqrtB0 + sqrtB1);
+        const auto b0 = 0.5 * (W + std::sqrt(std::max(W * W + B2, 0.0)));
+        const auto b1 = 0.5 * (sqrtB0 - sqrtB1);
+        const auto b2 = -B2 / (4.0 * b0);
+
+        return {b0, b1, b2, a1, a2};
+    }
+
+    // The analog prototypes of the RBJ peak and shelves, with A = 10^(gain / 40).
+
+    static AnalogPrototype peakPrototype(double Q, double A) noexcept { return {1.0, A / Q, 1.0, 1.0 / (A * Q), 1.0}; }
+
+    static AnalogPrototype lowShelfPrototype(double Q, double A) noexcept {
+        const auto sqrtA = std::sqrt(A);
+        return {1.0, sqrtA / Q, A, 1.0 / (sqrtA * Q), 1.0 / A};
+    }
+
+    static AnalogPrototype highShelfPrototype(double Q, double A) noexcept {
+        const auto sqrtA = std::sqrt(A);
+        return {A * A, A * sqrtA / Q, A, sqrtA / Q, A};
+    }
+
+    static BiquadCoefficients<double> designPeak(double Q, double A, double w0) noexcept {
+        return designDirectOrInverse(peakPrototype, Q, A, w0);
+    }
+
+    static BiquadCoefficients<double> designLowShelf(double Q, double A, double w0) noexcept {
+        return designDirectOrInverse(lowShelfPrototype, Q, A, w0);
+    }
+
+    static BiquadCoefficients<double> designHighShelf(double Q, double A, double w0) noexcept {
+        return designDirectOrInverse(highShelfPrototype, Q, A, w0);
+    }
+
+private:
+    // The prototypes here are symmetric: the cut is the exact inverse of the boost by the same
+    // amount. Mapping the poles carries the analog shape over better than the three-point fit of
+    // the zeros, and it fares worst for poles high up near Nyquist. So whichever of the two has
+    // the lower-lying poles, or at equal height the sharper ones, is designed directly, and the
+    // other is obtained by inverting it. The matched zeros lie inside the unit circle, so the
+    // inverse is stable.
+    static BiquadCoefficients<double> designDirectOrInverse(AnalogPrototype (*prototype)(double, double), double Q,
+                                                          double A, double w0) noexcept {
+        const auto direct = prototype(Q, A);
+        const auto inverse = prototype(Q, 1.0 / A);
+
+        // The fitted zeros only land on the poles up to rounding, but the cascade culls a band at
+        // unity gain on an exact identity.
+        if (juce::exactlyEqual(A, 1.0)) {
+            const auto c = design(direct, w0);
+            return {1.0, c.a1, c.a2, c.a1, c.a2};
+        }
+
+        if (direct.d0 < inverse.d0 || (juce::exactlyEqual(direct.d0, inverse.d0) && direct.d1 <= inverse.d1)) {
+            return design(direct, w0);
+        }
+
+        const auto c = design(inverse, w0);
+        return {1.0 / c.b0, c.a1 / c.b0, c.a2 / c.b0, c.b1 / c.b0, c.b2 / c.b0};
+    }
+};
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+
+// Runs low bands at a fraction of the sample rate. The input is decimated by two per stage, the
+// low-band processor runs on the result, and only what it changed, its output minus its input, is
+// interpolated back and added to the input delayed by the same amount:
+//
+//     y = delayed x + I(H(D(x)) - D(x))
+//
+// The split is exactly transparent wherever H leaves the signal alone, so H has to be close to
+// unity from PASSBAND_EDGE of the reduced rate up, as shelves and high-passes well below it are.
+//
+// Every stage is a linear-phase half-band FIR, used for decimation and again for interpolation,
+// so the low band lines up with the delayed input. The delays are rounded up to make the latency
+// a whole number of reduced-rate samples, and a multiple of the latency multiple asked for.
+//
+// The stages and the low band run in float. The delayed input is kept in double, so a double
+// buffer only passes through float in the low band's changes.
+class MultirateSplit {
+public:
+    static constexpr int MAX_STAGES = 3;
+    static constexpr int CHUNK_SIZE = 256;
+
+    // Fraction of the reduced rate below which the low band comes back unaltered.
+    static constexpr double PASSBAND_EDGE = 0.4;
+    static constexpr double STOPBAND_DB = 80.0;
+
+    MultirateSplit() = default;
+    ~MultirateSplit() = default;
+
+    /** Designs the stages and allocates; nothing is allocated when nothing changed. The latency
+        comes out a multiple of latencyMultiple, a power of two. */
+    void prepare(int numStages, int numChannels, int latencyMultiple = 1) {
+        jassert(numStages >= 0 && numStages <= MAX_STAGES);
+        jassert(juce::isPowerOfTwo(latencyMultiple));
+
+        if (numStages != numStages_ || numChannels != numChannels_ || latencyMultiple != latencyMultiple_) {
+            numStages_ = numStages;
+            numChannels_ = numChannels;
+            latencyMultiple_ = latencyMultiple;
+            allocate();
+        }
+
+        reset();
+    }
+
+    void reset() noexcept {
+        for (auto& stage : stages_) {
+            std::fill(stage.decimatorLines.begin(), stage.decimatorLines.end(), 0.0f);
+            std::fill(stage.interpolatorLines.begin(), stage.interpolatorLines.end(), 0.0f);
+            stage.phase = 0;
+        }
+
+        std::fill(delayLines_.begin(), delayLines_.end(), 0.0);
+    }
+
+    int getNumStages() const noexcept { return numStages_; }
+    int getFactor() const noexcept { return 1 << numStages_; }
+    int getLatencySamples() const noexcept { return latency_; }
+
+    /** Runs processLowBand on the decimated buffer, as a juce::AudioBuffer<float>&, and folds its
+        changes back in. The buffer, float or double, comes out getLatencySamples() late. */
+    template <typename SampleType, typename LowBandProcessor>
+    void process(juce::AudioBuffer<SampleType>& buffer, LowBandProcessor&& processLowBand) noexcept {
+        jassert(numStages_ > 0);
+        const auto numChannels = static_cast<size_t>(juce::jmin(buffer.getNumChannels(), numChannels_));
+
+        for (int start = 0; start < buffer.getNumSamples(); start += CHUNK_SIZE) {
+            const auto numSamples = juce::jmin(CHUNK_SIZE, buffer.getNumSamples() - start);
+            processChunk(buffer, start, numSamples, numChannels, processLowBand);
+        }
+    }
+
+private:
+    // A half-band filter has every other tap zero apart from the centre one, which is 0.5; the
+    // rest come in symmetric pairs at odd distances from the centre. Its lines keep the history
+    // it needs ahead of each chunk's samples.
+    struct Stage {
+        int halfLength{0};
+        std::vector<float> pairTaps;
+
+        size_t maxInput{0};
+        size_t maxOutput{0};
+        size_t decimatorLineSize{0};
+        size_t interpolatorLineSize{0};
+        std::vector<float> decimatorLines;
+        std::vector<float> interpolatorLines;
+        std::vector<float> outputs;
+
+        // Parity of the next input sample; outputs are taken at the even ones.
+        int phase{0};
+
+        float* getOutput(size_t channel) noexcept { return outputs.data() + channel * maxOutput; }
+    };
+
+    static double besselI0(double x) noexcept {
+        auto sum = 1.0;
+        auto term = 1.0;
+
+        for (int k = 1; term > 1e-12 * sum; ++k) {
+            const auto factor = x / (2.0 * static_cast<double>(k));
+            term *= factor * factor;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // Kaiser-windowed sinc. The transition band is centred on a quarter of the stage's input
+    // rate, as wide as the reduced rate's passband leaves room for at this stage: the last stage
+    // has to keep 0.4 to 0.6 of its output rate apart, the ones before it have more room.
+    void designStage(Stage& stage, int index) const {
+        const auto stagesBelow = numStages_ - index;
+        const auto transitionWidth = 0.5 - 2.0 * PASSBAND_EDGE / static_cast<double>(1 << stagesBelow);
+        const auto numTaps = (STOPBAND_DB - 8.0) / (2.285 * 2.0 * std::numbers::pi * transitionWidth) + 1.0;
+
+        // Stage s adds 2^(s + 1) * halfLength to the latency.
+        const auto multiple = juce::jmax(1 << juce::jmax(0, stagesBelow - 1), latencyMultiple_ >> (index + 1));
+        const auto halfLength = static_cast<int>(std::ceil((numTaps - 1.0) / 2.0));
+        stage.halfLength = (halfLength + multiple - 1) / multiple * multiple;
+
+        const auto beta = 0.1102 * (STOPBAND_DB - 8.7);
+        const auto length = static_cast<double>(stage.halfLength);
+        std::vector<double> taps;
+        auto sum = 0.0;
+
+        for (auto offset = 1; offset <= stage.halfLength; offset += 2) {
+            const auto x = 0.5 * std::numbers::pi * static_cast<double>(offset);
+            const auto position = static_cast<double>(offset) / length;
+            const auto window = besselI0(beta * std::sqrt(1.0 - position * position)) / besselI0(beta);
+            taps.push_back(0.5 * std::sin(x) / x * window);
+            sum += 2.0 * taps.back();
+        }
+
+        // Each polyphase branch passes DC at exactly half gain, so neither direction leaves a tone
+        // at the reduced rate behind.
+        stage.pairTaps.clear();
+        for (const auto tap : taps) {
+            stage.pairTaps.push_back(static_cast<float>(0.5 * tap / sum));
+        }
+    }
+
+    void allocate() {
+        stages_.resize(static_cast<size_t>(numStages_));
+        latency_ = 0;
+        auto maxInput = static_cast<size_t>(CHUNK_SIZE);
+
+        for (int s = 0; s < numStages_; ++s) {
+            auto& stage = stages_[static_cast<size_t>(s)];
+            designStage(stage, s);
+            latency_ += (2 << s) * stage.halfLength;
+
+            const auto halfLength = static_cast<size_t>(stage.halfLength);
+            stage.maxInput = maxInput;
+            stage.maxOutput = (maxInput + 1) / 2;
+            stage.decimatorLineSize = 2 * halfLength + stage.maxInput;
+            stage.interpolatorLineSize = halfLength + 1 + stage.maxOutput;
+            stage.decimatorLines.assign(stage.decimatorLineSize * static_cast<size_t>(numChannels_), 0.0f);
+            stage.interpolatorLines.assign(stage.interpolatorLineSize * static_cast<size_t>(numChannels_), 0.0f);
+            stage.outputs.assign(stage.maxOutput * static_cast<size_t>(numChannels_), 0.0f);
+
+            maxInput = stage.maxOutput;
+        }
+
+        lowDry_.assign(maxInput * static_cast<size_t>(numChannels_), 0.0f);
+        correction_.assign(static_cast<size_t>(CHUNK_SIZE), 0.0f);
+        delayLineSize_ = static_cast<size_t>(latency_ + CHUNK_SIZE);
+        delayLines_.assign(delayLineSize_ * static_cast<size_t>(numChannels_), 0.0);
+        lowBandChannels_.assign(static_cast<size_t>(numChannels_), nullptr);
+    }
+
+    // Filters and keeps every other sample of input, from the first one with even parity.
+    template <typename SampleType>
+    static int decimate(Stage& stage, size_t channel, const SampleType* input, int numSamples, float* output) noexcept {
+        const auto halfLength = stage.halfLength;
+        const auto history = static_cast<size_t>(2 * halfLength);
+        auto* line = stage.decimatorLines.data() + channel * stage.decimatorLineSize;
+        std::transform(input, input + numSamples, line + history, [](SampleType x) { return static_cast<float>(x); });
+
+        int numOutputs = 0;
+
+        for (int p = (stage.phase & 1); p < numSamples; p += 2) {
+            const auto* centre = line + p + halfLength;
+            auto y = 0.5f * *centre;
+
+            for (size_t m = 0; m < stage.pairTaps.size(); ++m) {
+                const auto offset = static_cast<std::ptrdiff_t>(2 * m + 1);
+                y += stage.pairTaps[m] * (centre[-offset] + centre[offset]);
+            }
+
+            output[numOutputs++] = y;
+        }
+
+        std::copy_n(line + numSamples, history, line);
+        return numOutputs;
+    }
+
+    // Zero-stuffs input onto the even samples of the stage's timeline and filters it with twice
+    // the decimation taps, writing numSamples samples from the given starting parity.
+    static void interpolate(Stage& stage, size_t channel, const float* input, int numInputs, int phase,
+                            int numSamples, float* output) noexcept {
+        const auto halfLength = stage.halfLength;
+        const auto history = static_cast<size_t>(halfLength + 1);
+        auto* line = stage.interpolatorLines.data() + channel * stage.interpolatorLineSize;
+        std::copy_n(input, numInputs, line + history);
+
+        // Position of the newest input that has arrived by the current sample.
+        auto newest = static_cast<std::ptrdiff_t>(history) - 1;
+
+        for (int p = 0; p < numSamples; ++p) {
+            const auto parity = (phase + p) & 1;
+            if (parity == 0) {
+                ++newest;
+            }
+
+            // The centre tap lands on an input when the sample lies halfLength behind one.
+            const auto behind = halfLength - parity;
+            if (behind % 2 == 0) {
+                output[p] = line[newest - behind / 2];
+                continue;
+            }
+
+            auto y = 0.0f;
+
+            for (size_t m = 0; m < stage.pairTaps.size(); ++m) {
+                const auto offset = static_cast<int>(2 * m + 1);
+                y += stage.pairTaps[m] * (line[newest - (behind + offset) / 2] + line[newest - (behind - offset) / 2]);
+            }
+
+            output[p] = 2.0f * y;
+        }
+
+        std::copy_n(line + numInputs, history, line);
+    }
+
+    template <typename SampleType, typename LowBandProcessor>
+    void processChunk(juce::AudioBuffer<SampleType>& buffer, int start, int numSamples, size_t numChannels,
+                      LowBandProcessor& processLowBand) noexcept {
+        std::array<int, MAX_STAGES + 1> counts{};
+        std::array<int, MAX_STAGES> phases{};
+        counts[0] = numSamples;
+
+        for (size_t s = 0; s < stages_.size(); ++s) {
+            auto& stage = stages_[s];
+            phases[s] = stage.phase;
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                counts[s + 1] = s == 0 ? decimate(stage, ch, buffer.getReadPointer(static_cast<int>(ch), start),
+                                                  counts[s], stage.getOutput(ch))
+                                       : decimate(stage, ch, stages_[s - 1].getOutput(ch), counts[s],
+                                                  stage.getOutput(ch));
+            }
+
+            stage.phase = (stage.phase + counts[s]) & 1;
+        }
+
+        auto& lowest = stages_.back();
+        const auto numLowSamples = counts[stages_.size()];
+
+        if (numLowSamples > 0) {
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                lowBandChannels_[ch] = lowest.getOutput(ch);
+                std::copy_n(lowest.getOutput(ch), numLowSamples, lowDry_.data() + ch * lowest.maxOutput);
+            }
+
+            juce::AudioBuffer<float> lowBand{lowBandChannels_.data(), static_cast<int>(numChannels), 0, numLowSamples};
+            processLowBand(lowBand);
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                juce::FloatVectorOperations::subtract(lowest.getOutput(ch), lowDry_.data() + ch * lowest.maxOutput,
+                                                      numLowSamples);
+            }
+        }
+
+        for (auto s = stages_.size(); s-- > 0;) {
+            auto& stage = stages_[s];
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                auto* output = s == 0 ? correction_.data() : stages_[s - 1].getOutput(ch);
+                interpolate(stage, ch, stage.getOutput(ch), counts[s + 1], phases[s], counts[s], output);
+
+                if (s == 0) {
+                    recombine(ch, buffer.getWritePointer(static_cast<int>(ch), start), numSamples);
+                }
+            }
+        }
+    }
+
+    template <typename SampleType>
+    void recombine(size_t channel, SampleType* samples, int numSamples) noexcept {
+        const auto history = static_cast<size_t>(latency_);
+        auto* line = delayLines_.data() + channel * delayLineSize_;
+        std::copy_n(samples, numSamples, line + history);
+
+        for (int n = 0; n < numSamples; ++n) {
+            samples[n] = static_cast<SampleType>(line[n] + static_cast<double>(correction_[static_cast<size_t>(n)]));
+        }
+
+        std::copy_n(line + numSamples, history, line);
+    }
+
+    int numStages_{0};
+    int numChannels_{0};
+    int latencyMultiple_{1};
+    int latency_{0};
+    std::vector<Stage> stages_;
+
+    std::vector<float> lowDry_;
+    std::vector<float> correction_;
+    std::vector<float*> lowBandChannels_;
+    size_t delayLineSize_{0};
+    std::vector<double> delayLines_;
+};
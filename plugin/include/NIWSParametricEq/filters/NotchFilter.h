@@ -3,32 +3,31 @@
 
 #include "FilterParameters.h"
 
-class NotchFilter : public BiquadFilter {
+class NotchFilter : public BiquadFilterDesign<NotchFilter> {
 public:
     NotchFilter() = default;
     ~NotchFilter() override = default;
 private:
+    friend class BiquadFilter;
+
     void calculateAndSetCoefficients(float Q, float amplitude, float frequency) override {
-        juce::ignoreUnused(amplitude);
-        const auto sampleRate = static_cast<float>(sampleRate_);    
-        const auto w0 = 2.0f * std::numbers::pi_v<float> * frequency / sampleRate;
-        const auto cos_w = static_cast<float>(std::cos(w0));
-        const auto alpha = std::sin(w0) / (2.0f * Q);
+        designInPrecision([this](auto q, auto, auto f) { return design(q, f); }, Q, amplitude, frequency);
+    }
 
-        float a0 = 1.0f + alpha;
+    template <typename T>
+    BiquadCoefficients<T> design(T Q, T frequency) const noexcept {
+        const auto w0 = getOmega(frequency);
+        const auto [sin_w, cos_w] = fast_math::sinCosFor(w0);
+        const auto alpha = sin_w / (T(2) * Q);
 
-        float b0 = 1.0f;
-        float b1 = -2.0f * cos_w;
-        float b2 = 1.0f;
-        float a1 = -2.0f * cos_w;
-        float a2 = 1.0f - alpha;
+        T a0 = T(1) + alpha;
 
-        b0 /= a0;
-        b1 /= a0;
-        b2 /= a0;
-        a1 /= a0;
-        a2 /= a0;
+        T b0 = T(1);
+        T b1 = T(-2) * cos_w;
+        T b2 = T(1);
+        T a1 = T(-2) * cos_w;
+        T a2 = T(1) - alpha;
 
-        setCoefficients(b0, b1, b2, a0, a1, a2);
+        return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
     }
 };
\ No newline at end of file
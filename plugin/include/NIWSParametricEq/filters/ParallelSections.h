@@ -0,0 +1,486 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <optional>
+#include <span>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+
+#include "BiquadCascade.h"
+#include "BiquadFilter.h"
+
+// Runs a cascade of biquad sections as a sum of parallel sections. The product of the sections is
+// expanded into partial fractions: every pole of the cascade belongs to one section, so each
+// section's poles give one branch with a first-order numerator, and the branches' outputs add up
+// to the cascade's together with a direct gain. Unlike the cascade, the branches do not wait for
+// each other, so SIMD lanes run several of them at once for a single channel.
+//
+// The expansion is done in double, whenever the sections change, and never on the per-sample
+// path. Branches are keyed by the caller's slots, so a section keeps its branch state while other
+// sections come and go.
+//
+// Poles that coincide, e.g. two identical peaks, have no partial-fraction expansion, and poles
+// that nearly do turn into branches that cancel each other out, which float cannot afford. Such a
+// cascade runs in series instead, with the same coefficients; either form starts from a cleared
+// state when the other hands over.
+//
+// New sections do not step in: the next process() call ramps the branches' coefficients, or the
+// sections' in series, from the ones before to the new ones across its samples. A branch that is
+// new fades in from nothing, and a section new to the series from one that passes the signal
+// unchanged. Either form keeps its poles inside the unit circle all the way, as the coefficient
+// pairs that do so make up a convex set.
+class ParallelSections {
+public:
+    static constexpr size_t MAX_SECTIONS = BiquadCascade::MAX_SECTIONS;
+
+    // Bound on the gain from the branches' rounding noise to the output, above which the series
+    // form is used. Float keeps about 24 bits, so this leaves the error around -100 dB.
+    static constexpr double MAX_NOISE_GAIN = 100.0;
+
+    ParallelSections() = default;
+    ~ParallelSections() = default;
+
+    void prepare(int numChannels) {
+        states_.assign(static_cast<size_t>(numChannels), {});
+        reset();
+    }
+
+    /** Clears the state, and lets the sections set next apply at once instead of ramping. */
+    void reset() noexcept {
+        std::fill(states_.begin(), states_.end(), State{});
+        settleRamp();
+        isStarting_ = true;
+    }
+
+    /** Sets the cascade to run, one section per slot, in cascade order. The next process() call
+        ramps to it; see the class comment. */
+    void setSections(std::span<const size_t> slots, std::span<const BiquadFilter::Coefficients> sections) noexcept {
+        jassert(slots.size() == sections.size() && slots.size() <= MAX_SECTIONS);
+
+        if (isUnchanged(slots, sections)) {
+            return;
+        }
+
+        std::array<size_t, MAX_SECTIONS> previousSlots{};
+        std::copy(slots_.begin(), std::next(slots_.begin(), static_cast<std::ptrdiff_t>(numSections_)),
+                  previousSlots.begin());
+        const auto previousNumSections = numSections_;
+        const auto wasParallel = isParallel_;
+
+        numSections_ = slots.size();
+        std::copy(slots.begin(), slots.end(), slots_.begin());
+        std::copy(sections.begin(), sections.end(), sections_.begin());
+        isParallel_ = expand();
+
+        if (isParallel_ != wasParallel) {
+            reset();
+            return;
+        }
+
+        remapStates({previousSlots.data(), previousNumSections});
+
+        if (isStarting_) {
+            settleRamp();
+        } else {
+            remapRamp({previousSlots.data(), previousNumSections});
+        }
+    }
+
+    /** False while the sections run in series; see the class comment. */
+    bool isParallel() const noexcept { return isParallel_; }
+
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept {
+        if (numSamples <= 0) {
+            return;
+        }
+
+        const auto numChannels = juce::jmin(static_cast<size_t>(buffer.getNumChannels()), states_.size());
+
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            auto* samples = buffer.getWritePointer(static_cast<int>(ch), startSample);
+
+            if (!isParallel_) {
+                processSeries(samples, numSamples, states_[ch]);
+                continue;
+            }
+
+#if JUCE_USE_SIMD
+            if (isRamping_) {
+                processParallelSIMD<true>(samples, numSamples, states_[ch]);
+            } else {
+                processParallelSIMD<false>(samples, numSamples, states_[ch]);
+            }
+#else
+            processParallelScalar(samples, numSamples, states_[ch]);
+#endif
+        }
+
+        if (isRamping_) {
+            settleRamp();
+        }
+        isStarting_ = false;
+    }
+
+private:
+    // Branch k, or section k in series, keeps its state in element k.
+    struct alignas(32) State {
+        std::array<float, MAX_SECTIONS> s1{};
+        std::array<float, MAX_SECTIONS> s2{};
+    };
+
+    // Branch k is (beta0 + beta1 z^-1) / (1 + alpha1 z^-1 + alpha2 z^-2); unused branches have
+    // zero coefficients and add nothing.
+    struct Branches {
+        alignas(32) std::array<float, MAX_SECTIONS> beta0{};
+        alignas(32) std::array<float, MAX_SECTIONS> beta1{};
+        alignas(32) std::array<float, MAX_SECTIONS> alpha1{};
+        alignas(32) std::array<float, MAX_SECTIONS> alpha2{};
+        float direct{1.0f};
+    };
+
+    struct SectionPoles {
+        std::array<std::complex<double>, 2> poles{};
+        int numPoles{0};
+    };
+
+    bool isUnchanged(std::span<const size_t> slots, std::span<const BiquadFilter::Coefficients> sections) const noexcept {
+        if (slots.size() != numSections_) {
+            return false;
+        }
+
+        for (size_t i = 0; i < numSections_; ++i) {
+            const auto& a = sections[i];
+            const auto& b = sections_[i];
+            if (slots[i] != slots_[i] || !juce::exactlyEqual(a.b0, b.b0) || !juce::exactlyEqual(a.b1, b.b1)
+                || !juce::exactlyEqual(a.b2, b.b2) || !juce::exactlyEqual(a.a1, b.a1) || !juce::exactlyEqual(a.a2, b.a2)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // A slot that is still there takes its state along to its new position; a new one starts
+    // from zero.
+    void remapStates(std::span<const size_t> previousSlots) noexcept {
+        for (auto& state : states_) {
+            const auto previous = state;
+            state = {};
+
+            for (size_t k = 0; k < numSections_; ++k) {
+                const auto found = std::find(previousSlots.begin(), previousSlots.end(), slots_[k]);
+                if (found != previousSlots.end()) {
+                    const auto index = static_cast<size_t>(std::distance(previousSlots.begin(), found));
+                    state.s1[k] = previous.s1[index];
+                    state.s2[k] = previous.s2[index];
+                }
+            }
+        }
+    }
+
+    // The coefficients the last process() call ended on become where the next one ramps from, in
+    // the new slots' order. A slot that is still there carries on from its own; a new branch starts
+    // from zero with the new poles, and a new section in series from numerator = denominator.
+    void remapRamp(std::span<const size_t> previousSlots) noexcept {
+        const auto previousBranches = rampBranches_;
+        const auto previousSections = rampSections_;
+        rampBranches_ = {};
+        rampBranches_.direct = previousBranches.direct;
+
+        for (size_t k = 0; k < numSections_; ++k) {
+            const auto found = std::find(previousSlots.begin(), previousSlots.end(), slots_[k]);
+
+            if (found == previousSlots.end()) {
+                const auto& c = sections_[k];
+                rampBranches_.alpha1[k] = branches_.alpha1[k];
+                rampBranches_.alpha2[k] = branches_.alpha2[k];
+                rampSections_[k] = {1.0f, c.a1, c.a2, c.a1, c.a2};
+                continue;
+            }
+
+            const auto index = static_cast<size_t>(std::distance(previousSlots.begin(), found));
+            rampBranches_.beta0[k] = previousBranches.beta0[index];
+            rampBranches_.beta1[k] = previousBranches.beta1[index];
+            rampBranches_.alpha1[k] = previousBranches.alpha1[index];
+            rampBranches_.alpha2[k] = previousBranches.alpha2[index];
+            rampSections_[k] = previousSections[index];
+        }
+
+        isRamping_ = true;
+    }
+
+    void settleRamp() noexcept {
+        rampBranches_ = branches_;
+        rampSections_ = sections_;
+        isRamping_ = false;
+    }
+
+    static BiquadFilter::Coefficients interpolate(const BiquadFilter::Coefficients& from,
+                                                  const BiquadFilter::Coefficients& to, float t) noexcept {
+        return {std::lerp(from.b0, to.b0, t), std::lerp(from.b1, to.b1, t), std::lerp(from.b2, to.b2, t),
+                std::lerp(from.a1, to.a1, t), std::lerp(from.a2, to.a2, t)};
+    }
+
+    // Poles of 1 + a1 z^-1 + a2 z^-2 other than z = 0.
+    static SectionPoles findPoles(const BiquadFilter::Coefficients& c) noexcept {
+        const auto a1 = static_cast<double>(c.a1);
+        const auto a2 = static_cast<double>(c.a2);
+        SectionPoles result;
+
+        if (juce::exactlyEqual(a2, 0.0)) {
+            if (!juce::exactlyEqual(a1, 0.0)) {
+                result.poles[0] = -a1;
+                result.numPoles = 1;
+            }
+            return result;
+        }
+
+        const auto discriminant = a1 * a1 - 4.0 * a2;
+        result.numPoles = 2;
+
+        if (discriminant < 0.0) {
+            result.poles[0] = {-0.5 * a1, 0.5 * std::sqrt(-discriminant)};
+            result.poles[1] = std::conj(result.poles[0]);
+            return result;
+        }
+
+        // The larger root first, and the smaller from the product, which avoids cancellation.
+        const auto larger = -0.5 * (a1 + std::copysign(std::sqrt(discriminant), a1));
+        result.poles[0] = larger;
+        result.poles[1] = a2 / larger;
+        return result;
+    }
+
+    // The residue of the cascade at pole j of section i: the cascade with that pole's factor
+    // removed, evaluated at the pole. Empty when another pole coincides with it.
+    std::optional<std::complex<double>> findResidue(const std::array<SectionPoles, MAX_SECTIONS>& poles, size_t i,
+                                                    size_t j) const noexcept {
+        const auto w = 1.0 / poles[i].poles[j];
+        std::complex<double> residue{1.0};
+
+        for (size_t k = 0; k < numSections_; ++k) {
+            const auto& c = sections_[k];
+            residue *= static_cast<double>(c.b0) + w * (static_cast<double>(c.b1) + w * static_cast<double>(c.b2));
+
+            for (size_t m = 0; m < static_cast<size_t>(poles[k].numPoles); ++m) {
+                if (k == i && m == j) {
+                    continue;
+                }
+
+                const auto factor = 1.0 - poles[k].poles[m] * w;
+                if (std::abs(factor) < 1e-9) {
+                    return std::nullopt;
+                }
+                residue /= factor;
+            }
+        }
+
+        return residue;
+    }
+
+    // Fills the branches and the direct gain; false when the cascade has to run in series.
+    bool expand() noexcept {
+        std::array<SectionPoles, MAX_SECTIONS> poles;
+        auto direct = 1.0;
+
+        for (size_t i = 0; i < numSections_; ++i) {
+            const auto& c = sections_[i];
+            poles[i] = findPoles(c);
+
+            // The direct gain is the cascade at z = 0, where each section tends to the ratio of its
+            // highest-order terms. A numerator of higher order than its denominator would leave an
+            // FIR part over.
+            switch (poles[i].numPoles) {
+                case 2:
+                    direct *= static_cast<double>(c.b2) / static_cast<double>(c.a2);
+                    break;
+                case 1:
+                    if (!juce::exactlyEqual(c.b2, 0.0f)) {
+                        return false;
+                    }
+                    direct *= static_cast<double>(c.b1) / static_cast<double>(c.a1);
+                    break;
+                default:
+                    if (!juce::exactlyEqual(c.b1, 0.0f) || !juce::exactlyEqual(c.b2, 0.0f)) {
+                        return false;
+                    }
+                    direct *= static_cast<double>(c.b0);
+                    break;
+            }
+        }
+
+        branches_ = {};
+        auto noiseGain = std::abs(direct);
+
+        for (size_t i = 0; i < numSections_; ++i) {
+            std::array<std::complex<double>, 2> residues{};
+
+            for (size_t j = 0; j < static_cast<size_t>(poles[i].numPoles); ++j) {
+                const auto& pole = poles[i].poles[j];
+                const auto residue = findResidue(poles, i, j);
+                if (std::abs(pole) >= 1.0 || !residue.has_value()) {
+                    return false;
+                }
+
+                residues[j] = *residue;
+                noiseGain += std::abs(*residue) / (1.0 - std::abs(pole));
+            }
+
+            const auto [p1, p2] = poles[i].poles;
+            const auto [r1, r2] = residues;
+
+            // r1 / (1 - p1 z^-1) + r2 / (1 - p2 z^-1) over a common denominator. For a conjugate
+            // pair the imaginary parts cancel, and for a single pole p2 and r2 are zero.
+            branches_.beta0[i] = static_cast<float>((r1 + r2).real());
+            branches_.beta1[i] = static_cast<float>(-(r1 * p2 + r2 * p1).real());
+            branches_.alpha1[i] = static_cast<float>(-(p1 + p2).real());
+            branches_.alpha2[i] = static_cast<float>((p1 * p2).real());
+        }
+
+        branches_.direct = static_cast<float>(direct);
+        return noiseGain <= MAX_NOISE_GAIN;
+    }
+
+    // The ramps reach the new coefficients on the last sample.
+    void processSeries(float* samples, int numSamples, State& state) const noexcept {
+        const auto step = 1.0f / static_cast<float>(numSamples);
+
+        for (int n = 0; n < numSamples; ++n) {
+            const auto t = static_cast<float>(n + 1) * step;
+            auto x = samples[n];
+
+            for (size_t i = 0; i < numSections_; ++i) {
+                const auto c = isRamping_ ? interpolate(rampSections_[i], sections_[i], t) : sections_[i];
+                const auto y = c.b0 * x + state.s1[i];
+                state.s1[i] = c.b1 * x - c.a1 * y + state.s2[i];
+                state.s2[i] = c.b2 * x - c.a2 * y;
+                x = y;
+            }
+
+            samples[n] = x;
+        }
+    }
+
+    void processParallelScalar(float* samples, int numSamples, State& state) const noexcept {
+        const auto& from = rampBranches_;
+        const auto& to = branches_;
+        const auto step = 1.0f / static_cast<float>(numSamples);
+
+        for (int n = 0; n < numSamples; ++n) {
+            const auto t = isRamping_ ? static_cast<float>(n + 1) * step : 1.0f;
+            const auto x = samples[n];
+            auto y = std::lerp(from.direct, to.direct, t) * x;
+
+            for (size_t k = 0; k < numSections_; ++k) {
+                const auto v = std::lerp(from.beta0[k], to.beta0[k], t) * x + state.s1[k];
+                state.s1[k] = std::lerp(from.beta1[k], to.beta1[k], t) * x
+                              - std::lerp(from.alpha1[k], to.alpha1[k], t) * v + state.s2[k];
+                state.s2[k] = -std::lerp(from.alpha2[k], to.alpha2[k], t) * v;
+                y += v;
+            }
+
+            samples[n] = y;
+        }
+    }
+
+#if JUCE_USE_SIMD
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+    static constexpr size_t SIMD_LANES = SIMDFloat::size();
+    static constexpr size_t MAX_GROUPS = MAX_SECTIONS / SIMD_LANES;
+    static_assert(MAX_SECTIONS % SIMD_LANES == 0);
+
+    struct BranchGroup {
+        SIMDFloat beta0;
+        SIMDFloat beta1;
+        SIMDFloat alpha1;
+        SIMDFloat alpha2;
+    };
+
+    static BranchGroup loadGroup(const Branches& branches, size_t g) noexcept {
+        const auto offset = g * SIMD_LANES;
+        return {SIMDFloat::fromRawArray(branches.beta0.data() + offset),
+                SIMDFloat::fromRawArray(branches.beta1.data() + offset),
+                SIMDFloat::fromRawArray(branches.alpha1.data() + offset),
+                SIMDFloat::fromRawArray(branches.alpha2.data() + offset)};
+    }
+
+    // Lane k of group g carries branch g * SIMD_LANES + k. While ramping, the coefficients step
+    // by a fixed increment every sample.
+    template <bool isRamping>
+    void processParallelSIMD(float* samples, int numSamples, State& state) const noexcept {
+        const auto numGroups = (numSections_ + SIMD_LANES - 1) / SIMD_LANES;
+        const auto& from = isRamping ? rampBranches_ : branches_;
+        const auto step = 1.0f / static_cast<float>(numSamples);
+        std::array<SIMDFloat, MAX_GROUPS> s1;
+        std::array<SIMDFloat, MAX_GROUPS> s2;
+        std::array<BranchGroup, MAX_GROUPS> coefficients;
+        std::array<BranchGroup, MAX_GROUPS> increments;
+
+        for (size_t g = 0; g < numGroups; ++g) {
+            s1[g] = SIMDFloat::fromRawArray(state.s1.data() + g * SIMD_LANES);
+            s2[g] = SIMDFloat::fromRawArray(state.s2.data() + g * SIMD_LANES);
+            coefficients[g] = loadGroup(from, g);
+
+            if constexpr (isRamping) {
+                const auto to = loadGroup(branches_, g);
+                const auto& c = coefficients[g];
+                increments[g] = {(to.beta0 - c.beta0) * step, (to.beta1 - c.beta1) * step,
+                                 (to.alpha1 - c.alpha1) * step, (to.alpha2 - c.alpha2) * step};
+            }
+        }
+
+        auto direct = from.direct;
+        const auto directIncrement = (branches_.direct - from.direct) * step;
+
+        for (int n = 0; n < numSamples; ++n) {
+            const auto x = SIMDFloat::expand(samples[n]);
+            auto sum = SIMDFloat::expand(0.0f);
+
+            for (size_t g = 0; g < numGroups; ++g) {
+                auto& c = coefficients[g];
+
+                if constexpr (isRamping) {
+                    c.beta0 += increments[g].beta0;
+                    c.beta1 += increments[g].beta1;
+                    c.alpha1 += increments[g].alpha1;
+                    c.alpha2 += increments[g].alpha2;
+                }
+
+                const auto v = c.beta0 * x + s1[g];
+                s1[g] = c.beta1 * x - c.alpha1 * v + s2[g];
+                s2[g] = SIMDFloat::expand(0.0f) - c.alpha2 * v;
+                sum += v;
+            }
+
+            if constexpr (isRamping) {
+                direct += directIncrement;
+            }
+
+            samples[n] = direct * samples[n] + sum.sum();
+        }
+
+        for (size_t g = 0; g < numGroups; ++g) {
+            s1[g].copyToRawArray(state.s1.data() + g * SIMD_LANES);
+            s2[g].copyToRawArray(state.s2.data() + g * SIMD_LANES);
+        }
+    }
+#endif
+
+    std::array<size_t, MAX_SECTIONS> slots_{};
+    std::array<BiquadFilter::Coefficients, MAX_SECTIONS> sections_{};
+    size_t numSections_{0};
+    bool isParallel_{true};
+    Branches branches_;
+
+    // Where the next process() call ramps from, in the current slots' order.
+    Branches rampBranches_;
+    std::array<BiquadFilter::Coefficients, MAX_SECTIONS> rampSections_{};
+    bool isRamping_{false};
+    bool isStarting_{true};
+
+    std::vector<State> states_;
+};
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <numbers>
+
+#include "BiquadFilter.h"
+#include "EllipticPrototype.h"
+
+// A low- or high-pass slope built from up to MAX_SECTIONS second-order sections sharing one
+// cutoff. The section Qs follow the Butterworth table for the resulting order, with the sharpest
+// one scaled by the resonance over 1 / sqrt(2), so a resonance of 0.707 is maximally flat at
+// every slope and 12 dB/oct keeps its plain biquad Q. The parameters' default of 1.0 is a little
+// above that: at 24 dB/oct the sharpest section has a Q of about 1.85 rather than 1.31.
+//
+// Section 0 leads: it is the only one that smooths the parameters, and each of its designs
+// evaluates the trig once for the whole stack and hands the followers their coefficients,
+// ramped over the same control interval. The followers only run their bypass fades and
+// coefficient ramps, so they have to be advanced in step with the leader, sample by sample,
+// the way BiquadCascade drives its sections.
+//
+// In steep mode the stack instead realises an elliptic prototype, frequency-scaled to the
+// cutoff through a prewarped bilinear transform. The cutoff is then the passband edge and the
+// resonance control has no effect.
+class PassFilterCascade {
+public:
+    enum class Type { lowPass, highPass };
+
+    static constexpr int MAX_SECTIONS = 8;
+
+    explicit PassFilterCascade(Type type) : type_(type) {
+        for (size_t i = 0; i < sections_.size(); ++i) {
+            sections_[i].attach(*this, i);
+        }
+
+        updateSectionQs();
+    }
+
+    ~PassFilterCascade() = default;
+
+    void prepare(double sampleRate, int numChannels) {
+        sampleRate_ = sampleRate;
+
+        for (auto& section : sections_) {
+            section.prepare(sampleRate, numChannels);
+        }
+    }
+
+    /** Moves the stack to another sample rate, keeping its parameters; see BiquadFilter. */
+    void setSampleRate(double sampleRate) {
+        sampleRate_ = sampleRate;
+
+        for (auto& section : sections_) {
+            section.setSampleRate(sampleRate);
+        }
+    }
+
+    void reset() {
+        for (auto& section : sections_) {
+            section.reset();
+        }
+    }
+
+    /** Designs the leader first so every follower starts from the shared design. */
+    void setParametersAndReset(double frequency, double Q) {
+        for (auto& section : sections_) {
+            section.setParametersAndReset(frequency, Q);
+        }
+    }
+
+    /** Settles the leader first, which hands the followers its final design. */
+    void settleParameters() {
+        for (auto& section : sections_) {
+            section.settleParameters();
+        }
+    }
+
+    void setControlInterval(int numSamples) noexcept { sections_[0].setControlInterval(numSamples); }
+
+    /** The leader designs the whole stack in its precision; see BiquadFilter. */
+    void setDoublePrecision(bool shouldUseDoublePrecision) noexcept {
+        for (auto& section : sections_) {
+            section.setDoublePrecision(shouldUseDoublePrecision);
+        }
+    }
+
+    void setFrequency(double frequency) { sections_[0].setFrequency(frequency); }
+    void setQ(double Q) { sections_[0].setQ(Q); }
+
+    void setBypassed(bool shouldBypass) noexcept {
+        for (auto& section : sections_) {
+            section.setBypassed(shouldBypass);
+        }
+    }
+
+    /** Changing the order changes every section's Q, so the stack is redesigned at once. */
+    void setNumSections(int numSections) noexcept {
+        const auto clamped = juce::jlimit(1, MAX_SECTIONS, numSections);
+        if (clamped == numSections_) {
+            return;
+        }
+
+        numSections_ = clamped;
+        updateSectionQs();
+        sections_[0].invalidateDesign();
+    }
+
+    /** Switches to the given elliptic prototype, or back to the Butterworth stack when null.
+        The prototype is not copied and has to outlive its use here. */
+    void setSteepPrototype(const EllipticPrototype* prototype) noexcept {
+        if (prototype == steepPrototype_) {
+            return;
+        }
+
+        steepPrototype_ = prototype;
+        sections_[0].invalidateDesign();
+    }
+
+    int getNumSections() const noexcept {
+        return steepPrototype_ != nullptr ? steepPrototype_->numSections : numSections_;
+    }
+
+    /** For the response and for BiquadCascade. Only section 0 can be processed on its own: the
+        others take their coefficients from its designs as it advances, so they are only right
+        when stepped along with it, one sample at a time. */
+    BiquadFilter& getSection(size_t index) noexcept { return sections_[index]; }
+
+    /** Q of section index in a Butterworth filter of order 2 * numSections, sharpest first. */
+    static double getButterworthQ(int numSections, int index) noexcept {
+        const auto order = 2.0 * static_cast<double>(numSections);
+        const auto angle = (2.0 * static_cast<double>(index) + 1.0) * std::numbers::pi / (2.0 * order);
+        return 1.0 / (2.0 * std::sin(angle));
+    }
+
+private:
+    class Section : public BiquadFilterDesign<Section> {
+    public:
+        void attach(PassFilterCascade& owner, size_t index) noexcept {
+            owner_ = &owner;
+            index_ = index;
+        }
+
+        void invalidateDesign() noexcept { coeffsDirty_ = true; }
+
+    private:
+        friend class BiquadFilter;
+
+        void calculateAndSetCoefficients(float Q, float amplitude, float frequency) override {
+            juce::ignoreUnused(amplitude);
+
+            if (index_ == 0) {
+                owner_->designSections(Q, frequency, doublePrecision_);
+            }
+
+            setCoefficients(owner_->designs_[index_]);
+        }
+
+        void onCoefficientsDesigned(int rampSamples) override {
+            if (index_ != 0) {
+                return;
+            }
+
+            for (size_t i = 1; i < owner_->sections_.size(); ++i) {
+                owner_->sections_[i].rampCoefficientsTo(owner_->designs_[i], rampSamples);
+            }
+        }
+
+        PassFilterCascade* owner_{nullptr};
+        size_t index_{0};
+    };
+
+    void updateSectionQs() noexcept {
+        const auto reference = getButterworthQ(1, 0);
+
+        for (int i = 0; i < MAX_SECTIONS; ++i) {
+            const auto q = getButterworthQ(numSections_, juce::jmin(i, numSections_ - 1));
+            sectionQs_[static_cast<size_t>(i)] = static_cast<float>(i == 0 ? q / reference : q);
+        }
+    }
+
+    void designSections(float Q, float frequency, bool inDoublePrecision) noexcept {
+        if (steepPrototype_ != nullptr) {
+            designSteepSections(frequency);
+        } else if (inDoublePrecision) {
+            designButterworthSections(static_cast<double>(Q), static_cast<double>(frequency));
+        } else {
+            designButterworthSections(Q, frequency);
+        }
+    }
+
+    template <typename T>
+    void designButterworthSections(T Q, T frequency) noexcept {
+        const auto w0 = T(2) * std::numbers::pi_v<T> * frequency / static_cast<T>(sampleRate_);
+        const auto [sin_w, cos_w] = fast_math::sinCosFor(w0);
+
+        const auto b0 = type_ == Type::lowPass ? (T(1) - cos_w) / T(2) : (T(1) + cos_w) / T(2);
+        const auto b1 = type_ == Type::lowPass ? T(1) - cos_w : -(T(1) + cos_w);
+
+        for (size_t i = 0; i < designs_.size(); ++i) {
+            const auto sectionQ = i == 0 ? Q * static_cast<T>(sectionQs_[0]) : static_cast<T>(sectionQs_[i]);
+            const auto alpha = sin_w / (T(2) * sectionQ);
+            const auto a0 = T(1) + alpha;
+
+            designs_[i] = BiquadCoefficients<T>{b0 / a0, b1 / a0, b0 / a0, T(-2) * cos_w / a0, (T(1) - alpha) / a0}
+                              .template convertTo<double>();
+        }
+    }
+
+    // Each prototype section (s^2 + wz^2) / (s^2 + (wp / Q) s + wp^2) is scaled to the cutoff and
+    // mapped through the bilinear transform with the 2 * fs factor divided out, so the cutoff only
+    // enters through t = tan(pi * fc / fs). The high-pass uses the reciprocal frequencies. This
+    // design always runs in double.
+    void designSteepSections(float frequency) noexcept {
+        const auto& prototype = *steepPrototype_;
+        const auto nyquistLimit = 0.49 * sampleRate_;
+        const auto t = std::tan(std::numbers::pi * juce::jmin(static_cast<double>(frequency), nyquistLimit) / sampleRate_);
+
+        for (int i = 0; i < prototype.numSections; ++i) {
+            const auto& section = prototype.sections[static_cast<size_t>(i)];
+            const auto lowPass = type_ == Type::lowPass;
+
+            const auto wz = lowPass ? t * section.zeroFrequency : t / section.zeroFrequency;
+            const auto wp = lowPass ? t * section.poleFrequency : t / section.poleFrequency;
+            const auto wz2 = wz * wz;
+            const auto wp2 = wp * wp;
+
+            auto gain = lowPass ? wp2 / wz2 : 1.0;
+            if (i == 0) {
+                gain *= prototype.gain;
+            }
+
+            const auto a0 = 1.0 + wp / section.poleQ + wp2;
+            const auto b0 = gain * (1.0 + wz2) / a0;
+
+            designs_[static_cast<size_t>(i)] = {b0, gain * 2.0 * (wz2 - 1.0) / a0, b0, 2.0 * (wp2 - 1.0) / a0,
+                                                (1.0 - wp / section.poleQ + wp2) / a0};
+        }
+    }
+
+    Type type_;
+    double sampleRate_{44100.0};
+    int numSections_{1};
+    const EllipticPrototype* steepPrototype_{nullptr};
+
+    std::array<Section, MAX_SECTIONS> sections_;
+    std::array<float, MAX_SECTIONS> sectionQs_{};
+    std::array<BiquadCoefficients<double>, MAX_SECTIONS> designs_{};
+
+    JUCE_DECLARE_NON_COPYABLE(PassFilterCascade)
+};
@@ -2,34 +2,39 @@
 #include <numbers>
 
 #include "FilterParameters.h"
+#include "MatchedDesign.h"
 
-class PeakFilter : public BiquadFilter {
+class PeakFilter : public BiquadFilterDesign<PeakFilter> {
 public:
     PeakFilter() = default;
     ~PeakFilter() override = default;
 private:
+    friend class BiquadFilter;
+
     void calculateAndSetCoefficients(float Q, float amplitude, float frequency) override {
-        const auto sampleRate = static_cast<float>(sampleRate_);
-        const auto w0 = 2.0f * std::numbers::pi_v<float> * frequency / sampleRate;
-        const auto cos_w = static_cast<float>(std::cos(w0));
-        const auto alpha = std::sin(w0) / (2.0f * Q);
+        designInPrecision([this](auto q, auto a, auto f) { return design(q, a, f); }, Q, amplitude, frequency);
+    }
+
+    template <typename T>
+    BiquadCoefficients<T> design(T Q, T A, T frequency) const noexcept {
+        const auto w0 = getOmega(frequency);
 
-        const auto A = amplitude;
+        if (designMode_ == DesignMode::matchedMagnitude) {
+            return MatchedDesign::designPeak(static_cast<double>(Q), static_cast<double>(A), static_cast<double>(w0))
+                .template convertTo<T>();
+        }
 
-        float a0 = 1.0f + (alpha / A);
+        const auto [sin_w, cos_w] = fast_math::sinCosFor(w0);
+        const auto alpha = sin_w / (T(2) * Q);
 
-        float b0 = 1.0f + (alpha * A);
-        float b1 = -2.0f * cos_w;
-        float b2 = 1.0f - (alpha * A);
-        float a1 = -2.0f * cos_w;
-        float a2 = 1.0f - (alpha / A);
+        T a0 = T(1) + (alpha / A);
 
-        b0 /= a0;
-        b1 /= a0;
-        b2 /= a0;
-        a1 /= a0;
-        a2 /= a0;
+        T b0 = T(1) + (alpha * A);
+        T b1 = T(-2) * cos_w;
+        T b2 = T(1) - (alpha * A);
+        T a1 = T(-2) * cos_w;
+        T a2 = T(1) - (alpha / A);
 
-        setCoefficients(b0, b1, b2, a0, a1, a2);
+        return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
     }
 };
\ No newline at end of file
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+
+#include "../utils/FastMath.h"
+
+// Trapezoidal state-variable filter (Simper, "Linear Trap Integrated SVF"; Zavalishin, "The Art
+// of VA Filter Design"). The states are the integrator charges rather than past outputs, so the
+// filter stays well behaved when it is retuned every sample, and a retune costs one tan and a
+// few multiplies. Every response is a mix of the input and the band- and low-pass outputs,
+//
+//     y = m0 * x + m1 * v1 + m2 * v2,
+//
+// and for the same frequency, Q and gain it has the magnitude response of the RBJ biquad of the
+// same type, since both are the bilinear transform of one analog prototype.
+//
+// The parameters are smoothed like BiquadFilter's, but the coefficients follow the smoothers on
+// every sample instead of being ramped at control rate.
+class SvfFilter {
+public:
+    enum class Type { peak, lowShelf, highShelf, lowPass, highPass, bandPass, notch };
+
+    explicit SvfFilter(Type type = Type::peak) : type_(type) {}
+    ~SvfFilter() = default;
+
+    void prepare(double sampleRate, int numChannels) {
+        sampleRate_ = sampleRate;
+        numChannels_ = numChannels;
+
+        ic1eq_.assign(static_cast<size_t>(numChannels_), 0.0f);
+        ic2eq_.assign(static_cast<size_t>(numChannels_), 0.0f);
+
+        bypassMix_.reset(sampleRate_, 0.005);
+        bypassMix_.setCurrentAndTargetValue(isBypassed_ ? 0.0f : 1.0f);
+    }
+
+    void reset() noexcept {
+        std::fill(ic1eq_.begin(), ic1eq_.end(), 0.0f);
+        std::fill(ic2eq_.begin(), ic2eq_.end(), 0.0f);
+    }
+
+    /** Filters the channels the filter was prepared for; any others pass through. */
+    void processBlock(juce::AudioBuffer<float>& buffer) noexcept {
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), numChannels_);
+
+        if (isIdle()) {
+            wasIdle_ = true;
+            return;
+        }
+
+        if (wasIdle_) {
+            resumeFromIdle();
+            wasIdle_ = false;
+        }
+
+        const auto numSamples = buffer.getNumSamples();
+        auto* const* channelData = buffer.getArrayOfWritePointers();
+
+        for (int n = 0; n < numSamples; ++n) {
+            updateSmoothedParameters();
+            const auto mix = bypassMix_.getNextValue();
+            if (mix <= EPSILON) {
+                continue;
+            }
+
+            for (size_t ch = 0; ch < static_cast<size_t>(numChannels); ++ch) {
+                const auto x = channelData[ch][n];
+                auto& ic1eq = ic1eq_[ch];
+                auto& ic2eq = ic2eq_[ch];
+
+                const auto v3 = x - ic2eq;
+                const auto v1 = a1_ * ic1eq + a2_ * v3;
+                const auto v2 = ic2eq + a2_ * ic1eq + a3_ * v3;
+                ic1eq = 2.0f * v1 - ic1eq;
+                ic2eq = 2.0f * v2 - ic2eq;
+
+                const auto y = m0_ * x + m1_ * v1 + m2_ * v2;
+                channelData[ch][n] = x + mix * (y - x);
+            }
+        }
+    }
+
+    void setParametersAndReset(double frequency, double Q, float gainDb = 0.0f) {
+        qSmoothed_.reset(sampleRate_, 0.02);
+        gainSmoothed_.reset(sampleRate_, 0.01);
+        freqSmoothed_.reset(sampleRate_, 0.01);
+
+        qSmoothed_.setCurrentAndTargetValue(static_cast<float>(Q));
+        gainSmoothed_.setCurrentAndTargetValue(std::pow(10.0f, gainDb / 40.0f));
+        freqSmoothed_.setCurrentAndTargetValue(static_cast<float>(frequency));
+
+        designCoefficients();
+        reset();
+    }
+
+    void setFrequency(double frequency) { freqSmoothed_.setTargetValue(static_cast<float>(frequency)); }
+    void setQ(double Q) { qSmoothed_.setTargetValue(static_cast<float>(Q)); }
+
+    /** Gain of a peak or shelf, with the same 10^(dB / 40) amplitude as BiquadFilter::setAmplitude40. */
+    void setAmplitude40(float gainDb) { gainSmoothed_.setTargetValue(std::pow(10.0f, gainDb / 40.0f)); }
+
+    void setBypassed(bool shouldBypass) noexcept {
+        isBypassed_ = shouldBypass;
+        bypassMix_.setTargetValue(shouldBypass ? 0.0f : 1.0f);
+    }
+
+    /** Finishes the parameter glides and the bypass fade at once. */
+    void settleParameters() noexcept {
+        qSmoothed_.setCurrentAndTargetValue(qSmoothed_.getTargetValue());
+        gainSmoothed_.setCurrentAndTargetValue(gainSmoothed_.getTargetValue());
+        freqSmoothed_.setCurrentAndTargetValue(freqSmoothed_.getTargetValue());
+        bypassMix_.setCurrentAndTargetValue(bypassMix_.getTargetValue());
+        designCoefficients();
+    }
+
+    /** True when processing would leave the signal untouched: the bypass fade has finished, or a
+        peak or shelf sits at exactly 0 dB with nothing gliding. */
+    bool isIdle() const noexcept {
+        if (bypassMix_.isSmoothing()) {
+            return false;
+        }
+
+        if (bypassMix_.getCurrentValue() <= EPSILON) {
+            return true;
+        }
+
+        return !isSmoothingParameters() && juce::exactlyEqual(m0_, 1.0f) && juce::exactlyEqual(m1_, 0.0f)
+            && juce::exactlyEqual(m2_, 0.0f);
+    }
+
+    float getMagnitudeAtFrequency(double freq) const {
+        if (sampleRate_ <= 0.0 || isBypassed_) {
+            return 1.0f;
+        }
+
+        // The bilinear transform maps freq to the analog frequency tan(pi * freq / fs), and the
+        // design is normalised to an analog cutoff of g.
+        const auto s = std::complex<double>{0.0, std::tan(std::numbers::pi * freq / sampleRate_) / static_cast<double>(g_)};
+        const auto k = static_cast<double>(k_);
+        const auto denominator = s * s + k * s + 1.0;
+        const auto numerator = static_cast<double>(m0_) * denominator + static_cast<double>(m1_) * s
+                             + static_cast<double>(m2_);
+
+        return static_cast<float>(std::abs(numerator / denominator));
+    }
+
+    float getMagnitudeDbAt(double frequencyHz) const noexcept {
+        return juce::Decibels::gainToDecibels(getMagnitudeAtFrequency(frequencyHz));
+    }
+
+    static constexpr float EPSILON = 1e-3f;
+
+private:
+    void resumeFromIdle() noexcept {
+        if (bypassMix_.getCurrentValue() <= EPSILON) {
+            qSmoothed_.setCurrentAndTargetValue(qSmoothed_.getTargetValue());
+            gainSmoothed_.setCurrentAndTargetValue(gainSmoothed_.getTargetValue());
+            freqSmoothed_.setCurrentAndTargetValue(freqSmoothed_.getTargetValue());
+            designCoefficients();
+        }
+
+        reset();
+    }
+
+    bool isSmoothingParameters() const noexcept {
+        return qSmoothed_.isSmoothing() || gainSmoothed_.isSmoothing() || freqSmoothed_.isSmoothing();
+    }
+
+    void updateSmoothedParameters() noexcept {
+        if (!isSmoothingParameters()) {
+            return;
+        }
+
+        qSmoothed_.getNextValue();
+        gainSmoothed_.getNextValue();
+        freqSmoothed_.getNextValue();
+        designCoefficients();
+    }
+
+    void designCoefficients() noexcept {
+        const auto Q = qSmoothed_.getCurrentValue();
+        const auto A = gainSmoothed_.getCurrentValue();
+        const auto nyquistLimit = 0.49f * static_cast<float>(sampleRate_);
+        const auto frequency = std::clamp(freqSmoothed_.getCurrentValue(), 1.0f, nyquistLimit);
+
+        auto g = fast_math::tan(std::numbers::pi_v<float> * frequency / static_cast<float>(sampleRate_));
+        auto k = 1.0f / Q;
+
+        switch (type_) {
+            case Type::peak:
+                k = 1.0f / (Q * A);
+                setMix(1.0f, k * (A * A - 1.0f), 0.0f);
+                break;
+            case Type::lowShelf:
+                g /= std::sqrt(A);
+                setMix(1.0f, k * (A - 1.0f), A * A - 1.0f);
+                break;
+            case Type::highShelf:
+                g *= std::sqrt(A);
+                setMix(A * A, k * (1.0f - A) * A, 1.0f - A * A);
+                break;
+            case Type::lowPass:
+                setMix(0.0f, 0.0f, 1.0f);
+                break;
+            case Type::highPass:
+                setMix(1.0f, -k, -1.0f);
+                break;
+            case Type::bandPass:
+                setMix(0.0f, k, 0.0f);
+                break;
+            case Type::notch:
+                setMix(1.0f, -k, 0.0f);
+                break;
+        }
+
+        g_ = g;
+        k_ = k;
+        a1_ = 1.0f / (1.0f + g * (g + k));
+        a2_ = g * a1_;
+        a3_ = g * a2_;
+    }
+
+    void setMix(float m0, float m1, float m2) noexcept {
+        m0_ = m0;
+        m1_ = m1;
+        m2_ = m2;
+    }
+
+    Type type_;
+    double sampleRate_{44100.0};
+    int numChannels_{0};
+
+    float g_{1.0f};
+    float k_{1.0f};
+    float a1_{0.0f};
+    float a2_{0.0f};
+    float a3_{0.0f};
+    float m0_{1.0f};
+    float m1_{0.0f};
+    float m2_{0.0f};
+
+    std::vector<float> ic1eq_;
+    std::vector<float> ic2eq_;
+
+    juce::LinearSmoothedValue<float> bypassMix_{1.0f};
+    bool isBypassed_{false};
+    bool wasIdle_{false};
+
+    juce::SmoothedValue<float> qSmoothed_{1.0f};
+    juce::SmoothedValue<float> gainSmoothed_{1.0f};
+    juce::SmoothedValue<float> freqSmoothed_{1000.0f};
+};
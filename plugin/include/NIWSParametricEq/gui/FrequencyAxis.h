@@ -5,6 +5,7 @@
 #include <cmath>
 
 #include "../filters/BiquadFilter.h"
+#include "ResponseCache.h"
 
 namespace parametric_eq {
 class FrequencyAxis : public juce::Component {
@@ -30,18 +31,22 @@ public:
         repaint();
     }
 
-    float getCombinedMagnitudeDbAt(double freqHz, const std::vector<BiquadFilter*>& bands);
+    /** Repaints if a band's response changed since the last paint, as it does when the
+        equaliser picks up new parameters. */
+    void updateResponses();
 
 private:
     std::vector<BiquadFilter*> bands_;
     std::vector<BiquadFilter*> referenceBands_;
+    ResponseCache response_;
+    ResponseCache referenceResponse_;
     float minDb_ = -60.0f; 
     float maxDb_ = +60.0f;
 
     void drawGrid(juce::Graphics& g, juce::Rectangle<float> bounds);
     void drawZeroLine(juce::Graphics& g, juce::Rectangle<float> bounds);
     void drawResponse(juce::Graphics& g, juce::Rectangle<float> bounds,
-                      const std::vector<BiquadFilter*>& bands,
+                      const ResponseCache& response,
                       juce::Colour colour,
                       float thickness,
                       float alpha);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "../filters/BiquadFilter.h"
+
+namespace parametric_eq {
+// The response of a set of bands in dB, on a fixed grid of NUM_POINTS frequencies evenly spaced
+// in log frequency over the frequency axis, kept band by band. update() evaluates again only the
+// bands whose coefficients, rate or bypass changed, so dragging one handle costs that band's
+// curve; the total is the sum of the curves, in vector operations.
+class ResponseCache {
+public:
+    static constexpr size_t NUM_POINTS = 512;
+
+    ResponseCache();
+
+    /** Brings the curves up to date with bands, in order, and says whether the total changed. */
+    bool update(const std::vector<BiquadFilter*>& bands);
+
+    /** The frequency of each point of the grid. */
+    const std::vector<double>& getFrequencies() const noexcept { return frequencies_; }
+    const std::vector<float>& getTotalDb() const noexcept { return totalDb_; }
+
+    /** How many band curves the last update() evaluated. */
+    size_t getNumEvaluated() const noexcept { return numEvaluated_; }
+
+private:
+    // What a band's curve was evaluated for.
+    struct Band {
+        const BiquadFilter* filter{nullptr};
+        BiquadCoefficients<double> coefficients{};
+        double sampleRate{0.0};
+        bool bypassed{false};
+        std::vector<float> curveDb;
+    };
+
+    static bool isCurrent(const Band& band, const BiquadFilter& filter) noexcept;
+    void evaluate(Band& band, const BiquadFilter& filter);
+
+    std::vector<double> frequencies_;
+    std::vector<Band> bands_;
+    std::vector<float> totalDb_;
+    size_t numEvaluated_{0};
+};
+}  // namespace parametric_eq
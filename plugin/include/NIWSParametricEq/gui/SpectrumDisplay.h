@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <vector>
+
+#include "../SpectrumAnalyzer.h"
+
+namespace parametric_eq {
+// Turns the analyzer's levels into the stems the spectrum view draws: one per COLUMN_WIDTH pixels,
+// at the loudest level among the points that land in its column.
+//
+// Which points each column covers only changes with the bounds, and the width of the smoothing
+// window only with the smoothing, so both are worked out then rather than per frame. A frame
+// then costs a pass over the points and one over the columns, without allocating, and drawing
+// it a pass over the columns alone.
+class SpectrumDisplay {
+public:
+    // In the order of the analyzerSmoothing parameter's choices.
+    enum class Smoothing { none, twelfthOctave, sixthOctave, thirdOctave };
+
+    struct Column {
+        float x{0.0f};
+        float levelDb{0.0f};
+    };
+
+    static constexpr float COLUMN_WIDTH = 8.0f;
+
+    SpectrumDisplay();
+
+    void setBounds(juce::Rectangle<float> bounds);
+    void setSmoothing(Smoothing smoothing);
+    Smoothing getSmoothing() const noexcept { return smoothing_; }
+
+    /** Takes a frame of SpectrumAnalyzer::NUM_POINTS levels. */
+    void pushFrame(const std::vector<float>& levelsDb);
+
+    const std::vector<Column>& getColumns() const noexcept { return columns_; }
+
+private:
+    // The points from firstPoint to lastPoint fall in the column.
+    struct ColumnRange {
+        size_t firstPoint{0};
+        size_t lastPoint{0};
+    };
+
+    void update();
+    void smooth();
+
+    std::vector<float> previousDb_;
+    std::vector<float> blendedDb_;
+    std::vector<float> smoothedDb_;
+    std::vector<double> powerSums_;
+    bool hasFrame_{false};
+
+    juce::Rectangle<float> bounds_;
+    std::vector<ColumnRange> ranges_;
+    std::vector<Column> columns_;
+
+    Smoothing smoothing_{Smoothing::none};
+    size_t smoothingHalfWidth_{0};
+};
+}  // namespace parametric_eq
@@ -3,13 +3,34 @@
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <cmath>
-
+#include <type_traits>
+
+// Keeps the last getCapacity() samples written, for any number of readers. A block goes in, and
+// comes out, as at most two contiguous runs on either side of the wrap, each copied in bulk.
+//
+// Readers either take the most recent samples, or keep a Cursor and read the stream in order,
+// each at its own pace. A reader that falls more than the capacity behind never holds the writer
+// up; it skips the samples that were overwritten.
 class RingBuffer {
+public:
+    // Downmixed keeps only the average of the channels written, for readers that just want mono:
+    // a single channel to store, and no downmix on every read.
+    enum class Layout { perChannel, downmixed };
+
+    // A reader's place in the stream, as the count of samples written before it.
+    class Cursor {
+    private:
+        friend class RingBuffer;
+        juce::int64 position_{0};
+    };
+
 private:
     juce::AudioBuffer<float> buffer_;
     int capacity_{0};
-    int writeIndex_{0};
     int wrapMask_{0};
+    int numInputChannels_{0};
+    Layout layout_{Layout::perChannel};
+    juce::int64 numWritten_{0};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RingBuffer)
 
@@ -17,83 +38,206 @@ private:
         auto power = std::ceil(std::log2(n));
         return std::pow(2.0, power);
     }
+
+    [[nodiscard]] int getIndex(juce::int64 position) const noexcept {
+        return static_cast<int>(position & wrapMask_);
+    }
+
+    // Calls fn(index, offset, count) for the runs that make up numSamples samples from index on.
+    template <typename Function>
+    void forEachRun(int index, int numSamples, Function&& fn) const {
+        const auto firstPart = juce::jmin(numSamples, capacity_ - index);
+        fn(index, 0, firstPart);
+
+        if (numSamples > firstPart) {
+            fn(0, firstPart, numSamples - firstPart);
+        }
+    }
+
+    // Double samples are stored in float, which is all the display needs.
+    template <typename SampleType>
+    static void copySamples(float* dest, const SampleType* src, int numSamples) noexcept {
+        if constexpr (std::is_same_v<SampleType, float>) {
+            juce::FloatVectorOperations::copy(dest, src, numSamples);
+        } else {
+            for (int n = 0; n < numSamples; ++n) {
+                dest[n] = static_cast<float>(src[n]);
+            }
+        }
+    }
+
+    template <typename SampleType>
+    static void addSamples(float* dest, const SampleType* src, float gain, bool accumulate, int numSamples) noexcept {
+        if constexpr (std::is_same_v<SampleType, float>) {
+            if (accumulate) {
+                juce::FloatVectorOperations::addWithMultiply(dest, src, gain, numSamples);
+            } else {
+                juce::FloatVectorOperations::copyWithMultiply(dest, src, gain, numSamples);
+            }
+        } else {
+            for (int n = 0; n < numSamples; ++n) {
+                dest[n] = (accumulate ? dest[n] : 0.0f) + gain * static_cast<float>(src[n]);
+            }
+        }
+    }
+
+    // The first sample a cursor can still read.
+    [[nodiscard]] juce::int64 getReadPosition(const Cursor& cursor) const noexcept {
+        return juce::jlimit(numWritten_ - capacity_, numWritten_, cursor.position_);
+    }
+
+    void copyFrom(juce::int64 position, int channel, float* dest, int numSamples) const noexcept {
+        jassert(numSamples <= capacity_);
+        jassert(channel >= 0 && channel < buffer_.getNumChannels());
+
+        const auto* src = buffer_.getReadPointer(channel);
+
+        forEachRun(getIndex(position), numSamples, [src, dest](int index, int offset, int count) {
+            juce::FloatVectorOperations::copy(dest + offset, src + index, count);
+        });
+    }
+
+    void downmixFrom(juce::int64 position, float* dest, int numSamples) const noexcept {
+        jassert(numSamples <= capacity_);
+
+        const auto numChannels = buffer_.getNumChannels();
+        if (numChannels == 1) {
+            copyFrom(position, 0, dest, numSamples);
+            return;
+        }
+
+        const auto gain = 1.0f / static_cast<float>(numChannels);
+
+        forEachRun(getIndex(position), numSamples, [this, dest, gain, numChannels](int index, int offset, int count) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                addSamples(dest + offset, buffer_.getReadPointer(ch, index), gain, ch > 0, count);
+            }
+        });
+    }
+
 public:
     RingBuffer() = default;
-    RingBuffer(int capacity, int numChannels) {
-        reset(capacity, numChannels);
+    RingBuffer(int capacity, int numChannels, Layout layout = Layout::perChannel) {
+        reset(capacity, numChannels, layout);
     }
 
     ~RingBuffer() = default;
 
-    void reset(int capacity, int numChannels) {
+    /** Cursors stay valid, and read silence for the samples dropped here. */
+    void reset(int capacity, int numChannels, Layout layout = Layout::perChannel) {
         capacity_ = static_cast<int>(getPowerOfTwo(capacity));
-        buffer_.setSize(numChannels, capacity_);
+        numInputChannels_ = numChannels;
+        layout_ = layout;
+        buffer_.setSize(layout == Layout::downmixed ? 1 : numChannels, capacity_);
         wrapMask_ = capacity_ - 1;
         clear();
     }
 
     void clear() {
         buffer_.clear();
-        writeIndex_ = 0;
     }
 
     [[nodiscard]] int getCapacity() const noexcept { return capacity_; }
+    /** The channels stored, which is one when downmixed. */
     [[nodiscard]] int getNumChannels() const noexcept { return buffer_.getNumChannels(); }
+    [[nodiscard]] bool isDownmixed() const noexcept { return layout_ == Layout::downmixed; }
 
     void writeFrame(const float* samples, int numChannels) {
-        jassert(numChannels == buffer_.getNumChannels());
-        for (int ch = 0; ch < numChannels; ++ch) {
-            buffer_.setSample(ch, writeIndex_, samples[ch]);
+        jassert(numChannels == numInputChannels_);
+        const auto index = getIndex(numWritten_);
+
+        if (isDownmixed()) {
+            auto sum = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch) {
+                sum += samples[ch];
+            }
+            buffer_.setSample(0, index, sum / static_cast<float>(numChannels));
+        } else {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                buffer_.setSample(ch, index, samples[ch]);
+            }
         }
-        writeIndex_ = (writeIndex_ + 1) & wrapMask_;
+
+        ++numWritten_;
     }
 
-    void writeBlock(const juce::AudioBuffer<float>& src) {
-        const auto numChannels = juce::jmin(src.getNumChannels(), buffer_.getNumChannels());
-        const auto numSamples  = src.getNumSamples();
-        std::vector<float> frame(static_cast<size_t>(numChannels));
+    // Never allocates, so it is safe on the audio thread. Of a block longer than the capacity only
+    // the end is kept. Channels missing from the block are left as they were.
+    template <typename SampleType>
+    void writeBlock(const juce::AudioBuffer<SampleType>& src) {
+        const auto numSamples = src.getNumSamples();
+        if (numSamples == 0) {
+            return;
+        }
+
+        const auto skipped = juce::jmax(0, numSamples - capacity_);
+        const auto index = getIndex(numWritten_ + skipped);
+
+        if (isDownmixed()) {
+            const auto numChannels = src.getNumChannels();
+            const auto gain = 1.0f / static_cast<float>(juce::jmax(1, numChannels));
+            auto* out = buffer_.getWritePointer(0);
+
+            forEachRun(index, numSamples - skipped, [&](int start, int offset, int count) {
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    addSamples(out + start, src.getReadPointer(ch, skipped + offset), gain, ch > 0, count);
+                }
+            });
+        } else {
+            const auto numChannels = juce::jmin(src.getNumChannels(), buffer_.getNumChannels());
 
-        for (int n = 0; n < numSamples; ++n) {
             for (int ch = 0; ch < numChannels; ++ch) {
-                frame[static_cast<uint8_t>(ch)] = src.getReadPointer(ch)[n];
+                const auto* in = src.getReadPointer(ch, skipped);
+                auto* out = buffer_.getWritePointer(ch);
+
+                forEachRun(index, numSamples - skipped, [in, out](int start, int offset, int count) {
+                    copySamples(out + start, in + offset, count);
+                });
             }
-            writeFrame(frame.data(), numChannels);
         }
+
+        numWritten_ += numSamples;
     }
 
     [[nodiscard]] float readSampleAtDelay(int channel, int delayInSamples) const {
-        int idx = writeIndex_ - 1 - delayInSamples;
-        idx &= wrapMask_; 
-        return buffer_.getSample(channel, idx);
+        return buffer_.getSample(channel, getIndex(numWritten_ - 1 - delayInSamples));
     }
 
     void copyMostRecentBlock(int channel, float* dest, int numSamples) const {
-        jassert(numSamples <= capacity_);
-        jassert(channel >= 0 && channel < buffer_.getNumChannels());
+        copyFrom(numWritten_ - numSamples, channel, dest, numSamples);
+    }
 
-        const auto* src = buffer_.getReadPointer(channel);
+    void copyMostRecentSamplesMono(float* dest, int numSamples) const {
+        downmixFrom(numWritten_ - numSamples, dest, numSamples);
+    }
 
-        auto startIdx = (writeIndex_ - numSamples) & wrapMask_;
-        auto firstPart = static_cast<size_t>(juce::jmin(numSamples, capacity_ - startIdx));
-        auto secondPart = static_cast<size_t>(numSamples) - firstPart;
+    // Cursors.
+    /** A cursor past the newest sample, so that it reads only what is written from now on, or
+        numSamplesBack before it, at most the capacity, so that those are read first. */
+    [[nodiscard]] Cursor createCursor(int numSamplesBack = 0) const noexcept {
+        Cursor cursor;
+        cursor.position_ = numWritten_ - juce::jlimit(0, capacity_, numSamplesBack);
+        return cursor;
+    }
 
-        std::memcpy(dest, src + startIdx, sizeof(float) * firstPart);
+    /** Samples the cursor has yet to read, at most the capacity. */
+    [[nodiscard]] int getNumReady(const Cursor& cursor) const noexcept {
+        return static_cast<int>(numWritten_ - getReadPosition(cursor));
+    }
 
-        if (secondPart > 0) {
-            std::memcpy(dest + firstPart, src, sizeof(float) * secondPart);
-        }
+    /** Copies the oldest numSamples the cursor has yet to read, without moving it on. */
+    void copyFromCursor(const Cursor& cursor, int channel, float* dest, int numSamples) const {
+        jassert(numSamples <= getNumReady(cursor));
+        copyFrom(getReadPosition(cursor), channel, dest, numSamples);
     }
 
-    void copyMostRecentSamplesMono(float* dest, int numSamples) const {
-        jassert(numSamples <= capacity_);
-        const auto numChannels = buffer_.getNumChannels();
-        for (int n = 0; n < numSamples; ++n) {
-            auto idx = (writeIndex_ - numSamples + n) & wrapMask_;
-            auto sum = 0.0f;
-            for (int ch = 0; ch < numChannels; ++ch) {
-                sum += buffer_.getSample(ch, idx);
-            }
-            dest[n] = sum / static_cast<float>(numChannels);
-        }
+    void copyFromCursorMono(const Cursor& cursor, float* dest, int numSamples) const {
+        jassert(numSamples <= getNumReady(cursor));
+        downmixFrom(getReadPosition(cursor), dest, numSamples);
+    }
+
+    /** Moves the cursor on by numSamples, or to the newest sample if fewer are ready. */
+    void advance(Cursor& cursor, int numSamples) const noexcept {
+        cursor.position_ = juce::jmin(getReadPosition(cursor) + numSamples, numWritten_);
     }
 };
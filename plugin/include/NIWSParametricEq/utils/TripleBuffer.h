@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one writer thread to one reader thread without locks, and without
+// either of them waiting on the other. Of the three slots the writer owns one and the reader
+// another; the third is the one in between, swapped for the writer's on publish() and for the
+// reader's on update(). The reader never sees a slot the writer is still filling, and only
+// misses the values that a newer one replaced before it looked.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    /** Sets every slot to the same value. Not thread-safe: call it before either side starts. */
+    void fill(const T& value) {
+        slots_.fill(value);
+        writeIndex_ = 0;
+        middle_.store(1, std::memory_order_relaxed);
+        readIndex_ = 2;
+    }
+
+    // Writer.
+    T& getWriteBuffer() noexcept { return slots_[writeIndex_]; }
+
+    /** Makes what was written the newest value, and moves on to another slot to write. */
+    void publish() noexcept {
+        const auto previous = middle_.exchange(static_cast<uint8_t>(writeIndex_ | NEW_VALUE), std::memory_order_acq_rel);
+        writeIndex_ = static_cast<uint8_t>(previous & INDEX_MASK);
+    }
+
+    // Reader.
+    /** Takes the newest value, if one was published since the last call, and says whether it did. */
+    bool update() noexcept {
+        if ((middle_.load(std::memory_order_relaxed) & NEW_VALUE) == 0) {
+            return false;
+        }
+
+        readIndex_ = static_cast<uint8_t>(middle_.exchange(readIndex_, std::memory_order_acq_rel) & INDEX_MASK);
+        return true;
+    }
+
+    const T& getReadBuffer() const noexcept { return slots_[readIndex_]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t NEW_VALUE = 0x4;
+
+    std::array<T, 3> slots_{};
+    uint8_t writeIndex_{0};
+    std::atomic<uint8_t> middle_{1};
+    uint8_t readIndex_{2};
+};
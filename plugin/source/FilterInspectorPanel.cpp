@@ -195,6 +195,7 @@ FilterInspectorPanel::FilterInspectorPanel() {
     addField(qField_);
     addField(slopeField_);
     addField(bypassField_);
+    addField(steepField_);
     addField(gainField_);
     addField(lfoEnabledField_);
     addField(lfoRateField_);
@@ -250,11 +251,12 @@ void FilterInspectorPanel::resized() {
     hintLabel_.setBounds(bounds.removeFromTop(16));
     bounds.removeFromTop(6);
 
-    std::array<juce::Component*, 10> fields {
+    std::array<juce::Component*, 11> fields {
         &frequencyField_,
         &qField_,
         &slopeField_,
         &bypassField_,
+        &steepField_,
         &gainField_,
         &lfoEnabledField_,
         &lfoRateField_,
@@ -303,6 +305,7 @@ void FilterInspectorPanel::refreshFields() {
         qField_.unbind();
         slopeField_.unbind();
         bypassField_.unbind();
+        steepField_.unbind();
         gainField_.unbind();
         lfoEnabledField_.unbind();
         lfoRateField_.unbind();
@@ -328,6 +331,10 @@ void FilterInspectorPanel::refreshFields() {
     slopeField_.bind(selection_.base->slope);
     bypassField_.bind(selection_.base->bypassed);
 
+    if (selection_.steep != nullptr) {
+        steepField_.bind(*selection_.steep);
+    }
+
     if (selection_.gain != nullptr) {
         gainField_.bind(*selection_.gain);
     }
@@ -47,11 +47,28 @@ struct SerializableBoostCutParameters {
   }
 };
 
+struct SerializablePeak {
+  int index = 0;
+  SerializableBoostCutParameters parameters;
+
+  static constexpr int marshallingVersion = 1;
+
+  template <typename Archive, typename T>
+  static void serialise(Archive& archive, T& t) {
+    using namespace juce;
+    archive(named("index", t.index),
+            named("parameters", t.parameters));
+  }
+};
+
 struct SerializableParameters {
   bool bypassed = false;
   bool isPost = false;
 
-  std::array<SerializableBoostCutParameters, ParametricEq::NUM_PEAKS> peakFilters{};
+  // Up to version 4 there were always the four default peaks. Since version 5 only the enabled
+  // peaks of the pool are stored, with their index; the four old ones are read in as such.
+  std::array<SerializableBoostCutParameters, ParametricEq::DEFAULT_NUM_PEAKS> peakFilters{};
+  std::vector<SerializablePeak> peaks;
 
   SerializableBoostCutParameters lowShelf{};
   SerializableBoostCutParameters highShelf{};
@@ -59,13 +76,21 @@ struct SerializableParameters {
   SerializableBaseParameters lowPass{};
   SerializableBaseParameters highPass{};
 
-  static constexpr int marshallingVersion = 1;
+  bool lowPassSteep = false;
+  bool highPassSteep = false;
+
+  juce::String oversampling = "Off";
+  bool linearPhase = false;
+
+  juce::String analyzerSmoothing = "Off";
+
+  static constexpr int marshallingVersion = 6;
 
   template <typename Archive, typename T>
   static void serialise(Archive& archive, T& t) {
     using namespace juce;
 
-    if (archive.getVersion() != marshallingVersion) {
+    if (archive.getVersion() < 1 || archive.getVersion() > marshallingVersion) {
       return;
     }
 
@@ -79,12 +104,40 @@ struct SerializableParameters {
       named("bypassed", t.bypassed),
       named("isPost", t.isPost),
 
-      named("peakFilters", t.peakFilters),
       named("lowShelf", t.lowShelf),
       named("highShelf", t.highShelf),
       named("lowPass", t.lowPass),
       named("highPass", t.highPass)
     );
+
+    if (archive.getVersion() >= 5) {
+      archive(named("peaks", t.peaks));
+    } else {
+      archive(named("peakFilters", t.peakFilters));
+
+      if constexpr (!std::is_const_v<T>) {
+        for (size_t i = 0; i < t.peakFilters.size(); ++i) {
+          t.peaks.push_back({static_cast<int>(i), t.peakFilters[i]});
+        }
+      }
+    }
+
+    if (archive.getVersion() >= 2) {
+      archive(named("lowPassSteep", t.lowPassSteep),
+              named("highPassSteep", t.highPassSteep));
+    }
+
+    if (archive.getVersion() >= 3) {
+      archive(named("oversampling", t.oversampling));
+    }
+
+    if (archive.getVersion() >= 4) {
+      archive(named("linearPhase", t.linearPhase));
+    }
+
+    if (archive.getVersion() >= 6) {
+      archive(named("analyzerSmoothing", t.analyzerSmoothing));
+    }
   }
 };
 
@@ -114,8 +167,10 @@ static SerializableParameters from(const parametric_eq::Parameters& parameters)
   out.bypassed = parameters.bypassed.get();
   out.isPost = parameters.isPost.get();
 
-  for (size_t i = 0; i < ParametricEq::NUM_PEAKS; ++i) {
-    out.peakFilters[i] = from(*parameters.peakFilters[i]);
+  for (size_t i = 0; i < ParametricEq::MAX_PEAKS; ++i) {
+    if (parameters.peakEnabled[i]->get()) {
+      out.peaks.push_back({static_cast<int>(i), from(*parameters.peakFilters[i])});
+    }
   }
 
   out.lowShelf = from(parameters.lowShelfParameters);
@@ -124,6 +179,14 @@ static SerializableParameters from(const parametric_eq::Parameters& parameters)
   out.lowPass = from(parameters.lowPassParameters);
   out.highPass = from(parameters.highPassParameters);
 
+  out.lowPassSteep = parameters.lowPassSteep.get();
+  out.highPassSteep = parameters.highPassSteep.get();
+
+  out.oversampling = parameters.oversampling.getCurrentChoiceName();
+  out.linearPhase = parameters.linearPhase.get();
+
+  out.analyzerSmoothing = parameters.analyzerSmoothing->getCurrentChoiceName();
+
   return out;
 }
 
@@ -191,8 +254,19 @@ juce::Result JsonSerializer::deserialize(juce::InputStream& input, Parameters& p
   parameters.bypassed = parsed->bypassed;
   parameters.isPost = parsed->isPost;
 
-  for (size_t i = 0; i < ParametricEq::NUM_PEAKS; ++i) {
-    apply(*parameters.peakFilters[i], parsed->peakFilters[i]);
+  // Peaks that were not stored were not in use; they keep their parameters but are disabled.
+  for (size_t i = 0; i < ParametricEq::MAX_PEAKS; ++i) {
+    *parameters.peakEnabled[i] = false;
+  }
+
+  for (const auto& peak : parsed->peaks) {
+    if (peak.index < 0 || static_cast<size_t>(peak.index) >= ParametricEq::MAX_PEAKS) {
+      continue;
+    }
+
+    const auto i = static_cast<size_t>(peak.index);
+    *parameters.peakEnabled[i] = true;
+    apply(*parameters.peakFilters[i], peak.parameters);
   }
 
   apply(parameters.lowShelfParameters, parsed->lowShelf);
@@ -201,6 +275,16 @@ juce::Result JsonSerializer::deserialize(juce::InputStream& input, Parameters& p
   apply(parameters.lowPassParameters,  parsed->lowPass);
   apply(parameters.highPassParameters, parsed->highPass);
 
+  parameters.lowPassSteep = parsed->lowPassSteep;
+  parameters.highPassSteep = parsed->highPassSteep;
+
+  parameters.oversampling =
+      choiceNameToIndex(parameters.oversampling.choices, parsed->oversampling, 0);
+  parameters.linearPhase = parsed->linearPhase;
+
+  *parameters.analyzerSmoothing =
+      choiceNameToIndex(parameters.analyzerSmoothing->choices, parsed->analyzerSmoothing, 0);
+
   return juce::Result::ok();
 }
 
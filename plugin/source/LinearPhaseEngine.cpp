@@ -0,0 +1,517 @@
+#include "NIWSParametricEq/LinearPhaseEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace parametric_eq {
+namespace {
+// acc += x * h over numBins interleaved complex bins.
+void multiplyAccumulate(float* acc, const float* x, const float* h, size_t numBins) noexcept {
+    for (size_t k = 0; k < 2 * numBins; k += 2) {
+        acc[k] += x[k] * h[k] - x[k + 1] * h[k + 1];
+        acc[k + 1] += x[k] * h[k + 1] + x[k + 1] * h[k];
+    }
+}
+
+// Moves output from previous towards itself, numSamples into a linear fade of fadeLength samples
+// that is fadePosition samples in.
+void crossfade(float* output, const float* previous, size_t numSamples, juce::int64 fadePosition,
+               size_t fadeLength) noexcept {
+    for (size_t i = 0; i < numSamples; ++i) {
+        const auto gain = static_cast<float>(fadePosition + static_cast<juce::int64>(i) + 1)
+            / static_cast<float>(fadeLength);
+        output[i] = previous[i] + gain * (output[i] - previous[i]);
+    }
+}
+
+bool haveEqualCoefficients(const BiquadFilter::Coefficients& a, const BiquadFilter::Coefficients& b) noexcept {
+    return juce::exactlyEqual(a.b0, b.b0) && juce::exactlyEqual(a.b1, b.b1) && juce::exactlyEqual(a.b2, b.b2)
+        && juce::exactlyEqual(a.a1, b.a1) && juce::exactlyEqual(a.a2, b.a2);
+}
+} // namespace
+
+void UniformConvolution::prepare(int partitionOrder, size_t numPartitions, int numChannels) {
+    if (fft_ == nullptr || fft_->getSize() != 2 << partitionOrder) {
+        fft_ = std::make_unique<juce::dsp::FFT>(partitionOrder + 1);
+    }
+
+    partitionSize_ = 1 << partitionOrder;
+    numPartitions_ = numPartitions;
+    numChannels_ = static_cast<size_t>(numChannels);
+
+    const auto size = static_cast<size_t>(partitionSize_);
+    inputs_.assign(numChannels_ * 2 * size, 0.0f);
+    delayLine_.assign(numChannels_ * getKernelSize(), 0.0f);
+    fftBuffer_.assign(4 * size, 0.0f);
+    delayLineHead_ = 0;
+}
+
+void UniformConvolution::reset() noexcept {
+    std::fill(inputs_.begin(), inputs_.end(), 0.0f);
+    std::fill(delayLine_.begin(), delayLine_.end(), 0.0f);
+    delayLineHead_ = 0;
+}
+
+void UniformConvolution::transformKernel(const juce::dsp::FFT& fft, const float* taps, float* kernel,
+                                         float* scratch) const noexcept {
+    const auto size = static_cast<size_t>(partitionSize_);
+
+    for (size_t m = 0; m < numPartitions_; ++m) {
+        std::fill_n(scratch, 4 * size, 0.0f);
+        std::copy_n(taps + m * size, size, scratch);
+        fft.performRealOnlyForwardTransform(scratch, true);
+        std::copy_n(scratch, getSpectrumSize(), kernel + m * getSpectrumSize());
+    }
+}
+
+void UniformConvolution::advance() noexcept {
+    delayLineHead_ = (delayLineHead_ + numPartitions_ - 1) % numPartitions_;
+}
+
+void UniformConvolution::pushInput(size_t channel, const float* partition) noexcept {
+    const auto size = static_cast<size_t>(partitionSize_);
+    auto* input = inputs_.data() + channel * 2 * size;
+
+    std::copy_n(partition, size, input + size);
+    std::copy_n(input, 2 * size, fftBuffer_.data());
+    fft_->performRealOnlyForwardTransform(fftBuffer_.data(), true);
+    std::copy_n(fftBuffer_.data(), getSpectrumSize(),
+                delayLine_.data() + (channel * numPartitions_ + delayLineHead_) * getSpectrumSize());
+
+    // The newest half of the input is the older half of the next partition's.
+    std::copy_n(input + size, size, input);
+}
+
+void UniformConvolution::convolve(const float* kernel, size_t channel, float* output) noexcept {
+    std::fill_n(fftBuffer_.data(), getSpectrumSize(), 0.0f);
+
+    for (size_t m = 0; m < numPartitions_; ++m) {
+        const auto slot = channel * numPartitions_ + (delayLineHead_ + m) % numPartitions_;
+        multiplyAccumulate(fftBuffer_.data(), delayLine_.data() + slot * getSpectrumSize(),
+                           kernel + m * getSpectrumSize(), static_cast<size_t>(partitionSize_) + 1);
+    }
+
+    fft_->performRealOnlyInverseTransform(fftBuffer_.data());
+
+    // Overlap-save: of the circular convolution, only the second half is free of wrap-around.
+    std::copy_n(fftBuffer_.data() + partitionSize_, partitionSize_, output);
+}
+
+bool LinearPhaseEngine::Response::operator==(const Response& other) const noexcept {
+    if (numSections != other.numSections) {
+        return false;
+    }
+
+    return std::equal(sections.begin(), std::next(sections.begin(), static_cast<std::ptrdiff_t>(numSections)),
+                      other.sections.begin(), haveEqualCoefficients);
+}
+
+LinearPhaseEngine::LinearPhaseEngine(int kernelOrder)
+    : kernelOrder_(kernelOrder),
+      kernelSize_(1 << kernelOrder),
+      designFft_(kernelOrder),
+      designBuffer_(2 * static_cast<size_t>(kernelSize_), 0.0f),
+      window_(static_cast<size_t>(kernelSize_)) {
+    // The tail partitions need a head of at least two of them, of at least two head partitions.
+    jassert(kernelOrder >= MAX_HEAD_ORDER + 3);
+
+    // A periodic Blackman window, symmetric about the centre tap like the kernel, and zero at
+    // tap 0, the one tap without a mirror image.
+    const auto N = static_cast<double>(kernelSize_);
+    for (size_t n = 0; n < window_.size(); ++n) {
+        const auto phase = 2.0 * std::numbers::pi * static_cast<double>(n) / N;
+        window_[n] = static_cast<float>(0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+    }
+}
+
+LinearPhaseEngine::~LinearPhaseEngine() {
+    designThread_.stop();
+    tailThread_.stop();
+}
+
+void LinearPhaseEngine::setHeadOrder(int order) {
+    jassert(order >= MIN_HEAD_ORDER && order <= MAX_HEAD_ORDER);
+    nextHeadOrder_ = juce::jlimit(MIN_HEAD_ORDER, MAX_HEAD_ORDER, order);
+}
+
+int LinearPhaseEngine::getTailOrder() const noexcept {
+    return juce::jmin(headOrder_ + TAIL_ORDER_STEP, kernelOrder_ - 2);
+}
+
+// Both threads are stopped while the buffers they work on are resized, and the kernels are
+// redesigned for a new partitioning. Otherwise the worker is idle once the jobs are cancelled,
+// and this only resets.
+void LinearPhaseEngine::prepare(int numChannels) {
+    cancelTailJobs();
+
+    const auto isRepartitioned = headSize_ == 0 || nextHeadOrder_ != headOrder_;
+
+    if (isRepartitioned || numChannels != numChannels_) {
+        designThread_.stop();
+        tailThread_.stop();
+    }
+
+    const auto wasPrepared = headSize_ != 0;
+    headOrder_ = nextHeadOrder_;
+    numChannels_ = numChannels;
+    headSize_ = static_cast<size_t>(getHeadPartitionSize());
+    tailSize_ = static_cast<size_t>(getTailPartitionSize());
+
+    const auto headLength = 2 * tailSize_;
+    const auto channels = static_cast<size_t>(numChannels_);
+    head_.prepare(headOrder_, headLength / headSize_, numChannels_);
+    tail_.prepare(getTailOrder(), (static_cast<size_t>(kernelSize_) - headLength) / tailSize_, numChannels_);
+
+    inputs_.assign(channels * headSize_, 0.0f);
+    outputs_.assign(channels * headSize_, 0.0f);
+    fadeBuffer_.assign(headSize_, 0.0f);
+    tailInputs_.assign(channels * tailSize_, 0.0f);
+    tailOutputs_.assign(channels * tailSize_, 0.0f);
+    tailFadeBuffer_.assign(tailSize_, 0.0f);
+
+    for (auto& job : tailJobs_) {
+        job.input.assign(channels * tailSize_, 0.0f);
+        job.output.assign(channels * tailSize_, 0.0f);
+    }
+
+    if (isRepartitioned) {
+        headDesignFft_ = std::make_unique<juce::dsp::FFT>(headOrder_ + 1);
+        tailDesignFft_ = std::make_unique<juce::dsp::FFT>(getTailOrder() + 1);
+        designPartitionBuffer_.assign(4 * tailSize_, 0.0f);
+
+        for (auto& kernel : kernels_) {
+            kernel.head.assign(head_.getKernelSize(), 0.0f);
+            kernel.tail.assign(tail_.getKernelSize(), 0.0f);
+        }
+
+        // Until the first design is in, the kernel is a unit impulse at its centre: a pure delay.
+        auto* taps = designBuffer_.data() + kernelSize_;
+        std::fill_n(taps, kernelSize_, 0.0f);
+        taps[kernelSize_ / 2] = 1.0f;
+        transformKernel(kernels_[0]);
+
+        activeKernel_ = 0;
+        isFading_ = false;
+        kernelState_ = KernelState::idle;
+
+        // A response that was already rendered has to be designed again for the new partitions.
+        responseUnsent_ = wasPrepared;
+    }
+
+    reset();
+
+    if (!designThread_.isThreadRunning()) {
+        designThread_.startThread();
+    }
+
+    if (!tailThread_.isThreadRunning()) {
+        tailThread_.startThread(juce::Thread::Priority::high);
+    }
+}
+
+void LinearPhaseEngine::reset() noexcept {
+    cancelTailJobs();
+
+    head_.reset();
+    tail_.reset();
+    std::fill(inputs_.begin(), inputs_.end(), 0.0f);
+    std::fill(outputs_.begin(), outputs_.end(), 0.0f);
+    std::fill(tailInputs_.begin(), tailInputs_.end(), 0.0f);
+    std::fill(tailOutputs_.begin(), tailOutputs_.end(), 0.0f);
+    fifoPosition_ = 0;
+    tailInputPosition_ = 0;
+    tailOutputPosition_ = 0;
+    outputPosition_ = 0;
+
+    // Without the input it was fading over, the new kernel takes over at once.
+    if (isFading_) {
+        finishFade();
+    }
+}
+
+// The response is only handed over when it changed, and never waits for the design thread: when
+// that is busy copying the previous one, the handover is retried on the next block.
+void LinearPhaseEngine::setResponse(const Response& response) noexcept {
+    if (!responseUnsent_ && response == lastResponse_) {
+        return;
+    }
+
+    lastResponse_ = response;
+
+    const juce::SpinLock::ScopedTryLockType lock(responseLock_);
+    responseUnsent_ = !lock.isLocked();
+    if (responseUnsent_) {
+        return;
+    }
+
+    pendingResponse_ = response;
+    responsePending_ = true;
+    designThread_.wake();
+}
+
+bool LinearPhaseEngine::isUpdatingKernel() const noexcept {
+    return responseUnsent_ || responsePending_ || designing_ || kernelState_ != KernelState::idle;
+}
+
+void LinearPhaseEngine::processBlock(juce::AudioBuffer<float>& buffer) noexcept {
+    const auto numChannels = static_cast<size_t>(juce::jmin(buffer.getNumChannels(), numChannels_));
+    const auto numSamples = buffer.getNumSamples();
+    const auto headSize = static_cast<int>(headSize_);
+
+    for (int n = 0; n < numSamples;) {
+        const auto count = juce::jmin(numSamples - n, headSize - fifoPosition_);
+
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            auto* samples = buffer.getWritePointer(static_cast<int>(ch), n);
+            const auto position = ch * headSize_ + static_cast<size_t>(fifoPosition_);
+            std::copy_n(samples, count, inputs_.data() + position);
+            std::copy_n(outputs_.data() + position, count, samples);
+        }
+
+        fifoPosition_ += count;
+        n += count;
+
+        if (fifoPosition_ == headSize) {
+            processPartition();
+            fifoPosition_ = 0;
+        }
+    }
+}
+
+// Each call makes the head partition of output that starts at outputPosition_. The tail job that
+// covers it was handed over one tail partition ago, and is collected as the first head partition
+// of its output comes up.
+void LinearPhaseEngine::processPartition() noexcept {
+    if (numTailJobsInFlight_ == 2) {
+        collectTailJob();
+    }
+
+    const auto fadePosition = outputPosition_ - fadeStart_;
+    const auto isCrossfading = isFading_ && fadePosition >= 0;
+    const auto kernel = isFading_ && fadePosition < 0 ? 1 - activeKernel_ : activeKernel_;
+
+    head_.advance();
+
+    for (size_t ch = 0; ch < static_cast<size_t>(numChannels_); ++ch) {
+        const auto* input = inputs_.data() + ch * headSize_;
+        head_.pushInput(ch, input);
+        std::copy_n(input, headSize_, tailInputs_.data() + ch * tailSize_ + tailInputPosition_);
+
+        auto* output = outputs_.data() + ch * headSize_;
+        head_.convolve(kernels_[kernel].head.data(), ch, output);
+
+        if (isCrossfading) {
+            head_.convolve(kernels_[1 - activeKernel_].head.data(), ch, fadeBuffer_.data());
+            crossfade(output, fadeBuffer_.data(), headSize_, fadePosition, tailSize_);
+        }
+
+        if (tailOutputPosition_ < tailSize_) {
+            juce::FloatVectorOperations::add(output, tailOutputs_.data() + ch * tailSize_ + tailOutputPosition_,
+                                             static_cast<int>(headSize_));
+        }
+    }
+
+    outputPosition_ += static_cast<juce::int64>(headSize_);
+    tailOutputPosition_ += headSize_;
+
+    if (isCrossfading && fadePosition + static_cast<juce::int64>(headSize_) >= static_cast<juce::int64>(tailSize_)) {
+        finishFade();
+    }
+
+    tailInputPosition_ += headSize_;
+    if (tailInputPosition_ == tailSize_) {
+        submitTailJob();
+        tailInputPosition_ = 0;
+    }
+}
+
+// A ready kernel is picked up here, so that its crossfade starts exactly where this job's output
+// does. The head keeps rendering the old kernel until then.
+void LinearPhaseEngine::submitTailJob() noexcept {
+    auto fadesIn = false;
+
+    if (!isFading_ && kernelState_.load(std::memory_order_acquire) == KernelState::ready) {
+        activeKernel_ = 1 - activeKernel_;
+        kernelState_.store(KernelState::fading, std::memory_order_relaxed);
+        isFading_ = true;
+        fadeStart_ = outputPosition_ + static_cast<juce::int64>(tailSize_);
+        fadesIn = true;
+    }
+
+    auto& job = getTailJob(numTailJobsSubmitted_);
+    std::copy(tailInputs_.begin(), tailInputs_.end(), job.input.begin());
+    job.kernel = activeKernel_;
+    job.fadesIn = fadesIn;
+    job.index.store(numTailJobsSubmitted_, std::memory_order_relaxed);
+    job.state.store(TailJobState::pending, std::memory_order_release);
+
+    ++numTailJobsSubmitted_;
+    ++numTailJobsInFlight_;
+    tailThread_.wake();
+}
+
+// Deadline: the oldest job is due. It is computed here if the worker has not started it yet, and
+// waited for if the worker is on it. That wait spins on the audio thread for as long as the rest
+// of the job takes, up to a whole tail partition's convolution when the worker only took the job
+// just before it fell due. It takes no lock, but it is the one place the audio thread waits on
+// the worker.
+void LinearPhaseEngine::collectTailJob() noexcept {
+    const auto index = numTailJobsSubmitted_ - numTailJobsInFlight_;
+    auto& job = getTailJob(index);
+
+    for (;;) {
+        auto expected = TailJobState::pending;
+        if (job.state.compare_exchange_strong(expected, TailJobState::running, std::memory_order_acquire)) {
+            computeTailJob(job);
+            finishTailJob(job, index);
+            tailThread_.wake();
+            break;
+        }
+
+        if (expected == TailJobState::done) {
+            break;
+        }
+
+        juce::Thread::yield();
+    }
+
+    std::copy(job.output.begin(), job.output.end(), tailOutputs_.begin());
+    tailOutputPosition_ = 0;
+    --numTailJobsInFlight_;
+}
+
+// The worker runs the jobs in order, which the tail's delay line relies on: a job is only taken
+// once the one before it has completed, whoever computed that one.
+void LinearPhaseEngine::computeTailJobs() {
+    while (!tailThread_.threadShouldExit()) {
+        const auto wakeups = tailThread_.getWakeups();
+        const auto index = numTailJobsCompleted_.load(std::memory_order_acquire);
+        auto& job = getTailJob(index);
+
+        auto expected = TailJobState::pending;
+        if (!job.state.compare_exchange_strong(expected, TailJobState::running, std::memory_order_acquire)) {
+            tailThread_.sleep(wakeups);
+            continue;
+        }
+
+        // The count was stale, and this is a later job sharing the slot: put it back.
+        if (job.index.load(std::memory_order_relaxed) != index) {
+            job.state.store(TailJobState::pending, std::memory_order_release);
+            continue;
+        }
+
+        computeTailJob(job);
+        finishTailJob(job, index);
+    }
+}
+
+void LinearPhaseEngine::computeTailJob(TailJob& job) noexcept {
+    tail_.advance();
+
+    for (size_t ch = 0; ch < static_cast<size_t>(numChannels_); ++ch) {
+        tail_.pushInput(ch, job.input.data() + ch * tailSize_);
+    }
+
+    for (size_t ch = 0; ch < static_cast<size_t>(numChannels_); ++ch) {
+        auto* output = job.output.data() + ch * tailSize_;
+        tail_.convolve(kernels_[job.kernel].tail.data(), ch, output);
+
+        if (job.fadesIn) {
+            tail_.convolve(kernels_[1 - job.kernel].tail.data(), ch, tailFadeBuffer_.data());
+            crossfade(output, tailFadeBuffer_.data(), tailSize_, 0, tailSize_);
+        }
+    }
+}
+
+void LinearPhaseEngine::finishTailJob(TailJob& job, juce::int64 index) noexcept {
+    numTailJobsCompleted_.store(index + 1, std::memory_order_release);
+    job.state.store(TailJobState::done, std::memory_order_release);
+}
+
+void LinearPhaseEngine::finishFade() noexcept {
+    isFading_ = false;
+    kernelState_.store(KernelState::idle, std::memory_order_release);
+    designThread_.wake();
+}
+
+// Jobs in flight are dropped, or waited for when the worker is already computing one.
+void LinearPhaseEngine::cancelTailJobs() noexcept {
+    for (auto& job : tailJobs_) {
+        for (;;) {
+            auto expected = TailJobState::pending;
+            if (job.state.compare_exchange_strong(expected, TailJobState::done, std::memory_order_acquire)
+                || expected == TailJobState::done) {
+                break;
+            }
+
+            juce::Thread::yield();
+        }
+    }
+
+    numTailJobsCompleted_.store(numTailJobsSubmitted_, std::memory_order_release);
+    numTailJobsInFlight_ = 0;
+}
+
+LinearPhaseEngine::TailJob& LinearPhaseEngine::getTailJob(juce::int64 index) noexcept {
+    return tailJobs_[static_cast<size_t>(index % static_cast<juce::int64>(tailJobs_.size()))];
+}
+
+void LinearPhaseEngine::designKernels() {
+    while (!designThread_.threadShouldExit()) {
+        const auto wakeups = designThread_.getWakeups();
+        if (kernelState_.load(std::memory_order_acquire) != KernelState::idle || !responsePending_) {
+            designThread_.sleep(wakeups);
+            continue;
+        }
+
+        Response response;
+        {
+            const juce::SpinLock::ScopedLockType lock(responseLock_);
+            response = pendingResponse_;
+            designing_ = true;
+            responsePending_ = false;
+        }
+
+        designKernel(response, kernels_[1 - activeKernel_]);
+        kernelState_.store(KernelState::ready, std::memory_order_release);
+        designing_ = false;
+    }
+}
+
+// The magnitude alone is a zero-phase spectrum, whose impulse response is even about tap 0.
+// Rotating it by half the kernel centres it, and the window tapers the ends where it is cut off.
+void LinearPhaseEngine::designKernel(const Response& response, Kernel& kernel) {
+    const auto N = static_cast<size_t>(kernelSize_);
+
+    for (size_t k = 0; k <= N / 2; ++k) {
+        const auto omega = 2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(N);
+        auto magnitude = 1.0f;
+
+        for (size_t i = 0; i < response.numSections; ++i) {
+            magnitude *= BiquadFilter::getMagnitude(response.sections[i], omega);
+        }
+
+        designBuffer_[2 * k] = magnitude;
+        designBuffer_[2 * k + 1] = 0.0f;
+    }
+
+    designFft_.performRealOnlyInverseTransform(designBuffer_.data());
+
+    auto* taps = designBuffer_.data() + N;
+    for (size_t n = 0; n < N; ++n) {
+        taps[n] = designBuffer_[(n + N / 2) % N] * window_[n];
+    }
+
+    transformKernel(kernel);
+}
+
+// Splits the taps in the second half of the design buffer between the head and the tail.
+void LinearPhaseEngine::transformKernel(Kernel& kernel) {
+    const auto* taps = designBuffer_.data() + kernelSize_;
+    const auto headLength = head_.getNumPartitions() * headSize_;
+
+    head_.transformKernel(*headDesignFft_, taps, kernel.head.data(), designPartitionBuffer_.data());
+    tail_.transformKernel(*tailDesignFft_, taps + headLength, kernel.tail.data(), designPartitionBuffer_.data());
+}
+} // namespace parametric_eq
@@ -124,6 +124,26 @@ juce::AudioParameterChoice& createLfoPolarityParameter(
           juce::StringArray{"Bipolar", "Unipolar"}, 0));
 }
 
+juce::AudioParameterChoice& createOversamplingParameter(
+    juce::AudioProcessor& processor, Identifier identifier) {
+  return addParameterToProcessor(
+      processor,
+      std::make_unique<juce::AudioParameterChoice>(
+          juce::ParameterID{identifier.id, identifier.versionHint},
+          identifier.name,
+          juce::StringArray{"Off", "2x", "4x"}, 0));
+}
+
+juce::AudioParameterChoice& createAnalyzerSmoothingParameter(
+    juce::AudioProcessor& processor, Identifier identifier) {
+  return addParameterToProcessor(
+      processor,
+      std::make_unique<juce::AudioParameterChoice>(
+          juce::ParameterID{identifier.id, identifier.versionHint},
+          identifier.name,
+          juce::StringArray{"Off", "1/12 oct", "1/6 oct", "1/3 oct"}, 0));
+}
+
 LfoParameters createLfoParameters(
     juce::AudioProcessor& processor,
     const juce::String& idPrefix,
@@ -183,14 +203,15 @@ BoostCutParameters createHighShelfParameters(juce::AudioProcessor& processor) {
     return parameters;
 }
 
-std::array<std::unique_ptr<BoostCutParameters>, ParametricEq::NUM_PEAKS> createPeakFilterParameters(juce::AudioProcessor& processor) {
-    std::array<std::unique_ptr<BoostCutParameters>, ParametricEq::NUM_PEAKS> parameters{};
-    auto versionHint = 1;
-    for (size_t i = 0; i < ParametricEq::NUM_PEAKS; i++) {
+using PeakFilterParameters = std::array<std::unique_ptr<BoostCutParameters>, ParametricEq::MAX_PEAKS>;
+
+void addPeakFilterParameters(juce::AudioProcessor& processor, PeakFilterParameters& parameters, size_t begin,
+    size_t end, int versionHint) {
+    for (size_t i = begin; i < end; i++) {
         auto num = juce::String(i + 1);
         auto name = "Peak " + num + " ";
         auto id = "peak" + num;
-        auto freq = static_cast<float>(*std::next(ParametricEq::DEFAULT_FREQS.begin(), static_cast<int>(i)));
+        auto freq = static_cast<float>(ParametricEq::DEFAULT_FREQS[i]);
 
         Identifier frequencyIdentifier = {id + "Frequency", name + "Frequency", versionHint};
         Identifier qIdentifier = {id + "QFactor", name + "Q-Factor",  versionHint};
@@ -208,6 +229,12 @@ std::array<std::unique_ptr<BoostCutParameters>, ParametricEq::NUM_PEAKS> createP
         parameters[i] = std::unique_ptr<BoostCutParameters>(
             new BoostCutParameters{{frequency, q, slope, bypassed }, gain, lfo});
     }
+}
+
+// The default peaks, created where they always were so that the parameters keep their order.
+PeakFilterParameters createPeakFilterParameters(juce::AudioProcessor& processor) {
+    PeakFilterParameters parameters{};
+    addPeakFilterParameters(processor, parameters, 0, ParametricEq::DEFAULT_NUM_PEAKS, 1);
     return parameters;
 }
 
@@ -253,5 +280,20 @@ Parameters::Parameters(juce::AudioProcessor& processor)
       highShelfParameters{createHighShelfParameters(processor)},  
       lowPassParameters{createLowPassParameters(processor)},
       highPassParameters{createHighPassParameters(processor)},
-      isPost{createBypassedParameter(processor, {"isPost", "Post", 1})} {}
+      isPost{createBypassedParameter(processor, {"isPost", "Post", 1})},
+      lowPassSteep{createBoolParameter(processor, {"lowPassSteep", "Low Pass Steep", 2})},
+      highPassSteep{createBoolParameter(processor, {"highPassSteep", "High Pass Steep", 2})},
+      oversampling{createOversamplingParameter(processor, {"oversampling", "Oversampling", 3})},
+      linearPhase{createBoolParameter(processor, {"linearPhase", "Linear Phase", 4})} {
+    // The rest of the pool and the enabled switches came later and are added after everything else.
+    addPeakFilterParameters(processor, peakFilters, ParametricEq::DEFAULT_NUM_PEAKS, ParametricEq::MAX_PEAKS, 5);
+
+    for (size_t i = 0; i < ParametricEq::MAX_PEAKS; i++) {
+        auto num = juce::String(i + 1);
+        peakEnabled[i] = &createBoolParameter(
+            processor, {"peak" + num + "Enabled", "Peak " + num + " Enabled", 5}, i < ParametricEq::DEFAULT_NUM_PEAKS);
+    }
+
+    analyzerSmoothing = &createAnalyzerSmoothingParameter(processor, {"analyzerSmoothing", "Analyzer Smoothing", 6});
+}
 }  // namespace parametric_eq
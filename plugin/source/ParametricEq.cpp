@@ -12,10 +12,57 @@ static int slopeToSections(Slope s) {
     return 1;
 }
 
+// The Q of one section of a slope, as PassFilterCascade assigns it.
+static double slopeSectionQ(int numSections, size_t index, double Q) {
+    const auto butterworthQ = PassFilterCascade::getButterworthQ(numSections, juce::jmin(static_cast<int>(index), numSections - 1));
+    return index == 0 ? Q * butterworthQ / PassFilterCascade::getButterworthQ(1, 0) : butterworthQ;
+}
+
+ParametricEq::SvfSlope ParametricEq::makeSvfSlope(SvfFilter::Type type) {
+    SvfSlope slope;
+    slope.fill(SvfFilter{type});
+    return slope;
+}
+
+// Steep mode swaps the Butterworth stack for an elliptic design with half the sections (at least
+// one) that is already down by the stack's attenuation one octave past the cutoff.
+std::array<EllipticPrototype, ParametricEq::NUM_SLOPES> ParametricEq::designSteepPrototypes() {
+    constexpr double passbandRippleDb = 0.1;
+    std::array<EllipticPrototype, NUM_SLOPES> prototypes;
+
+    for (size_t i = 0; i < NUM_SLOPES; ++i) {
+        const auto numSections = slopeToSections(static_cast<Slope>(i));
+        const auto attenuationDb = 12.0 * static_cast<double>(numSections);
+        prototypes[i] = EllipticPrototype::design((numSections + 1) / 2, passbandRippleDb, attenuationDb);
+    }
+
+    return prototypes;
+}
+
 void ParametricEq::prepare(double sampleRate, int numChannels) {
     sampleRate_ = sampleRate;
     numChannels_ = numChannels;
+
+    appliedPeaks_ = enabledPeaks_.load(std::memory_order_acquire);
+    peakPool_ = appliedPeaks_;
     prepareFilters();
+
+    cascade_.prepare(numChannels_);
+    lowBandCascade_.prepare(numChannels_);
+    assignCascadeSlots();
+    slotIdle_.fill(true);
+    parallel_.prepare(numChannels_);
+
+    // Every stage count keeps a split of its own, so the change of rate that comes with a change
+    // of oversampling, made on the audio thread, only picks another one.
+    for (size_t i = 0; i < lowBandSplits_.size(); ++i) {
+        lowBandSplits_[i].prepare(static_cast<int>(i) + 1, numChannels_, latencyMultiple_);
+    }
+    multirateStages_ = getMultirateStages();
+    updateLowBandRate();
+
+    linearPhase_.prepare(numChannels_);
+    floatBuffer_.setSize(numChannels_, FLOAT_CHUNK_SIZE);
 }
 
 void ParametricEq::reset() {
@@ -26,39 +73,463 @@ void ParametricEq::reset() {
     lowShelfFilter_.reset();
     highShelfFilter_.reset();
 
-    for (auto &filter : lowPassFilters_) {
+    lowPass_.reset();
+    highPass_.reset();
+
+    cascade_.reset();
+    parallel_.reset();
+    lowBandCascade_.reset();
+    resetLowBandSplits();
+
+    for (auto &filter : svfPeaks_) {
         filter.reset();
     }
-    for (auto &filter : highPassFilters_) {
-        filter.reset();
+
+    svfLowShelf_.reset();
+    svfHighShelf_.reset();
+
+    for (auto &section : svfLowPass_) {
+        section.reset();
     }
+
+    for (auto &section : svfHighPass_) {
+        section.reset();
+    }
+
+    linearPhase_.reset();
 }
 
 void ParametricEq::processBlock(juce::AudioBuffer<float>& buffer) {
-    for (auto &filter : peakFilters_) {
-        filter.processBlock(buffer);
+    updatePeakPool();
+
+    if (engine_ == Engine::stateVariable) {
+        processStateVariableEngine(buffer);
+        settleBiquadEngine();
+        return;
+    }
+
+    if (engine_ == Engine::linearPhase) {
+        processLinearPhaseEngine(buffer);
+        return;
+    }
+
+    if (engine_ == Engine::parallel) {
+        processParallelEngine(buffer);
+        return;
+    }
+
+    processBiquadEngine(buffer);
+}
+
+// Channels beyond the ones prepared for pass through, as they do in the float engines.
+void ParametricEq::processBlock(juce::AudioBuffer<double>& buffer) {
+    if (engine_ == Engine::biquad) {
+        updatePeakPool();
+        processBiquadEngine(buffer);
+        return;
+    }
+
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), numChannels_);
+
+    for (int start = 0; start < buffer.getNumSamples(); start += FLOAT_CHUNK_SIZE) {
+        const auto numSamples = juce::jmin(FLOAT_CHUNK_SIZE, buffer.getNumSamples() - start);
+        juce::AudioBuffer<float> chunk{floatBuffer_.getArrayOfWritePointers(), numChannels, numSamples};
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const auto* source = buffer.getReadPointer(ch, start);
+            auto* destination = chunk.getWritePointer(ch);
+            std::transform(source, source + numSamples, destination, [](double x) { return static_cast<float>(x); });
+        }
+
+        processBlock(chunk);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const auto* source = chunk.getReadPointer(ch);
+            std::copy(source, source + numSamples, buffer.getWritePointer(ch, start));
+        }
+    }
+}
+
+// The linear-phase latency, half a power-of-two kernel plus a head partition of at least
+// 2^MIN_HEAD_ORDER samples, is a multiple of any latency multiple in use already.
+int ParametricEq::getLatencySamples() const noexcept {
+    if (engine_ == Engine::linearPhase) {
+        jassert(linearPhase_.getLatencySamples() % latencyMultiple_ == 0);
+        return linearPhase_.getLatencySamples();
+    }
+
+    return isMultirateActive() ? getLowBandSplit().getLatencySamples() : 0;
+}
+
+void ParametricEq::setLatencyMultiple(int numSamples) {
+    jassert(juce::isPowerOfTwo(numSamples) && numSamples <= 1 << LinearPhaseEngine::MIN_HEAD_ORDER);
+    latencyMultiple_ = numSamples;
+}
+
+void ParametricEq::setMultirate(bool shouldUseMultirate) {
+    multirate_ = shouldUseMultirate;
+    updateLowBandRate();
+}
+
+bool ParametricEq::isMultirateActive() const noexcept {
+    return multirate_ && engine_ == Engine::biquad && multirateStages_ > 0;
+}
+
+// Halvings of the sample rate that stay at or above MULTIRATE_BASE_RATE.
+int ParametricEq::getMultirateStages() const noexcept {
+    auto numStages = 0;
+
+    while (numStages < MultirateSplit::MAX_STAGES
+           && sampleRate_ / static_cast<double>(2 << numStages) >= MULTIRATE_BASE_RATE) {
+        ++numStages;
+    }
+
+    return numStages;
+}
+
+MultirateSplit& ParametricEq::getLowBandSplit() noexcept {
+    jassert(multirateStages_ > 0);
+    return lowBandSplits_[static_cast<size_t>(multirateStages_ - 1)];
+}
+
+const MultirateSplit& ParametricEq::getLowBandSplit() const noexcept {
+    jassert(multirateStages_ > 0);
+    return lowBandSplits_[static_cast<size_t>(multirateStages_ - 1)];
+}
+
+void ParametricEq::resetLowBandSplits() noexcept {
+    for (auto& split : lowBandSplits_) {
+        split.reset();
+    }
+}
+
+bool ParametricEq::isLowBandSlot(size_t slot) const noexcept {
+    if (slot == LOW_SHELF_SLOT) {
+        return lowShelfReduced_;
+    }
+
+    return highPassReduced_ && slot >= HIGH_PASS_SLOT && slot < HIGH_PASS_SLOT + MAX_SLOPE_SECTIONS;
+}
+
+// Moves the low shelf and the high-pass to the rate they are to run at, see isLeftAloneAboveEdge().
+// A band that moves arrives settled at its targets and re-enters its cascade from a cleared state,
+// as after an engine switch. The splits only start over when the reduced rate itself changes.
+void ParametricEq::updateLowBandRate() {
+    const auto reducedRate = isMultirateActive() ? sampleRate_ / static_cast<double>(getLowBandSplit().getFactor())
+                                                 : sampleRate_;
+    const auto rateChanged = !juce::exactlyEqual(reducedRate, reducedRate_);
+
+    if (rateChanged) {
+        reducedRate_ = reducedRate;
+        resetLowBandSplits();
+    }
+
+    auto lowShelfReduced = false;
+    auto highPassReduced = false;
+
+    if (!juce::exactlyEqual(reducedRate_, sampleRate_)) {
+        const auto edgeFrequency = MultirateSplit::PASSBAND_EDGE * reducedRate_;
+        auto highPassEdgeDb = 0.0f;
+
+        for (int i = 0; i < highPass_.getNumSections(); ++i) {
+            highPassEdgeDb += highPass_.getSection(static_cast<size_t>(i)).getMagnitudeDbAt(edgeFrequency);
+        }
+
+        lowShelfReduced = isLeftAloneAboveEdge(lowShelfFilter_.getMagnitudeDbAt(edgeFrequency), lowShelfReduced_);
+        highPassReduced = isLeftAloneAboveEdge(highPassEdgeDb, highPassReduced_);
+    }
+
+    const auto moveLowShelf = rateChanged || lowShelfReduced != lowShelfReduced_;
+    const auto moveHighPass = rateChanged || highPassReduced != highPassReduced_;
+
+    if (moveLowShelf) {
+        lowShelfReduced_ = lowShelfReduced;
+        lowShelfFilter_.setSampleRate(lowShelfReduced ? reducedRate_ : sampleRate_);
+        slotIdle_[LOW_SHELF_SLOT] = true;
+    }
+
+    if (moveHighPass) {
+        highPassReduced_ = highPassReduced;
+        highPass_.setSampleRate(highPassReduced ? reducedRate_ : sampleRate_);
+        std::fill_n(std::next(slotIdle_.begin(), static_cast<std::ptrdiff_t>(HIGH_PASS_SLOT)), MAX_SLOPE_SECTIONS, true);
+    }
+
+    if (moveLowShelf || moveHighPass) {
+        assignCascadeSlots();
+    }
+}
+
+// The split passes everything above its passband edge through unaltered, so a band only runs at
+// the reduced rate while it is within MULTIRATE_TOLERANCE_DB of unity there, as a shelf or a
+// high-pass well below the edge is. A band at the full rate comes back once within half of that,
+// so one sitting at the limit does not move back and forth.
+bool ParametricEq::isLeftAloneAboveEdge(float edgeDb, bool isReduced) noexcept {
+    const auto tolerance = isReduced ? MULTIRATE_TOLERANCE_DB : 0.5f * MULTIRATE_TOLERANCE_DB;
+    return std::abs(edgeDb) <= tolerance;
+}
+
+// Switching engines settles the one taking over at its current targets and clears its state,
+// since it has not been advanced while the other one ran.
+void ParametricEq::setEngine(Engine engine) {
+    if (engine == engine_) {
+        return;
     }
 
-    lowShelfFilter_.processBlock(buffer);
+    engine_ = engine;
+    updateLowBandRate();
+
+    if (engine_ == Engine::stateVariable) {
+        settleStateVariableEngine();
+        return;
+    }
 
-    highShelfFilter_.processBlock(buffer);
+    settleBiquadEngine();
 
-    for (int i = 0; i < numLowPassSections_; ++i) {
-        lowPassFilters_[static_cast<size_t>(i)].processBlock(buffer);
+    if (engine_ == Engine::linearPhase) {
+        linearPhase_.reset();
+        return;
     }
 
-    for (int i = 0; i < numHighPassSections_; ++i) {
-        highPassFilters_[static_cast<size_t>(i)].processBlock(buffer);
+    forEachPooledPeak([this](size_t band) { peakFilters_[band].reset(); });
+
+    lowShelfFilter_.reset();
+    highShelfFilter_.reset();
+    lowPass_.reset();
+    highPass_.reset();
+    cascade_.reset();
+    parallel_.reset();
+    lowBandCascade_.reset();
+    resetLowBandSplits();
+}
+
+// With multirate on, the low bands leave the list for the reduced-rate cascade inside the split,
+// and the rest keep their order. The reduced-rate cascade runs on the split's float low band.
+template <typename SampleType>
+void ParametricEq::processBiquadEngine(juce::AudioBuffer<SampleType>& buffer) {
+    if (isMultirateActive()) {
+        updateLowBandRate();
+    }
+
+    auto numActive = collectActiveSlots();
+
+    if (isMultirateActive()) {
+        size_t numLowBands = 0;
+        size_t numFullRate = 0;
+
+        for (size_t i = 0; i < numActive; ++i) {
+            const auto slot = activeSlots_[i];
+
+            if (isLowBandSlot(slot)) {
+                lowBandSlots_[numLowBands++] = slot;
+            } else {
+                activeSlots_[numFullRate++] = slot;
+            }
+        }
+
+        getLowBandSplit().process(buffer, [this, numLowBands](juce::AudioBuffer<float>& lowBand) {
+            if (numLowBands > 0) {
+                lowBandCascade_.process(lowBand, {lowBandSlots_.data(), numLowBands});
+            }
+        });
+
+        numActive = numFullRate;
+    }
+
+    if (numActive > 0) {
+        cascade_.process(buffer, {activeSlots_.data(), numActive});
+    }
+}
+
+// The bands advance sample by sample as they do in the cascade, but their coefficients are only
+// taken once per control interval, with the bypass fade folded in: a section mixed by m is
+// m * b / a + (1 - m), which is (m * b + (1 - m) * a) / a. The expansion is redone only when
+// they moved, and the parallel form ramps to it across the chunk instead of stepping.
+void ParametricEq::processParallelEngine(juce::AudioBuffer<float>& buffer) {
+    const auto numActive = collectActiveSlots();
+    const auto numSamples = buffer.getNumSamples();
+
+    std::array<float, BiquadCascade::MAX_SECTIONS> mixes{};
+    std::array<size_t, BiquadCascade::MAX_SECTIONS> slots{};
+    std::array<BiquadFilter::Coefficients, BiquadCascade::MAX_SECTIONS> sections{};
+
+    for (int start = 0; start < numSamples; start += controlInterval_) {
+        const auto numChunkSamples = juce::jmin(controlInterval_, numSamples - start);
+
+        for (int n = 0; n < numChunkSamples; ++n) {
+            for (size_t i = 0; i < numActive; ++i) {
+                mixes[i] = cascade_.getSection(activeSlots_[i])->advanceSample();
+            }
+        }
+
+        size_t numSections = 0;
+
+        for (size_t i = 0; i < numActive; ++i) {
+            const auto mix = mixes[i];
+            if (mix <= BiquadFilter::EPSILON) {
+                continue;
+            }
+
+            const auto c = cascade_.getSection(activeSlots_[i])->getCoefficients();
+            const auto dry = 1.0f - mix;
+            slots[numSections] = activeSlots_[i];
+            sections[numSections++] = {mix * c.b0 + dry, mix * c.b1 + dry * c.a1, mix * c.b2 + dry * c.a2, c.a1, c.a2};
+        }
+
+        parallel_.setSections({slots.data(), numSections}, {sections.data(), numSections});
+        parallel_.process(buffer, start, numChunkSamples);
+    }
+}
+
+// Lists the sections to run in activeSlots_ and returns how many there are.
+size_t ParametricEq::collectActiveSlots() {
+    size_t numActive = 0;
+
+    forEachPooledPeak([this, &numActive](size_t band) { appendIfActive(band, peakFilters_[band], numActive); });
+
+    appendIfActive(LOW_SHELF_SLOT, lowShelfFilter_, numActive);
+    appendIfActive(HIGH_SHELF_SLOT, highShelfFilter_, numActive);
+
+    for (size_t i = 0; i < MAX_SLOPE_SECTIONS; ++i) {
+        if (static_cast<int>(i) < lowPass_.getNumSections()) {
+            appendIfActive(LOW_PASS_SLOT + i, lowPass_.getSection(i), numActive);
+        } else {
+            slotIdle_[LOW_PASS_SLOT + i] = true;
+        }
+    }
+
+    for (size_t i = 0; i < MAX_SLOPE_SECTIONS; ++i) {
+        if (static_cast<int>(i) < highPass_.getNumSections()) {
+            appendIfActive(HIGH_PASS_SLOT + i, highPass_.getSection(i), numActive);
+        } else {
+            slotIdle_[HIGH_PASS_SLOT + i] = true;
+        }
+    }
+
+    return numActive;
+}
+
+// Sections whose bypass fade has finished or whose coefficients are an exact identity are left
+// out of the cascade entirely. A section re-entering it starts from a cleared state.
+void ParametricEq::appendIfActive(size_t slot, BiquadFilter& section, size_t& numActive) {
+    const auto idle = section.isIdle();
+
+    if (!idle && slotIdle_[slot]) {
+        section.resumeFromIdle();
+        cascade_.resetSection(slot);
+        lowBandCascade_.resetSection(slot);
+    }
+
+    slotIdle_[slot] = idle;
+
+    if (!idle) {
+        activeSlots_[numActive++] = slot;
+    }
+}
+
+// Each band runs over the whole buffer in turn; the state-variable sections are cheap to retune
+// but are not fused like the biquad cascade.
+void ParametricEq::processStateVariableEngine(juce::AudioBuffer<float>& buffer) {
+    forEachPooledPeak([this, &buffer](size_t band) { svfPeaks_[band].processBlock(buffer); });
+
+    svfLowShelf_.processBlock(buffer);
+    svfHighShelf_.processBlock(buffer);
+
+    for (size_t i = 0; i < static_cast<size_t>(svfLowPassSections_); ++i) {
+        svfLowPass_[i].processBlock(buffer);
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(svfHighPassSections_); ++i) {
+        svfHighPass_[i].processBlock(buffer);
+    }
+}
+
+// The biquad bands only supply the response here: they are kept at their targets, and whatever
+// is not bypassed is handed to the convolution, which designs a new kernel when it changed.
+void ParametricEq::processLinearPhaseEngine(juce::AudioBuffer<float>& buffer) {
+    settleBiquadEngine();
+
+    auto& response = linearPhaseResponse_;
+    response.numSections = 0;
+
+    const auto append = [&response](const BiquadFilter& section) {
+        if (!section.isBypassed()) {
+            response.sections[response.numSections++] = section.getCoefficients();
+        }
+    };
+
+    forEachPooledPeak([this, &append](size_t band) { append(peakFilters_[band]); });
+
+    append(lowShelfFilter_);
+    append(highShelfFilter_);
+
+    for (int i = 0; i < lowPass_.getNumSections(); ++i) {
+        append(lowPass_.getSection(static_cast<size_t>(i)));
+    }
+
+    for (int i = 0; i < highPass_.getNumSections(); ++i) {
+        append(highPass_.getSection(static_cast<size_t>(i)));
+    }
+
+    linearPhase_.setResponse(response);
+    linearPhase_.processBlock(buffer);
+}
+
+void ParametricEq::settleParameters() {
+    settleBiquadEngine();
+    settleStateVariableEngine();
+}
+
+// The biquad bands are not processed while the state-variable engine runs, but getBands() still
+// reports their responses, so they are kept at their targets.
+void ParametricEq::settleBiquadEngine() {
+    forEachPooledPeak([this](size_t band) { peakFilters_[band].settleParameters(); });
+
+    lowShelfFilter_.settleParameters();
+    highShelfFilter_.settleParameters();
+    lowPass_.settleParameters();
+    highPass_.settleParameters();
+}
+
+void ParametricEq::settleStateVariableEngine() {
+    forEachPooledPeak([this](size_t band) {
+        svfPeaks_[band].settleParameters();
+        svfPeaks_[band].reset();
+    });
+
+    for (auto* filter : {&svfLowShelf_, &svfHighShelf_}) {
+        filter->settleParameters();
+        filter->reset();
+    }
+
+    for (auto* slope : {&svfLowPass_, &svfHighPass_}) {
+        for (auto &section : *slope) {
+            section.settleParameters();
+            section.reset();
+        }
+    }
+}
+
+void ParametricEq::assignCascadeSlots() {
+    for (size_t band = 0; band < MAX_PEAKS; ++band) {
+        cascade_.setSection(band, &peakFilters_[band]);
+    }
+
+    cascade_.setSection(LOW_SHELF_SLOT, &lowShelfFilter_);
+    cascade_.setSection(HIGH_SHELF_SLOT, &highShelfFilter_);
+    lowBandCascade_.setSection(LOW_SHELF_SLOT, &lowShelfFilter_);
+
+    for (size_t i = 0; i < MAX_SLOPE_SECTIONS; ++i) {
+        cascade_.setSection(LOW_PASS_SLOT + i, &lowPass_.getSection(i));
+        cascade_.setSection(HIGH_PASS_SLOT + i, &highPass_.getSection(i));
+        lowBandCascade_.setSection(HIGH_PASS_SLOT + i, &highPass_.getSection(i));
     }
 }
 
 void ParametricEq::prepareFilters() {
-    auto totalBandFilters = static_cast<int>(peakFilters_.size());
-    for (int band = 0; band < totalBandFilters; ++band) {
-        jassert(static_cast<size_t>(band) < NUM_PEAKS);
-        auto freq = *std::next(DEFAULT_FREQS.begin(), band);
-        peakFilters_[static_cast<size_t>(band)].prepare(sampleRate_, numChannels_);
-        peakFilters_[static_cast<size_t>(band)].setParametersAndReset(freq, 1.0);
+    for (size_t band = 0; band < MAX_PEAKS; ++band) {
+        applyPeakBypass(band);
+        peakFilters_[band].prepare(sampleRate_, numChannels_);
+        peakFilters_[band].setParametersAndReset(DEFAULT_FREQS[band], 1.0);
     }
 
     lowShelfFilter_.prepare(sampleRate_, numChannels_);
@@ -66,13 +537,76 @@ void ParametricEq::prepareFilters() {
 
     highShelfFilter_.prepare(sampleRate_, numChannels_);
     highShelfFilter_.setParametersAndReset(15000.0, 1.0);
-    for (int i = 0; i < MAX_SLOPE_SECTIONS; ++i) {
-        highPassFilters_[static_cast<size_t>(i)].prepare(sampleRate_, numChannels_);
-        highPassFilters_[static_cast<size_t>(i)].setParametersAndReset(40.0, 1.0);
 
-        lowPassFilters_[static_cast<size_t>(i)].prepare(sampleRate_, numChannels_);
-        lowPassFilters_[static_cast<size_t>(i)].setParametersAndReset(18000.0, 1.0);
+    highPass_.prepare(sampleRate_, numChannels_);
+    highPass_.setParametersAndReset(40.0, 1.0);
+
+    lowPass_.prepare(sampleRate_, numChannels_);
+    lowPass_.setParametersAndReset(18000.0, 1.0);
+    reducedRate_ = sampleRate_;
+    lowShelfReduced_ = false;
+    highPassReduced_ = false;
+
+    for (size_t band = 0; band < MAX_PEAKS; ++band) {
+        svfPeaks_[band].prepare(sampleRate_, numChannels_);
+        svfPeaks_[band].setParametersAndReset(DEFAULT_FREQS[band], 1.0);
     }
+
+    svfLowShelf_.prepare(sampleRate_, numChannels_);
+    svfLowShelf_.setParametersAndReset(80.0, 1.0);
+
+    svfHighShelf_.prepare(sampleRate_, numChannels_);
+    svfHighShelf_.setParametersAndReset(15000.0, 1.0);
+
+    svfHighPassSections_ = highPass_.getNumSections();
+    svfLowPassSections_ = lowPass_.getNumSections();
+
+    for (size_t i = 0; i < MAX_SLOPE_SECTIONS; ++i) {
+        svfHighPass_[i].prepare(sampleRate_, numChannels_);
+        svfHighPass_[i].setParametersAndReset(40.0, slopeSectionQ(svfHighPassSections_, i, 1.0));
+
+        svfLowPass_[i].prepare(sampleRate_, numChannels_);
+        svfLowPass_[i].setParametersAndReset(18000.0, slopeSectionQ(svfLowPassSections_, i, 1.0));
+    }
+
+    setControlInterval(controlInterval_);
+}
+
+void ParametricEq::setControlInterval(int numSamples) {
+    controlInterval_ = juce::jmax(1, numSamples);
+
+    for (auto &filter : peakFilters_) {
+        filter.setControlInterval(controlInterval_);
+    }
+
+    lowShelfFilter_.setControlInterval(controlInterval_);
+    highShelfFilter_.setControlInterval(controlInterval_);
+    lowPass_.setControlInterval(controlInterval_);
+    highPass_.setControlInterval(controlInterval_);
+}
+
+void ParametricEq::setDoublePrecision(bool shouldUseDoublePrecision) {
+    doublePrecision_ = shouldUseDoublePrecision;
+
+    for (auto &filter : peakFilters_) {
+        filter.setDoublePrecision(doublePrecision_);
+    }
+
+    lowShelfFilter_.setDoublePrecision(doublePrecision_);
+    highShelfFilter_.setDoublePrecision(doublePrecision_);
+    lowPass_.setDoublePrecision(doublePrecision_);
+    highPass_.setDoublePrecision(doublePrecision_);
+    cascade_.setDoublePrecision(doublePrecision_);
+    lowBandCascade_.setDoublePrecision(doublePrecision_);
+}
+
+void ParametricEq::setDesignMode(BiquadFilter::DesignMode mode) {
+    for (auto &filter : peakFilters_) {
+        filter.setDesignMode(mode);
+    }
+
+    lowShelfFilter_.setDesignMode(mode);
+    highShelfFilter_.setDesignMode(mode);
 }
 
 void ParametricEq::setPeakParameters(size_t bandIndex,
@@ -84,7 +618,66 @@ void ParametricEq::setPeakParameters(size_t bandIndex,
     peakFilters_[bandIndex].setFrequency(frequency);
     peakFilters_[bandIndex].setQ(Q);
     peakFilters_[bandIndex].setAmplitude40(gainDb);
-    peakFilters_[bandIndex].setBypassed(isBypassed);
+
+    svfPeaks_[bandIndex].setFrequency(frequency);
+    svfPeaks_[bandIndex].setQ(Q);
+    svfPeaks_[bandIndex].setAmplitude40(gainDb);
+
+    peakBypassed_[bandIndex] = isBypassed;
+    applyPeakBypass(bandIndex);
+}
+
+void ParametricEq::setPeakEnabled(size_t bandIndex, bool shouldBeEnabled) noexcept {
+    if (bandIndex >= MAX_PEAKS) {
+        return;
+    }
+
+    if (shouldBeEnabled) {
+        enabledPeaks_.fetch_or(peakBit(bandIndex), std::memory_order_release);
+    } else {
+        enabledPeaks_.fetch_and(~peakBit(bandIndex), std::memory_order_release);
+    }
+}
+
+bool ParametricEq::isPeakEnabled(size_t bandIndex) const noexcept {
+    return bandIndex < MAX_PEAKS && (enabledPeaks_.load(std::memory_order_acquire) & peakBit(bandIndex)) != 0;
+}
+
+// Takes in the peaks enabled or disabled since the last block. A disabled peak is bypassed and
+// stays in the pool until its fade is over. It leaves settled in both engines and as an idle
+// slot, so that when enabled again it fades in from a cleared state whichever engine runs then.
+void ParametricEq::updatePeakPool() {
+    const auto enabled = enabledPeaks_.load(std::memory_order_acquire);
+    const auto changed = enabled ^ appliedPeaks_;
+    appliedPeaks_ = enabled;
+
+    forEachPeak(changed, [this](size_t band) { applyPeakBypass(band); });
+
+    forEachPeak(peakPool_ & ~enabled, [this](size_t band) {
+        if (!isPeakIdle(band)) {
+            return;
+        }
+
+        peakFilters_[band].settleParameters();
+        svfPeaks_[band].settleParameters();
+        svfPeaks_[band].reset();
+        slotIdle_[band] = true;
+        peakPool_ &= ~peakBit(band);
+    });
+
+    peakPool_ |= enabled;
+}
+
+// A disabled peak counts as bypassed, whatever its own bypass says.
+void ParametricEq::applyPeakBypass(size_t bandIndex) {
+    const auto bypassed = peakBypassed_[bandIndex] || (appliedPeaks_ & peakBit(bandIndex)) == 0;
+    peakFilters_[bandIndex].setBypassed(bypassed);
+    svfPeaks_[bandIndex].setBypassed(bypassed);
+}
+
+// Idle in the engine that runs it; the biquad peaks are settled while the state-variable engine runs.
+bool ParametricEq::isPeakIdle(size_t bandIndex) const noexcept {
+    return engine_ == Engine::stateVariable ? svfPeaks_[bandIndex].isIdle() : peakFilters_[bandIndex].isIdle();
 }
 
 void ParametricEq::setLowShelfParameters(double frequency, double Q, 
@@ -94,6 +687,11 @@ void ParametricEq::setLowShelfParameters(double frequency, double Q,
     lowShelfFilter_.setQ(Q);
     lowShelfFilter_.setAmplitude40(gainDb);
     lowShelfFilter_.setBypassed(isBypassed);
+
+    svfLowShelf_.setFrequency(frequency);
+    svfLowShelf_.setQ(Q);
+    svfLowShelf_.setAmplitude40(gainDb);
+    svfLowShelf_.setBypassed(isBypassed);
 }
 
 void ParametricEq::setHighShelfParameters(double frequency, double Q, 
@@ -103,44 +701,79 @@ void ParametricEq::setHighShelfParameters(double frequency, double Q,
     highShelfFilter_.setQ(Q);
     highShelfFilter_.setAmplitude40(gainDb);
     highShelfFilter_.setBypassed(isBypassed);
+
+    svfHighShelf_.setFrequency(frequency);
+    svfHighShelf_.setQ(Q);
+    svfHighShelf_.setAmplitude40(gainDb);
+    svfHighShelf_.setBypassed(isBypassed);
 }
 
-void ParametricEq::setLowPassParameters(double frequency, double Q, bool isBypassed, int slopeIndex) {
+void ParametricEq::setLowPassParameters(double frequency, double Q, bool isBypassed, int slopeIndex, bool isSteep) {
     Slope slope = static_cast<Slope>(slopeIndex);
-    numLowPassSections_ = juce::jlimit(1, MAX_SLOPE_SECTIONS, slopeToSections(slope));
-    for (int i = 0; i < numLowPassSections_; ++i) {
-        lowPassFilters_[static_cast<size_t>(i)].setFrequency(frequency);
-        lowPassFilters_[static_cast<size_t>(i)].setQ(Q);
-        lowPassFilters_[static_cast<size_t>(i)].setBypassed(isBypassed);
-    }
+    lowPass_.setNumSections(slopeToSections(slope));
+    lowPass_.setSteepPrototype(getSteepPrototype(slopeIndex, isSteep));
+    lowPass_.setFrequency(frequency);
+    lowPass_.setQ(Q);
+    lowPass_.setBypassed(isBypassed);
+
+    setSvfSlopeParameters(svfLowPass_, svfLowPassSections_, frequency, Q, isBypassed, slopeIndex);
 }
 
-void ParametricEq::setHighPassParameters(double frequency, double Q, bool isBypassed, int slopeIndex) {
+void ParametricEq::setHighPassParameters(double frequency, double Q, bool isBypassed, int slopeIndex, bool isSteep) {
     Slope slope = static_cast<Slope>(slopeIndex);
-    numHighPassSections_ = juce::jlimit(1, MAX_SLOPE_SECTIONS, slopeToSections(slope));
-    for (int i = 0; i < numHighPassSections_; ++i) {
-        highPassFilters_[static_cast<size_t>(i)].setFrequency(frequency);
-        highPassFilters_[static_cast<size_t>(i)].setQ(Q);
-        highPassFilters_[static_cast<size_t>(i)].setBypassed(isBypassed);
+    highPass_.setNumSections(slopeToSections(slope));
+    highPass_.setSteepPrototype(getSteepPrototype(slopeIndex, isSteep));
+    highPass_.setFrequency(frequency);
+    highPass_.setQ(Q);
+    highPass_.setBypassed(isBypassed);
+
+    setSvfSlopeParameters(svfHighPass_, svfHighPassSections_, frequency, Q, isBypassed, slopeIndex);
+}
+
+// Every section tracks the targets, used or not; sections brought in by a steeper slope start
+// settled and cleared, like a biquad section re-entering the cascade.
+void ParametricEq::setSvfSlopeParameters(SvfSlope& slope, int& numSections, double frequency, double Q,
+    bool isBypassed, int slopeIndex) {
+    const auto newNumSections = slopeToSections(static_cast<Slope>(slopeIndex));
+
+    for (size_t i = 0; i < slope.size(); ++i) {
+        slope[i].setFrequency(frequency);
+        slope[i].setQ(slopeSectionQ(newNumSections, i, Q));
+        slope[i].setBypassed(isBypassed);
+    }
+
+    for (auto i = numSections; i < newNumSections; ++i) {
+        slope[static_cast<size_t>(i)].settleParameters();
+        slope[static_cast<size_t>(i)].reset();
     }
+
+    numSections = newNumSections;
+}
+
+const EllipticPrototype* ParametricEq::getSteepPrototype(int slopeIndex, bool isSteep) const noexcept {
+    if (!isSteep || slopeIndex < 0 || static_cast<size_t>(slopeIndex) >= NUM_SLOPES) {
+        return nullptr;
+    }
+
+    return &steepPrototypes_[static_cast<size_t>(slopeIndex)];
 }
 
 std::vector<BiquadFilter*> ParametricEq::getBands() noexcept {
     std::vector<BiquadFilter*> result;
 
-    for (auto& p : peakFilters_) {
-        result.push_back(&p);
-    }
+    forEachPeak(enabledPeaks_.load(std::memory_order_acquire), [this, &result](size_t band) {
+        result.push_back(&peakFilters_[band]);
+    });
 
     result.push_back(&lowShelfFilter_);
     result.push_back(&highShelfFilter_);
 
-    for (int i = 0; i < numLowPassSections_; ++i) {
-        result.push_back(&lowPassFilters_[static_cast<size_t>(i)]);
+    for (int i = 0; i < lowPass_.getNumSections(); ++i) {
+        result.push_back(&lowPass_.getSection(static_cast<size_t>(i)));
     }
 
-    for (int i = 0; i < numHighPassSections_; ++i) {
-        result.push_back(&highPassFilters_[static_cast<size_t>(i)]);
+    for (int i = 0; i < highPass_.getNumSections(); ++i) {
+        result.push_back(&highPass_.getSection(static_cast<size_t>(i)));
     }
 
     return result;
@@ -18,22 +18,6 @@ void styleUtilityButton(juce::TextButton& button, const juce::String& tooltip) {
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
     AudioPluginAudioProcessor& p)
     : AudioProcessorEditor(&p), processorRef(p),
-    peakBand0_(processorRef.getParameters().peakFilters[0]->base.frequency,
-               processorRef.getParameters().peakFilters[0]->gain,
-               frequencyAxis_,
-               BandComponent::BandType::Peak),
-    peakBand1_(processorRef.getParameters().peakFilters[1]->base.frequency,
-               processorRef.getParameters().peakFilters[1]->gain,
-               frequencyAxis_,
-               BandComponent::BandType::Peak),
-    peakBand2_(processorRef.getParameters().peakFilters[2]->base.frequency,
-               processorRef.getParameters().peakFilters[2]->gain,
-               frequencyAxis_,
-               BandComponent::BandType::Peak),
-    peakBand3_(processorRef.getParameters().peakFilters[3]->base.frequency,
-               processorRef.getParameters().peakFilters[3]->gain,
-               frequencyAxis_,
-               BandComponent::BandType::Peak),
     lowPassBand_(processorRef.getParameters().lowPassParameters.frequency,
                  processorRef.getParameters().lowPassParameters.qFactor,
                  frequencyAxis_,
@@ -51,49 +35,72 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
                   frequencyAxis_,
                   BandComponent::BandType::LowShelf)
 {
+    for (size_t i = 0; i < peakBands_.size(); ++i) {
+        auto& peak = *processorRef.getParameters().peakFilters[i];
+        peakBands_[i] = std::make_unique<BandComponent>(peak.base.frequency, peak.gain, frequencyAxis_,
+                                                        BandComponent::BandType::Peak);
+    }
+
     setSize(1080, 450);
+    processorRef.getSpectrumAnalyzer().addConsumer();
     startTimerHz(30);
 
     addAndMakeVisible(frequencyAxis_);
     addAndMakeVisible(frequencyResponseGUI_);
     addChildComponent(filterInspectorPanel_);
-    addAndMakeVisible(peakBand0_);
-    addAndMakeVisible(peakBand1_);
-    addAndMakeVisible(peakBand2_);
-    addAndMakeVisible(peakBand3_);
+    for (auto& band : peakBands_) {
+        addChildComponent(*band);
+    }
     addAndMakeVisible(lowPassBand_);
     addAndMakeVisible(highPassBand_);
     addAndMakeVisible(highShelfBand_);
     addAndMakeVisible(lowShelfBand_);
     addAndMakeVisible(postButton_);
     addAndMakeVisible(bypassButton_);
-
-    auto bands = processorRef.getParametricEq().getBands();
+    addAndMakeVisible(linearPhaseButton_);
+    addAndMakeVisible(oversamplingBox_);
+    addAndMakeVisible(smoothingBox_);
+    addAndMakeVisible(addPeakButton_);
+    addAndMakeVisible(removePeakButton_);
 
     frequencyAxis_.setInterceptsMouseClicks(false, false);
     frequencyAxis_.setDbRange(-40.0f, 40.0f);
-    frequencyAxis_.setReferenceBands(bands);
 
     frequencyResponseGUI_.setInterceptsMouseClicks(false, false);
-    frequencyResponseGUI_.setSampleRate(processorRef.getSampleRate());
 
     filterInspectorPanel_.setCloseCallback([this]() { clearSelectedFilter(); });
     styleUtilityButton(postButton_, "When enabled, the analyzer reads the EQ output instead of the input.");
     styleUtilityButton(bypassButton_, "Temporarily bypass the entire EQ.");
+    styleUtilityButton(linearPhaseButton_, "Applies the same curve without phase shift, at the cost of added latency.");
 
     postAttachment_ = std::make_unique<juce::ButtonParameterAttachment>(
         processorRef.getParameters().isPost, postButton_);
     bypassAttachment_ = std::make_unique<juce::ButtonParameterAttachment>(
         processorRef.getParameters().bypassed, bypassButton_);
+    linearPhaseAttachment_ = std::make_unique<juce::ButtonParameterAttachment>(
+        processorRef.getParameters().linearPhase, linearPhaseButton_);
+
+    auto& oversampling = processorRef.getParameters().oversampling;
+    oversamplingBox_.addItemList(oversampling.choices, 1);
+    oversamplingBox_.setTooltip("Runs the EQ at 2x or 4x the sample rate, so bands near Nyquist keep "
+                                "their shape. Offline renders use the next higher factor.");
+    oversamplingAttachment_ = std::make_unique<juce::ComboBoxParameterAttachment>(oversampling, oversamplingBox_);
+
+    auto& smoothing = *processorRef.getParameters().analyzerSmoothing;
+    smoothingBox_.addItemList(smoothing.choices, 1);
+    smoothingBox_.setTooltip("Averages the analyzer's spectrum over a fraction of an octave around each frequency.");
+    smoothingAttachment_ = std::make_unique<juce::ComboBoxParameterAttachment>(smoothing, smoothingBox_);
 
-    peakBand0_.setDbRange(-40.0f, 40.0f);
-    peakBand0_.updateFromParameters();
-    peakBand1_.setDbRange(-40.0f, 40.0f);
-    peakBand1_.updateFromParameters();
-    peakBand2_.setDbRange(-40.0f, 40.0f);
-    peakBand2_.updateFromParameters();
-    peakBand3_.setDbRange(-40.0f, 40.0f);
-    peakBand3_.updateFromParameters();
+    addPeakButton_.setTooltip("Adds a peak band from the unused ones.");
+    addPeakButton_.onClick = [this]() { addPeak(); };
+    removePeakButton_.setTooltip("Removes the selected peak band.");
+    removePeakButton_.onClick = [this]() { removeSelectedPeak(); };
+
+    for (size_t i = 0; i < peakBands_.size(); ++i) {
+        peakBands_[i]->setDbRange(-40.0f, 40.0f);
+        peakBands_[i]->updateFromParameters();
+        peakBands_[i]->setInteractionCallback([this, i]() { selectPeak(i); });
+    }
 
     lowPassBand_.setDbRange(-40.0f, 40.0f);
     lowPassBand_.updateFromParameters();
@@ -105,29 +112,15 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
     lowShelfBand_.setDbRange(-40.0f, 40.0f);
     lowShelfBand_.updateFromParameters();
 
-    peakBand0_.setInteractionCallback([this]() {
-        auto& peak = *processorRef.getParameters().peakFilters[0];
-        selectFilter(peakBand0_, {"Peak 1", &peak.base, &peak.gain, &peak.lfo});
-    });
-    peakBand1_.setInteractionCallback([this]() {
-        auto& peak = *processorRef.getParameters().peakFilters[1];
-        selectFilter(peakBand1_, {"Peak 2", &peak.base, &peak.gain, &peak.lfo});
-    });
-    peakBand2_.setInteractionCallback([this]() {
-        auto& peak = *processorRef.getParameters().peakFilters[2];
-        selectFilter(peakBand2_, {"Peak 3", &peak.base, &peak.gain, &peak.lfo});
-    });
-    peakBand3_.setInteractionCallback([this]() {
-        auto& peak = *processorRef.getParameters().peakFilters[3];
-        selectFilter(peakBand3_, {"Peak 4", &peak.base, &peak.gain, &peak.lfo});
-    });
     lowPassBand_.setInteractionCallback([this]() {
         auto& parameters = processorRef.getParameters().lowPassParameters;
-        selectFilter(lowPassBand_, {"Low Pass", &parameters, nullptr, nullptr});
+        selectFilter(lowPassBand_, {"Low Pass", &parameters, nullptr, nullptr,
+                                    &processorRef.getParameters().lowPassSteep});
     });
     highPassBand_.setInteractionCallback([this]() {
         auto& parameters = processorRef.getParameters().highPassParameters;
-        selectFilter(highPassBand_, {"High Pass", &parameters, nullptr, nullptr});
+        selectFilter(highPassBand_, {"High Pass", &parameters, nullptr, nullptr,
+                                     &processorRef.getParameters().highPassSteep});
     });
     highShelfBand_.setInteractionCallback([this]() {
         auto& parameters = processorRef.getParameters().highShelfParameters;
@@ -137,9 +130,13 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
         auto& parameters = processorRef.getParameters().lowShelfParameters;
         selectFilter(lowShelfBand_, {"Low Shelf", &parameters.base, &parameters.gain, &parameters.lfo});
     });
+
+    updatePeakBands();
 }
 
-AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor() {}
+AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor() {
+    processorRef.getSpectrumAnalyzer().removeConsumer();
+}
 
 void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g) {
     g.fillAll(juce::Colour(0,0,0));
@@ -148,8 +145,18 @@ void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g) {
 void AudioPluginAudioProcessorEditor::resized() {
     auto bounds = getLocalBounds().reduced(10);
     auto controlBounds = bounds.removeFromTop(30);
-    auto buttonBounds = controlBounds.removeFromRight(182);
+    auto buttonBounds = controlBounds.removeFromRight(444);
+
+    addPeakButton_.setBounds(controlBounds.removeFromLeft(72));
+    controlBounds.removeFromLeft(8);
+    removePeakButton_.setBounds(controlBounds.removeFromLeft(72));
 
+    smoothingBox_.setBounds(buttonBounds.removeFromLeft(84));
+    buttonBounds.removeFromLeft(8);
+    oversamplingBox_.setBounds(buttonBounds.removeFromLeft(72));
+    buttonBounds.removeFromLeft(8);
+    linearPhaseButton_.setBounds(buttonBounds.removeFromLeft(82));
+    buttonBounds.removeFromLeft(8);
     postButton_.setBounds(buttonBounds.removeFromLeft(82));
     buttonBounds.removeFromLeft(8);
     bypassButton_.setBounds(buttonBounds.removeFromLeft(92));
@@ -157,29 +164,23 @@ void AudioPluginAudioProcessorEditor::resized() {
     frequencyResponseGUI_.setBounds(bounds);
     frequencyAxis_.setBounds(bounds);
     filterInspectorPanel_.setBounds(bounds.withTrimmedTop(bounds.getHeight() - 180));
-    peakBand0_.setBounds(bounds);
-    peakBand1_.setBounds(bounds);
-    peakBand2_.setBounds(bounds);
-    peakBand3_.setBounds(bounds);
-    lowPassBand_.setBounds(bounds);
-    highPassBand_.setBounds(bounds);
-    highShelfBand_.setBounds(bounds);
-    lowShelfBand_.setBounds(bounds);
+
+    for (auto* band : getAllBands()) {
+        band->setBounds(bounds);
+    }
 }
 
 void AudioPluginAudioProcessorEditor::timerCallback() {
     auto& analyzer = processorRef.getSpectrumAnalyzer();
 
-    if (analyzer.isNewFFTReady()) {
-        const auto& mags = analyzer.getMagnitudesDb();
-        frequencyResponseGUI_.setMagnitudes(mags);
-        analyzer.clearNewFFTFlag();
+    frequencyResponseGUI_.setSmoothing(
+        static_cast<SpectrumDisplay::Smoothing>(processorRef.getParameters().analyzerSmoothing->getIndex()));
+
+    if (analyzer.updateMagnitudesDb()) {
+        frequencyResponseGUI_.setMagnitudes(analyzer.getMagnitudesDb());
     }
 
-    peakBand0_.updateFromParameters();
-    peakBand1_.updateFromParameters();
-    peakBand2_.updateFromParameters();
-    peakBand3_.updateFromParameters();
+    updatePeakBands();
     lowPassBand_.updateFromParameters();
     highPassBand_.updateFromParameters();
     highShelfBand_.updateFromParameters();
@@ -190,28 +191,104 @@ void AudioPluginAudioProcessorEditor::selectFilter(BandComponent& band, FilterSe
     selectedBand_ = &band;
     filterInspectorPanel_.showSelection(selection);
 
-    peakBand0_.setSelected(selectedBand_ == &peakBand0_);
-    peakBand1_.setSelected(selectedBand_ == &peakBand1_);
-    peakBand2_.setSelected(selectedBand_ == &peakBand2_);
-    peakBand3_.setSelected(selectedBand_ == &peakBand3_);
-    lowPassBand_.setSelected(selectedBand_ == &lowPassBand_);
-    highPassBand_.setSelected(selectedBand_ == &highPassBand_);
-    highShelfBand_.setSelected(selectedBand_ == &highShelfBand_);
-    lowShelfBand_.setSelected(selectedBand_ == &lowShelfBand_);
+    for (auto* other : getAllBands()) {
+        other->setSelected(selectedBand_ == other);
+    }
 }
 
 void AudioPluginAudioProcessorEditor::clearSelectedFilter() {
     selectedBand_ = nullptr;
 
     filterInspectorPanel_.clearSelection();
-    peakBand0_.setSelected(selectedBand_ == &peakBand0_);
-    peakBand1_.setSelected(selectedBand_ == &peakBand1_);
-    peakBand2_.setSelected(selectedBand_ == &peakBand2_);
-    peakBand3_.setSelected(selectedBand_ == &peakBand3_);
-    lowPassBand_.setSelected(selectedBand_ == &lowPassBand_);
-    highPassBand_.setSelected(selectedBand_ == &highPassBand_);
-    highShelfBand_.setSelected(selectedBand_ == &highShelfBand_);
-    lowShelfBand_.setSelected(selectedBand_ == &lowShelfBand_);
+
+    for (auto* band : getAllBands()) {
+        band->setSelected(false);
+    }
+}
+
+void AudioPluginAudioProcessorEditor::selectPeak(size_t index) {
+    auto& peak = *processorRef.getParameters().peakFilters[index];
+    const auto name = "Peak " + juce::String(index + 1);
+    selectFilter(*peakBands_[index], {name, &peak.base, &peak.gain, &peak.lfo});
+}
+
+// Enabling goes through the parameter, like any other edit; the processor hands it to the
+// equaliser's pool on its next block.
+void AudioPluginAudioProcessorEditor::addPeak() {
+    auto& enabled = processorRef.getParameters().peakEnabled;
+    const auto unused = std::find_if(enabled.begin(), enabled.end(), [](auto* parameter) { return !parameter->get(); });
+    if (unused == enabled.end()) {
+        return;
+    }
+
+    (*unused)->beginChangeGesture();
+    **unused = true;
+    (*unused)->endChangeGesture();
+
+    const auto index = static_cast<size_t>(std::distance(enabled.begin(), unused));
+    updatePeakBands();
+    selectPeak(index);
+}
+
+void AudioPluginAudioProcessorEditor::removeSelectedPeak() {
+    const auto selected = std::find_if(peakBands_.begin(), peakBands_.end(),
+                                       [this](const auto& band) { return band.get() == selectedBand_; });
+    if (selected == peakBands_.end()) {
+        return;
+    }
+
+    auto& enabled = *processorRef.getParameters().peakEnabled[static_cast<size_t>(std::distance(peakBands_.begin(), selected))];
+    enabled.beginChangeGesture();
+    enabled = false;
+    enabled.endChangeGesture();
+
+    updatePeakBands();
+}
+
+// Shows the bands of the enabled peaks, and keeps the reference curve on the bands the equaliser
+// runs, which follow the parameters one block later.
+void AudioPluginAudioProcessorEditor::updatePeakBands() {
+    const auto& enabled = processorRef.getParameters().peakEnabled;
+
+    for (size_t i = 0; i < peakBands_.size(); ++i) {
+        auto& band = *peakBands_[i];
+        const auto isEnabled = enabled[i]->get();
+
+        if (!isEnabled && selectedBand_ == &band) {
+            clearSelectedFilter();
+        }
+
+        band.setVisible(isEnabled);
+
+        if (isEnabled) {
+            band.updateFromParameters();
+        }
+    }
+
+    removePeakButton_.setEnabled(std::any_of(peakBands_.begin(), peakBands_.end(),
+                                             [this](const auto& band) { return band.get() == selectedBand_; }));
+
+    auto bands = processorRef.getParametricEq().getBands();
+    if (bands != referenceBands_) {
+        referenceBands_ = std::move(bands);
+        frequencyAxis_.setReferenceBands(referenceBands_);
+    }
+
+    frequencyAxis_.updateResponses();
+}
+
+std::vector<BandComponent*> AudioPluginAudioProcessorEditor::getAllBands() {
+    std::vector<BandComponent*> bands;
+
+    for (auto& band : peakBands_) {
+        bands.push_back(band.get());
+    }
+
+    for (auto* band : {&lowPassBand_, &highPassBand_, &highShelfBand_, &lowShelfBand_}) {
+        bands.push_back(band);
+    }
+
+    return bands;
 }
 
 }  // namespace parametric_eq
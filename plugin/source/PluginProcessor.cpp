@@ -72,6 +72,11 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
               .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
       ) {
+  // At high rates the low shelf and the high-pass run decimated, for the resolution near DC.
+  parametricEq_.setMultirate(true);
+
+  // Whatever the EQ delays at the oversampled rate comes back to whole samples at the base rate.
+  parametricEq_.setLatencyMultiple(1 << MAX_OVERSAMPLING_STAGES);
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor() {}
@@ -133,7 +138,22 @@ void AudioPluginAudioProcessor::changeProgramName(int index,
 void AudioPluginAudioProcessor::prepareToPlay(double sampleRate,
                                               int samplesPerBlock) {
   auto numChannels = std::min(getTotalNumInputChannels(), getTotalNumOutputChannels());
-  parametricEq_.prepare(sampleRate, numChannels);
+  numEqChannels_ = numChannels;
+  baseSampleRate_ = sampleRate;
+
+  // The host picks the precision before preparing. The EQ then designs its filters in double as
+  // well, for the response near DC at high rates.
+  parametricEq_.setDoublePrecision(isUsingDoublePrecision());
+
+  const auto totalNumChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+  if (isUsingDoublePrecision()) {
+    prepareSignalPath(doublePath_, numChannels, totalNumChannels, sampleRate, samplesPerBlock);
+    floatPath_ = {};
+  } else {
+    prepareSignalPath(floatPath_, numChannels, totalNumChannels, sampleRate, samplesPerBlock);
+    doublePath_ = {};
+  }
+
   spectrumAnalyzer_.prepare(sampleRate, numChannels);
   for (auto& lfo : peakGainLfos_) {
     prepareLfo(lfo, sampleRate, samplesPerBlock);
@@ -143,10 +163,97 @@ void AudioPluginAudioProcessor::prepareToPlay(double sampleRate,
   bypassTransitioner_.prepare({
     .sampleRate = sampleRate,
     .maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock),
-    .numChannels = static_cast<juce::uint32>(
-      juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels())),
+    .numChannels = static_cast<juce::uint32>(totalNumChannels),
+  });
+
+  setOversamplingStages(getOversamplingStages());
+  updateProcessingMode();
+}
+
+template <typename SampleType>
+void AudioPluginAudioProcessor::prepareSignalPath(SignalPath<SampleType>& path, int numChannels, int totalNumChannels,
+                                                  double sampleRate, int samplesPerBlock) {
+  // Every factor is set up front, so switching between them on the audio thread never allocates.
+  // The half-bands are linear-phase FIRs, and the oversampler pads its latency to whole samples,
+  // so the dry path, delayed by the reported latency, lines up with the wet one at every
+  // frequency and the bypass crossfade does not comb.
+  auto maxLatency = 0;
+  for (size_t i = 0; i < path.oversamplers.size(); ++i) {
+    path.oversamplers[i] = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+        static_cast<size_t>(numChannels), i + 1,
+        juce::dsp::Oversampling<SampleType>::filterHalfBandFIREquiripple, true, true);
+    path.oversamplers[i]->initProcessing(static_cast<size_t>(samplesPerBlock));
+    maxLatency = juce::jmax(maxLatency, juce::roundToInt(path.oversamplers[i]->getLatencyInSamples()));
+  }
+
+  // The linear-phase engine's latency, counted at the oversampled rate, only shrinks at base rate.
+  // It also bounds the multirate split's, which only runs with the other engine.
+  maxLatency += LinearPhaseEngine::DEFAULT_LATENCY_SAMPLES;
+
+  path.dryDelay.setMaximumDelayInSamples(maxLatency);
+  path.dryDelay.prepare({
+    .sampleRate = sampleRate,
+    .maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock),
+    .numChannels = static_cast<juce::uint32>(totalNumChannels),
   });
+  path.delayedDryBuffer.setSize(totalNumChannels, samplesPerBlock);
+  path.discardedWetBuffer.setSize(totalNumChannels, samplesPerBlock);
+  path.oversampledChannels.assign(static_cast<size_t>(numChannels), nullptr);
+}
+
+// Hosts announce an offline render before preparing for it, and the render then runs one factor
+// higher than the setting. "Off" stays off, so a bounce never differs from playback unasked.
+int AudioPluginAudioProcessor::getOversamplingStages() const {
+  const auto selectedStages = parameters_.oversampling.getIndex();
+  if (selectedStages == 0) {
+    return 0;
+  }
+
+  return isNonRealtime() ? juce::jmin(selectedStages + 1, MAX_OVERSAMPLING_STAGES) : selectedStages;
+}
+
+// The EQ is re-prepared at the new rate, which only resets its state for an unchanged channel
+// count, and is settled once the next block has set its parameters, so nothing glides in from the
+// defaults.
+void AudioPluginAudioProcessor::setOversamplingStages(int numStages) {
+  oversamplingStages_ = numStages;
+  parametricEq_.prepare(baseSampleRate_ * static_cast<double>(1 << numStages), numEqChannels_);
+  eqNeedsSettling_ = true;
+
+  if (numStages > 0) {
+    withActiveSignalPath([numStages](auto& path) {
+      path.oversamplers[static_cast<size_t>(numStages - 1)]->reset();
+    });
+  }
+}
+
+// Follows the oversampling and phase settings, and reports the latency they add. The dry path is
+// delayed to match, which keeps the bypass crossfade aligned with what the host compensates for.
+void AudioPluginAudioProcessor::updateProcessingMode() {
+  if (const auto oversamplingStages = getOversamplingStages(); oversamplingStages != oversamplingStages_) {
+    setOversamplingStages(oversamplingStages);
+  }
 
+  parametricEq_.setEngine(parameters_.linearPhase.get() ? ParametricEq::Engine::linearPhase
+                                                        : ParametricEq::Engine::biquad);
+
+  withActiveSignalPath([this]<typename SampleType>(SignalPath<SampleType>& path) {
+    // The EQ counts its latency at the oversampled rate, in a multiple of the factor. The
+    // oversampler's is whole already, and rounding only drops the error of adding it up.
+    jassert(parametricEq_.getLatencySamples() % (1 << oversamplingStages_) == 0);
+    auto latency = parametricEq_.getLatencySamples() >> oversamplingStages_;
+    if (oversamplingStages_ > 0) {
+      latency += juce::roundToInt(
+          path.oversamplers[static_cast<size_t>(oversamplingStages_ - 1)]->getLatencyInSamples());
+    }
+
+    if (latency != getLatencySamples()) {
+      path.dryDelay.reset();
+      setLatencySamples(latency);
+    }
+
+    path.dryDelay.setDelay(static_cast<SampleType>(latency));
+  });
 }
 
 void AudioPluginAudioProcessor::releaseResources() {
@@ -174,7 +281,17 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported(
 void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                              juce::MidiBuffer& midiMessages) {
   juce::ignoreUnused(midiMessages);
+  processBlockInPrecision(buffer);
+}
+
+void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer,
+                                             juce::MidiBuffer& midiMessages) {
+  juce::ignoreUnused(midiMessages);
+  processBlockInPrecision(buffer);
+}
 
+template <typename SampleType>
+void AudioPluginAudioProcessor::processBlockInPrecision(juce::AudioBuffer<SampleType>& buffer) {
   juce::ScopedNoDenormals noDenormals;
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -185,20 +302,61 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
   }
 
 
+  updateProcessingMode();
+
+  // Nobody sees the spectrum of an offline render, or one without an editor open.
+  const auto feedsAnalyzer = spectrumAnalyzer_.hasConsumers() && !isNonRealtime();
+
   bypassTransitioner_.setBypass(parameters_.bypassed.get());
   if (parameters_.bypassed.get() && !bypassTransitioner_.isTransitioning() == true) {
+    // A path with latency keeps running on a copy that is thrown away, so that un-bypassing fades
+    // into the current input rather than into whatever its delay lines held when bypass engaged.
+    if (getLatencySamples() > 0) {
+      auto& discardedWetBuffer = getSignalPath<SampleType>().discardedWetBuffer;
+      discardedWetBuffer.makeCopyOf(buffer, true);
+      updateEqParameters(buffer.getNumSamples());
+      processOversampled(discardedWetBuffer);
+    }
+
+    delayDrySignal(buffer);
     return;
   }
-  bypassTransitioner_.setDryBuffer(buffer);
 
-  if (!parameters_.isPost.get()) {
+  if (getLatencySamples() > 0) {
+    auto& delayedDryBuffer = getSignalPath<SampleType>().delayedDryBuffer;
+    delayedDryBuffer.makeCopyOf(buffer, true);
+    delayDrySignal(delayedDryBuffer);
+    bypassTransitioner_.setDryBuffer(delayedDryBuffer);
+  } else {
+    bypassTransitioner_.setDryBuffer(buffer);
+  }
+
+  if (feedsAnalyzer && !parameters_.isPost.get()) {
+    spectrumAnalyzer_.pushBlock(buffer);
+  }
+
+  updateEqParameters(buffer.getNumSamples());
+  processOversampled(buffer);
+  bypassTransitioner_.mixToWetBuffer(buffer);
+
+  if (feedsAnalyzer && parameters_.isPost.get()) {
     spectrumAnalyzer_.pushBlock(buffer);
   }
+}
+
+// Hands the parameters to the EQ, advancing the gain LFOs by a block of numSamples.
+void AudioPluginAudioProcessor::updateEqParameters(int numSamples) {
+  // Disabled peaks leave the pool, so only the ones in use are modulated and updated.
+  for (size_t i = 0; i < ParametricEq::MAX_PEAKS; i++) {
+    const auto enabled = parameters_.peakEnabled[i]->get();
+    parametricEq_.setPeakEnabled(i, enabled);
+    if (!enabled) {
+      continue;
+    }
 
-  for (size_t i = 0; i < ParametricEq::NUM_PEAKS; i++) {
     const auto& peak = parameters_.peakFilters[i];
     const auto modulatedGainDb =
-        getModulatedGainDb(*peak, peakGainLfos_[i], buffer.getNumSamples());
+        getModulatedGainDb(*peak, peakGainLfos_[i], numSamples);
     parametricEq_.setPeakParameters(
       i, 
       static_cast<double>(peak->base.frequency.get()),
@@ -210,7 +368,7 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 
   const auto& lowShelf = parameters_.lowShelfParameters;
   const auto lowShelfModulatedGainDb =
-      getModulatedGainDb(lowShelf, lowShelfGainLfo_, buffer.getNumSamples());
+      getModulatedGainDb(lowShelf, lowShelfGainLfo_, numSamples);
   parametricEq_.setLowShelfParameters(
     static_cast<double>(lowShelf.base.frequency.get()),
     static_cast<double>(lowShelf.base.qFactor.get()),
@@ -221,7 +379,7 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 
   const auto& highShelf = parameters_.highShelfParameters;
   const auto highShelfModulatedGainDb =
-      getModulatedGainDb(highShelf, highShelfGainLfo_, buffer.getNumSamples());
+      getModulatedGainDb(highShelf, highShelfGainLfo_, numSamples);
   parametricEq_.setHighShelfParameters(
     static_cast<double>(highShelf.base.frequency.get()),
     static_cast<double>(highShelf.base.qFactor.get()),
@@ -235,7 +393,8 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     static_cast<double>(lowPass.frequency.get()),
     static_cast<double>(lowPass.qFactor.get()),
     lowPass.bypassed.get(),
-    lowPass.slope.getIndex()
+    lowPass.slope.getIndex(),
+    parameters_.lowPassSteep.get()
   );
 
   const auto& highPass = parameters_.highPassParameters;
@@ -243,14 +402,56 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     static_cast<double>(highPass.frequency.get()),
     static_cast<double>(highPass.qFactor.get()),
     highPass.bypassed.get(),
-    highPass.slope.getIndex()
+    highPass.slope.getIndex(),
+    parameters_.highPassSteep.get()
   );
 
-  parametricEq_.processBlock(buffer);
-  bypassTransitioner_.mixToWetBuffer(buffer);
+  if (eqNeedsSettling_) {
+    parametricEq_.settleParameters();
+    eqNeedsSettling_ = false;
+  }
+}
 
-  if (parameters_.isPost.get()) {
-    spectrumAnalyzer_.pushBlock(buffer);
+template <typename SampleType>
+void AudioPluginAudioProcessor::processOversampled(juce::AudioBuffer<SampleType>& buffer) {
+  if (oversamplingStages_ == 0) {
+    parametricEq_.processBlock(buffer);
+    return;
+  }
+
+  auto& path = getSignalPath<SampleType>();
+  auto& oversampler = *path.oversamplers[static_cast<size_t>(oversamplingStages_ - 1)];
+  auto block = juce::dsp::AudioBlock<SampleType>{buffer}.getSubsetChannelBlock(
+      0, static_cast<size_t>(numEqChannels_));
+  auto oversampledBlock = oversampler.processSamplesUp(block);
+
+  auto& channels = path.oversampledChannels;
+  for (size_t ch = 0; ch < oversampledBlock.getNumChannels(); ++ch) {
+    channels[ch] = oversampledBlock.getChannelPointer(ch);
+  }
+
+  // Refers to the oversampler's own storage; the buffer only wraps the channel pointers.
+  juce::AudioBuffer<SampleType> oversampledBuffer{channels.data(),
+                                                  static_cast<int>(oversampledBlock.getNumChannels()),
+                                                  static_cast<int>(oversampledBlock.getNumSamples())};
+  parametricEq_.processBlock(oversampledBuffer);
+
+  oversampler.processSamplesDown(block);
+}
+
+template <typename SampleType>
+void AudioPluginAudioProcessor::delayDrySignal(juce::AudioBuffer<SampleType>& buffer) noexcept {
+  if (getLatencySamples() == 0) {
+    return;
+  }
+
+  auto& dryDelay = getSignalPath<SampleType>().dryDelay;
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+    auto* samples = buffer.getWritePointer(ch);
+    for (int n = 0; n < buffer.getNumSamples(); ++n) {
+      dryDelay.pushSample(ch, samples[n]);
+      samples[n] = dryDelay.popSample(ch);
+    }
   }
 }
 
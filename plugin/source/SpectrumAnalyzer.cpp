@@ -1,48 +1,294 @@
 #include "NIWSParametricEq/SpectrumAnalyzer.h"
 
+SpectrumAnalyzer::Resolution::Resolution(int order, size_t longestSize)
+    : size(size_t{1} << order),
+    fft(order),
+    window(size, juce::dsp::WindowingFunction<float>::hann),
+    buffer(size * 2, 0.0f),
+    magnitudesDb(size / 2, -120.0f),
+    levelOffsetDb(20.0f * std::log10(static_cast<float>(longestSize) / static_cast<float>(size))) {}
+
 SpectrumAnalyzer::SpectrumAnalyzer(int fftOrder)
-    : fftOrder_(fftOrder),
-    fftSize_(size_t{1} << fftOrder_),
-    fft_(fftOrder_),
-    window_(fftSize_, juce::dsp::WindowingFunction<float>::hann),
-    fftBuffer_(fftSize_ * 2, 0.0f),
-    magnitudeDb_(fftSize_ / 2, -100.0f) {}
+    : fftSize_(size_t{1} << fftOrder) {
+    jassert(fftOrder - ORDER_STEP * (NUM_RESOLUTIONS - 1) >= 4);
+
+    for (size_t r = 0; r < resolutions_.size(); ++r) {
+        resolutions_[r] = std::make_unique<Resolution>(fftOrder - ORDER_STEP * static_cast<int>(r), fftSize_);
+    }
+
+    magnitudesDb_.fill(std::vector<float>(NUM_POINTS, -100.0f));
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    analysisThread_.stopThread(1000);
+}
 
 void SpectrumAnalyzer::prepare(double sampleRate, int numInputChannels) {
-    juce::ignoreUnused(sampleRate);
-    ringBuffer_.reset(static_cast<int>(fftSize_ * 4), numInputChannels); 
-    newFFTReady_ = false;
+    analysisThread_.stopThread(1000);
+    sampleRate_ = sampleRate;
+
+    // Room for two of the longest transforms, which covers many polls at any sample rate.
+    const auto fifoSize = static_cast<int>(fftSize_ * 2);
+    fifoBuffer_.setSize(numInputChannels, fifoSize);
+    fifo_.setTotalSize(fifoSize);
+
+    // Only the mono mix is ever transformed, so that is all the ring keeps.
+    ringBuffer_.reset(static_cast<int>(fftSize_ * 4), numInputChannels, RingBuffer::Layout::downmixed);
+    restartCursors();
+
+    buildPointMap(singleResolutionPoints_, false);
+    buildPointMap(multiResolutionPoints_, true);
+
+    resetStats();
+    analysisThread_.startThread(juce::Thread::Priority::low);
+}
+
+template <typename SampleType>
+void SpectrumAnalyzer::pushBlock(const juce::AudioBuffer<SampleType>& buffer) noexcept {
+    int start1 = 0;
+    int size1 = 0;
+    int start2 = 0;
+    int size2 = 0;
+    fifo_.prepareToWrite(buffer.getNumSamples(), start1, size1, start2, size2);
+
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), fifoBuffer_.getNumChannels());
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const auto* src = buffer.getReadPointer(ch);
+        auto* dest = fifoBuffer_.getWritePointer(ch);
+
+        for (int n = 0; n < size1; ++n) {
+            dest[start1 + n] = static_cast<float>(src[n]);
+        }
+        for (int n = 0; n < size2; ++n) {
+            dest[start2 + n] = static_cast<float>(src[size1 + n]);
+        }
+    }
+
+    for (int ch = numChannels; ch < fifoBuffer_.getNumChannels(); ++ch) {
+        fifoBuffer_.clear(ch, start1, size1);
+        fifoBuffer_.clear(ch, start2, size2);
+    }
+
+    fifo_.finishedWrite(size1 + size2);
+}
+
+template void SpectrumAnalyzer::pushBlock(const juce::AudioBuffer<float>&) noexcept;
+template void SpectrumAnalyzer::pushBlock(const juce::AudioBuffer<double>&) noexcept;
+
+// Points evenly spaced in log frequency from MIN_FREQUENCY to MAX_FREQUENCY.
+double SpectrumAnalyzer::getPointFrequency(size_t point) noexcept {
+    const auto position = static_cast<double>(point) / static_cast<double>(NUM_POINTS - 1);
+    return MIN_FREQUENCY * std::pow(MAX_FREQUENCY / MIN_FREQUENCY, position);
+}
+
+void SpectrumAnalyzer::setOverlap(float overlap) noexcept {
+    overlap_.store(juce::jlimit(MIN_OVERLAP, MAX_OVERLAP, overlap), std::memory_order_relaxed);
+}
+
+void SpectrumAnalyzer::setMultiResolution(bool shouldUseMultiResolution) noexcept {
+    multiResolution_.store(shouldUseMultiResolution, std::memory_order_relaxed);
+}
+
+SpectrumAnalyzer::Stats SpectrumAnalyzer::getStats() const noexcept {
+    return {framesPerSecond_.load(std::memory_order_relaxed), transformsPerSecond_.load(std::memory_order_relaxed),
+            threadLoad_.load(std::memory_order_relaxed)};
+}
+
+void SpectrumAnalyzer::addConsumer() noexcept {
+    if (numConsumers_.fetch_add(1, std::memory_order_relaxed) == 0) {
+        analysisThread_.notify();
+    }
+}
+
+void SpectrumAnalyzer::removeConsumer() noexcept {
+    jassert(hasConsumers());
+    numConsumers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void SpectrumAnalyzer::analyze() {
+    while (!analysisThread_.threadShouldExit()) {
+        // Until someone is watching again. What was left in the FIFO goes to the ring, and the
+        // hops start over, so the first frames after waking only wait for new samples. The stats
+        // read zero meanwhile.
+        if (!hasConsumers()) {
+            drainFifo();
+            restartCursors();
+            resetStats();
+            analysisThread_.wait(-1);
+            statsStartMs_ = juce::Time::getMillisecondCounterHiRes();
+            continue;
+        }
+
+        const auto workStart = juce::Time::getHighResolutionTicks();
+        drainFifo();
+
+        const auto isMulti = isMultiResolution();
+        const auto numResolutions = isMulti ? resolutions_.size() : size_t{1};
+        auto numTransforms = 0;
+
+        // Each resolution transforms the window that starts at its own cursor, and moves the
+        // cursor on by a hop. One that fell more than a hop behind skips to the newest window
+        // that still lies on its hops.
+        for (size_t r = 0; r < numResolutions; ++r) {
+            auto& resolution = *resolutions_[r];
+            const auto size = static_cast<int>(resolution.size);
+            const auto hopSize = getHopSize(resolution);
+
+            const auto numReady = ringBuffer_.getNumReady(resolution.cursor);
+            if (numReady >= size) {
+                const auto numBehind = numReady - size;
+                ringBuffer_.advance(resolution.cursor, numBehind - numBehind % hopSize);
+                performFFT(resolution);
+                ringBuffer_.advance(resolution.cursor, hopSize);
+                ++numTransforms;
+            }
+        }
+
+        if (numTransforms > 0) {
+            publishPoints(isMulti ? multiResolutionPoints_ : singleResolutionPoints_);
+        }
+
+        updateStats(juce::Time::getHighResolutionTicks() - workStart, numTransforms, numTransforms > 0);
+        analysisThread_.wait(POLL_INTERVAL_MS);
+    }
+}
+
+int SpectrumAnalyzer::getHopSize(const Resolution& resolution) const noexcept {
+    const auto hopFraction = 1.0f - getOverlap();
+    return juce::jmax(1, juce::roundToInt(hopFraction * static_cast<float>(resolution.size)));
 }
 
-void SpectrumAnalyzer::pushBlock(const juce::AudioBuffer<float>& buffer) {
-    ringBuffer_.writeBlock(buffer);
+// Each cursor starts a hop short of a whole window behind the newest sample, so that the first
+// transforms only wait for a hop of new samples.
+void SpectrumAnalyzer::restartCursors() noexcept {
+    for (auto& resolution : resolutions_) {
+        const auto size = static_cast<int>(resolution->size);
+        resolution->cursor = ringBuffer_.createCursor(size - getHopSize(*resolution));
+    }
+}
+
+void SpectrumAnalyzer::drainFifo() {
+    int start1 = 0;
+    int size1 = 0;
+    int start2 = 0;
+    int size2 = 0;
+    fifo_.prepareToRead(fifo_.getNumReady(), start1, size1, start2, size2);
 
-    samplesSinceLastFFT_ += buffer.getNumSamples();
-    const auto hopSize = static_cast<int>(fftSize_);
+    auto* const* channels = fifoBuffer_.getArrayOfWritePointers();
+    const auto numChannels = fifoBuffer_.getNumChannels();
 
-    while (samplesSinceLastFFT_ >= hopSize) {
-        performFFT();
-        samplesSinceLastFFT_ -= hopSize;
+    for (const auto& [start, size] : {std::pair{start1, size1}, std::pair{start2, size2}}) {
+        if (size > 0) {
+            ringBuffer_.writeBlock(juce::AudioBuffer<float>{channels, numChannels, start, size});
+        }
     }
+
+    fifo_.finishedRead(size1 + size2);
 }
 
-void SpectrumAnalyzer::performFFT() {
-    ringBuffer_.copyMostRecentSamplesMono(fftBuffer_.data(), static_cast<int>(fftSize_));
+void SpectrumAnalyzer::performFFT(Resolution& resolution) {
+    const auto size = resolution.size;
+    auto& buffer = resolution.buffer;
+
+    ringBuffer_.copyFromCursorMono(resolution.cursor, buffer.data(), static_cast<int>(size));
 
-    window_.multiplyWithWindowingTable(fftBuffer_.data(), fftSize_);
+    resolution.window.multiplyWithWindowingTable(buffer.data(), size);
 
-    std::fill(fftBuffer_.begin() + static_cast<int>(fftSize_), fftBuffer_.end(), 0.0f);
+    std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(size), buffer.end(), 0.0f);
 
-    fft_.performRealOnlyForwardTransform(fftBuffer_.data());
+    resolution.fft.performRealOnlyForwardTransform(buffer.data());
 
-    const auto numBins = fftSize_ / 2;
-    for (uint32_t bin = 0; bin < numBins; ++bin) {
-        const auto real = fftBuffer_[2 * bin];
-        const auto imag = fftBuffer_[2 * bin + 1];
+    const auto numBins = size / 2;
+    for (size_t bin = 0; bin < numBins; ++bin) {
+        const auto real = buffer[2 * bin];
+        const auto imag = buffer[2 * bin + 1];
         const auto mag  = std::sqrt(real * real + imag * imag);
 
-        magnitudeDb_[bin] = juce::Decibels::gainToDecibels(mag, -120.0f);
+        resolution.magnitudesDb[bin] = juce::Decibels::gainToDecibels(mag, -120.0f) + resolution.levelOffsetDb;
+    }
+}
+
+void SpectrumAnalyzer::publishPoints(const PointMap& points) {
+    auto& levels = magnitudesDb_.getWriteBuffer();
+
+    for (size_t i = 0; i < NUM_POINTS; ++i) {
+        const auto& point = points[i];
+        const auto& magnitudesDb = resolutions_[point.resolution]->magnitudesDb;
+
+        if (point.firstBin <= point.lastBin) {
+            levels[i] = *std::max_element(magnitudesDb.begin() + static_cast<std::ptrdiff_t>(point.firstBin),
+                                          magnitudesDb.begin() + static_cast<std::ptrdiff_t>(point.lastBin) + 1);
+            continue;
+        }
+
+        const auto lower = static_cast<size_t>(point.binPosition);
+        const auto upper = juce::jmin(lower + 1, magnitudesDb.size() - 1);
+        const auto fraction = point.binPosition - static_cast<float>(lower);
+        levels[i] = magnitudesDb[lower] + fraction * (magnitudesDb[upper] - magnitudesDb[lower]);
+    }
+
+    magnitudesDb_.publish();
+}
+
+// Each point covers the frequencies halfway, in log frequency, to its neighbours.
+void SpectrumAnalyzer::buildPointMap(PointMap& points, bool isMultiResolution) const {
+    const auto halfStep = std::pow(MAX_FREQUENCY / MIN_FREQUENCY, 0.5 / static_cast<double>(NUM_POINTS - 1));
+
+    for (size_t i = 0; i < NUM_POINTS; ++i) {
+        const auto frequency = getPointFrequency(i);
+        auto& point = points[i];
+
+        point.resolution = 0;
+        if (isMultiResolution) {
+            for (auto r = resolutions_.size() - 1; r > 0; --r) {
+                if (frequency >= MIN_BINS_BELOW * sampleRate_ / static_cast<double>(resolutions_[r]->size)) {
+                    point.resolution = r;
+                    break;
+                }
+            }
+        }
+
+        const auto binWidth = sampleRate_ / static_cast<double>(resolutions_[point.resolution]->size);
+        const auto lastBin = static_cast<double>(resolutions_[point.resolution]->size / 2 - 1);
+
+        point.binPosition = static_cast<float>(juce::jmin(frequency / binWidth, lastBin));
+        point.firstBin = static_cast<size_t>(std::ceil(juce::jmin(frequency / halfStep / binWidth, lastBin + 1.0)));
+        point.lastBin = static_cast<size_t>(std::floor(juce::jmin(frequency * halfStep / binWidth, lastBin)));
     }
+}
+
+// Starts the measurement over, with nothing to report until the first interval is in.
+void SpectrumAnalyzer::resetStats() noexcept {
+    statsStartMs_ = juce::Time::getMillisecondCounterHiRes();
+    statsWorkTicks_ = 0;
+    statsTransforms_ = 0;
+    statsFrames_ = 0;
+
+    framesPerSecond_.store(0.0, std::memory_order_relaxed);
+    transformsPerSecond_.store(0.0, std::memory_order_relaxed);
+    threadLoad_.store(0.0, std::memory_order_relaxed);
+}
+
+void SpectrumAnalyzer::updateStats(juce::int64 workTicks, int numTransforms, bool published) {
+    statsWorkTicks_ += workTicks;
+    statsTransforms_ += numTransforms;
+    statsFrames_ += published ? 1 : 0;
+
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsedSeconds = (now - statsStartMs_) / 1000.0;
+    if (elapsedSeconds * 1000.0 < STATS_INTERVAL_MS) {
+        return;
+    }
+
+    const auto workSeconds = static_cast<double>(statsWorkTicks_)
+                             / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    framesPerSecond_.store(static_cast<double>(statsFrames_) / elapsedSeconds, std::memory_order_relaxed);
+    transformsPerSecond_.store(static_cast<double>(statsTransforms_) / elapsedSeconds, std::memory_order_relaxed);
+    threadLoad_.store(workSeconds / elapsedSeconds, std::memory_order_relaxed);
 
-    newFFTReady_ = true;
+    statsStartMs_ = now;
+    statsWorkTicks_ = 0;
+    statsTransforms_ = 0;
+    statsFrames_ = 0;
 }
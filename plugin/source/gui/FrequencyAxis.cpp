@@ -11,13 +11,16 @@ void FrequencyAxis::paint(juce::Graphics& g) {
     drawGrid(g, bounds);
     drawZeroLine(g, bounds);
 
+    response_.update(bands_);
+    referenceResponse_.update(referenceBands_);
+
     if (!referenceBands_.empty()) {
-        drawResponse(g, bounds, referenceBands_,
+        drawResponse(g, bounds, referenceResponse_,
                      juce::Colours::darkgrey, 1.5f, 0.7f);
     }
 
     if (!bands_.empty()) {
-        drawResponse(g, bounds, bands_,
+        drawResponse(g, bounds, response_,
                      juce::Colours::orange, 2.0f, 1.0f);
     }
 }
@@ -77,45 +80,36 @@ void FrequencyAxis::drawZeroLine(juce::Graphics& g, juce::Rectangle<float> bound
                      1);
 }
 
+void FrequencyAxis::updateResponses() {
+    const auto changed = response_.update(bands_);
+    if (referenceResponse_.update(referenceBands_) || changed) {
+        repaint();
+    }
+}
+
+// The grid of the response is evenly spaced in log frequency over the axis, so its points are
+// evenly spaced across the bounds.
 void FrequencyAxis::drawResponse(juce::Graphics& g,
                                  juce::Rectangle<float> bounds,
-                                 const std::vector<BiquadFilter*>& bands,
+                                 const ResponseCache& response,
                                  juce::Colour colour,
                                  float thickness,
                                  float alpha)
 {
-    if (bands.empty()) {
-        return;
-    }
-
-    static constexpr auto numPoints = 512;
+    const auto& totalDb = response.getTotalDb();
+    const auto step = bounds.getWidth() / static_cast<float>(ResponseCache::NUM_POINTS - 1);
 
     juce::Path path;
-    bool started = false;
-
-    const auto minFreq = 20.0;
-    const auto maxFreq = 20000.0;
-    const double logMin  = std::log10(minFreq);
-    const double logMax  = std::log10(maxFreq);
-
-    for (int i = 0; i < numPoints; ++i) {
-        const auto t = static_cast<double>(i) / (numPoints - 1);
-        const auto logF = juce::jmap(t,  logMin, logMax);
-        const double freq = std::pow(10.0, logF);
-
-        const auto magDb = getCombinedMagnitudeDbAt(freq, bands);
+    path.preallocateSpace(3 * static_cast<int>(ResponseCache::NUM_POINTS));
 
-        const auto clampedDb = juce::jlimit(minDb_, maxDb_, magDb);
+    for (size_t i = 0; i < ResponseCache::NUM_POINTS; ++i) {
+        const auto clampedDb = juce::jlimit(minDb_, maxDb_, totalDb[i]);
 
-        const auto x = freqmap::frequencyToX(static_cast<float>(freq), bounds);
+        const auto x = bounds.getX() + static_cast<float>(i) * step;
+        const auto y = juce::jmap(clampedDb, minDb_, maxDb_, bounds.getBottom(), bounds.getY());
 
-        const auto yNorm = juce::jmap(clampedDb, minDb_, maxDb_, 1.0f, 0.0f);
-        const auto y = juce::jmap(yNorm, 0.0f, 1.0f,
-                                  bounds.getY(), bounds.getBottom());
-
-        if (!started) {
+        if (i == 0) {
             path.startNewSubPath(x, y);
-            started = true;
         } else {
             path.lineTo(x, y);
         }
@@ -124,19 +118,4 @@ void FrequencyAxis::drawResponse(juce::Graphics& g,
     g.setColour(colour.withAlpha(alpha));
     g.strokePath(path, juce::PathStrokeType(thickness));
 }
-
-
-float FrequencyAxis::getCombinedMagnitudeDbAt(double freqHz,
-                                       const std::vector<BiquadFilter*>& bands) {
-    auto totalGain = 1.0;
-
-    for (auto* b : bands) {
-        if (b != nullptr) {
-            totalGain *= static_cast<double>(b->getMagnitudeAtFrequency(freqHz));
-        }
-    }
-
-    return juce::Decibels::gainToDecibels(static_cast<float>(totalGain));
-}
-
 }  // namespace parametric_eq
@@ -0,0 +1,69 @@
+#include "NIWSParametricEq/gui/ResponseCache.h"
+#include "NIWSParametricEq/gui/FrequencyMapping.h"
+
+namespace parametric_eq {
+ResponseCache::ResponseCache()
+    : frequencies_(NUM_POINTS), totalDb_(NUM_POINTS, 0.0f) {
+    const auto ratio = static_cast<double>(freqmap::maxFreq) / static_cast<double>(freqmap::minFreq);
+
+    for (size_t i = 0; i < NUM_POINTS; ++i) {
+        const auto position = static_cast<double>(i) / static_cast<double>(NUM_POINTS - 1);
+        frequencies_[i] = static_cast<double>(freqmap::minFreq) * std::pow(ratio, position);
+    }
+}
+
+// A band is matched to the one at the same place in the last call. Bands that were added or
+// removed shift the ones after them, which are then evaluated again.
+bool ResponseCache::update(const std::vector<BiquadFilter*>& bands) {
+    auto changed = bands.size() != bands_.size();
+    bands_.resize(bands.size());
+    numEvaluated_ = 0;
+
+    for (size_t i = 0; i < bands.size(); ++i) {
+        if (bands[i] == nullptr || isCurrent(bands_[i], *bands[i])) {
+            continue;
+        }
+
+        evaluate(bands_[i], *bands[i]);
+        ++numEvaluated_;
+        changed = true;
+    }
+
+    if (!changed) {
+        return false;
+    }
+
+    juce::FloatVectorOperations::clear(totalDb_.data(), static_cast<int>(NUM_POINTS));
+
+    for (size_t i = 0; i < bands.size(); ++i) {
+        if (bands[i] != nullptr) {
+            juce::FloatVectorOperations::add(totalDb_.data(), bands_[i].curveDb.data(), static_cast<int>(NUM_POINTS));
+        }
+    }
+
+    return true;
+}
+
+bool ResponseCache::isCurrent(const Band& band, const BiquadFilter& filter) noexcept {
+    const auto c = filter.getCoefficients<double>();
+    const auto& cached = band.coefficients;
+
+    return band.filter == &filter && band.bypassed == filter.isBypassed()
+        && juce::exactlyEqual(band.sampleRate, filter.getSampleRate())
+        && juce::exactlyEqual(c.b0, cached.b0) && juce::exactlyEqual(c.b1, cached.b1)
+        && juce::exactlyEqual(c.b2, cached.b2) && juce::exactlyEqual(c.a1, cached.a1)
+        && juce::exactlyEqual(c.a2, cached.a2);
+}
+
+void ResponseCache::evaluate(Band& band, const BiquadFilter& filter) {
+    band.filter = &filter;
+    band.coefficients = filter.getCoefficients<double>();
+    band.sampleRate = filter.getSampleRate();
+    band.bypassed = filter.isBypassed();
+    band.curveDb.resize(NUM_POINTS);
+
+    for (size_t i = 0; i < NUM_POINTS; ++i) {
+        band.curveDb[i] = filter.getMagnitudeDbAt(frequencies_[i]);
+    }
+}
+}  // namespace parametric_eq
@@ -0,0 +1,137 @@
+#include "NIWSParametricEq/gui/SpectrumDisplay.h"
+#include "NIWSParametricEq/gui/FrequencyMapping.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace parametric_eq {
+namespace {
+constexpr auto NUM_POINTS = SpectrumAnalyzer::NUM_POINTS;
+
+// Each frame is averaged with the one before, which steadies the stems without slowing them much.
+constexpr float FRAME_BLEND = 0.5f;
+
+// Smoothing averages power, which no level below this adds to.
+constexpr double MIN_POWER = 1.0e-12;
+
+int getDivisionsPerOctave(SpectrumDisplay::Smoothing smoothing) noexcept {
+    switch (smoothing) {
+        case SpectrumDisplay::Smoothing::twelfthOctave: return 12;
+        case SpectrumDisplay::Smoothing::sixthOctave: return 6;
+        case SpectrumDisplay::Smoothing::thirdOctave: return 3;
+        case SpectrumDisplay::Smoothing::none: break;
+    }
+
+    return 0;
+}
+}  // namespace
+
+SpectrumDisplay::SpectrumDisplay()
+    : previousDb_(NUM_POINTS, -100.0f),
+      blendedDb_(NUM_POINTS, -100.0f),
+      smoothedDb_(NUM_POINTS, -100.0f),
+      powerSums_(NUM_POINTS + 1, 0.0) {}
+
+// Columns run from the left edge, each covering the points that land within it; the last one
+// also takes the few pixels left over. A column no point lands in, where the points are sparser
+// than the columns, takes the first point to its right.
+void SpectrumDisplay::setBounds(juce::Rectangle<float> bounds) {
+    if (bounds == bounds_) {
+        return;
+    }
+
+    bounds_ = bounds;
+
+    const auto numColumns = static_cast<size_t>(juce::jmax(0.0f, std::floor(bounds.getWidth() / COLUMN_WIDTH)));
+    ranges_.resize(numColumns);
+    columns_.resize(numColumns);
+
+    size_t point = 0;
+    for (size_t c = 0; c < numColumns; ++c) {
+        const auto right = bounds.getX() + static_cast<float>(c + 1) * COLUMN_WIDTH;
+        auto& range = ranges_[c];
+
+        range.firstPoint = juce::jmin(point, NUM_POINTS - 1);
+        while (point < NUM_POINTS
+               && freqmap::frequencyToX(static_cast<float>(SpectrumAnalyzer::getPointFrequency(point)), bounds) < right) {
+            ++point;
+        }
+        range.lastPoint = juce::jmax(range.firstPoint, point > 0 ? point - 1 : 0);
+
+        columns_[c].x = bounds.getX() + (static_cast<float>(c) + 0.5f) * COLUMN_WIDTH;
+    }
+
+    if (numColumns > 0) {
+        ranges_.back().lastPoint = NUM_POINTS - 1;
+    }
+
+    update();
+}
+
+// The points are evenly spaced in log frequency, so a fraction of an octave spans as many of
+// them anywhere in the spectrum.
+void SpectrumDisplay::setSmoothing(Smoothing smoothing) {
+    if (smoothing == smoothing_) {
+        return;
+    }
+
+    smoothing_ = smoothing;
+
+    const auto divisions = getDivisionsPerOctave(smoothing);
+    const auto pointsPerOctave = static_cast<double>(NUM_POINTS - 1)
+                                 / std::log2(SpectrumAnalyzer::MAX_FREQUENCY / SpectrumAnalyzer::MIN_FREQUENCY);
+
+    smoothingHalfWidth_ = divisions > 0
+                              ? static_cast<size_t>(std::lround(pointsPerOctave / static_cast<double>(2 * divisions)))
+                              : 0;
+
+    update();
+}
+
+void SpectrumDisplay::pushFrame(const std::vector<float>& levelsDb) {
+    jassert(levelsDb.size() == NUM_POINTS);
+
+    if (!hasFrame_) {
+        std::copy(levelsDb.begin(), levelsDb.end(), previousDb_.begin());
+        hasFrame_ = true;
+    }
+
+    for (size_t i = 0; i < NUM_POINTS; ++i) {
+        blendedDb_[i] = (1.0f - FRAME_BLEND) * levelsDb[i] + FRAME_BLEND * previousDb_[i];
+    }
+
+    std::copy(levelsDb.begin(), levelsDb.end(), previousDb_.begin());
+    update();
+}
+
+void SpectrumDisplay::update() {
+    smooth();
+
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        const auto& range = ranges_[c];
+        columns_[c].levelDb = *std::max_element(smoothedDb_.begin() + static_cast<std::ptrdiff_t>(range.firstPoint),
+                                                smoothedDb_.begin() + static_cast<std::ptrdiff_t>(range.lastPoint) + 1);
+    }
+}
+
+// Averages the power over the window around each point, in one pass over the running sums of
+// power whatever the width of the window. Near the ends the window is cut short.
+void SpectrumDisplay::smooth() {
+    if (smoothingHalfWidth_ == 0) {
+        std::copy(blendedDb_.begin(), blendedDb_.end(), smoothedDb_.begin());
+        return;
+    }
+
+    for (size_t i = 0; i < NUM_POINTS; ++i) {
+        powerSums_[i + 1] = powerSums_[i] + std::pow(10.0, 0.1 * static_cast<double>(blendedDb_[i]));
+    }
+
+    for (size_t i = 0; i < NUM_POINTS; ++i) {
+        const auto first = i > smoothingHalfWidth_ ? i - smoothingHalfWidth_ : 0;
+        const auto last = juce::jmin(NUM_POINTS - 1, i + smoothingHalfWidth_);
+        const auto power = (powerSums_[last + 1] - powerSums_[first]) / static_cast<double>(last - first + 1);
+
+        smoothedDb_[i] = static_cast<float>(10.0 * std::log10(juce::jmax(power, MIN_POWER)));
+    }
+}
+}  // namespace parametric_eq
@@ -1,5 +1,9 @@
 #include <NIWSParametricEq/PluginProcessor.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
 
 namespace parametric_eq_test {
 TEST(AudioProcessor, Foo) {
@@ -30,4 +34,263 @@ TEST(AudioProcessor, SerializesGainLfoParameters) {
   EXPECT_EQ(restoredPeak.lfo.waveform.getIndex(), 2);
   EXPECT_EQ(restoredPeak.lfo.polarity.getIndex(), 1);
 }
+
+TEST(AudioProcessor, SerializesSteepPassFilters) {
+  parametric_eq::AudioPluginAudioProcessor source{};
+  source.getParameters().lowPassSteep = true;
+
+  juce::MemoryBlock state;
+  source.getStateInformation(state);
+
+  parametric_eq::AudioPluginAudioProcessor restored{};
+  restored.getParameters().highPassSteep = true;
+  restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+  EXPECT_TRUE(restored.getParameters().lowPassSteep.get());
+  EXPECT_FALSE(restored.getParameters().highPassSteep.get());
+}
+
+TEST(AudioProcessor, SerializesOversampling) {
+  parametric_eq::AudioPluginAudioProcessor source{};
+  source.getParameters().oversampling = 2;
+
+  juce::MemoryBlock state;
+  source.getStateInformation(state);
+
+  parametric_eq::AudioPluginAudioProcessor restored{};
+  restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+  EXPECT_EQ(restored.getParameters().oversampling.getIndex(), 2);
+}
+
+TEST(AudioProcessor, SerializesLinearPhase) {
+  parametric_eq::AudioPluginAudioProcessor source{};
+  source.getParameters().linearPhase = true;
+
+  juce::MemoryBlock state;
+  source.getStateInformation(state);
+
+  parametric_eq::AudioPluginAudioProcessor restored{};
+  restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+  EXPECT_TRUE(restored.getParameters().linearPhase.get());
+}
+
+TEST(AudioProcessor, SerializesAnalyzerSmoothing) {
+  parametric_eq::AudioPluginAudioProcessor source{};
+  *source.getParameters().analyzerSmoothing = 3;
+
+  juce::MemoryBlock state;
+  source.getStateInformation(state);
+
+  parametric_eq::AudioPluginAudioProcessor restored{};
+  restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+  EXPECT_EQ(restored.getParameters().analyzerSmoothing->getIndex(), 3);
+}
+
+// Only the peaks in use are stored, wherever they sit in the pool.
+TEST(AudioProcessor, SerializesTheEnabledPeaks) {
+  parametric_eq::AudioPluginAudioProcessor source{};
+  auto& parameters = source.getParameters();
+  *parameters.peakEnabled[1] = false;
+  *parameters.peakEnabled[17] = true;
+  parameters.peakFilters[17]->gain = -4.0f;
+
+  juce::MemoryBlock state;
+  source.getStateInformation(state);
+  EXPECT_FALSE(state.toString().contains("peakFilters"));
+
+  parametric_eq::AudioPluginAudioProcessor restored{};
+  *restored.getParameters().peakEnabled[9] = true;
+  restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+  for (size_t i = 0; i < parametric_eq::ParametricEq::MAX_PEAKS; ++i) {
+    EXPECT_EQ(restored.getParameters().peakEnabled[i]->get(), i == 0 || i == 2 || i == 3 || i == 17) << i;
+  }
+
+  EXPECT_NEAR(restored.getParameters().peakFilters[17]->gain.get(), -4.0f, 0.01f);
+}
+
+TEST(AudioProcessor, ReportsTheOversamplingLatency) {
+  parametric_eq::AudioPluginAudioProcessor processor{};
+  processor.prepareToPlay(48000.0, 512);
+  EXPECT_EQ(processor.getLatencySamples(), 0);
+
+  juce::AudioBuffer<float> buffer{2, 512};
+  juce::MidiBuffer midiMessages;
+  buffer.clear();
+
+  processor.getParameters().oversampling = 1;
+  processor.processBlock(buffer, midiMessages);
+  const auto realtimeLatency = processor.getLatencySamples();
+  EXPECT_GT(realtimeLatency, 0);
+
+  // An offline render of the same setting runs one factor higher, behind longer filters.
+  processor.setNonRealtime(true);
+  processor.processBlock(buffer, midiMessages);
+  EXPECT_GT(processor.getLatencySamples(), realtimeLatency);
+
+  processor.getParameters().oversampling = 0;
+  processor.processBlock(buffer, midiMessages);
+  EXPECT_EQ(processor.getLatencySamples(), 0);
+}
+
+TEST(AudioProcessor, ReportsTheLinearPhaseLatency) {
+  parametric_eq::AudioPluginAudioProcessor processor{};
+  processor.prepareToPlay(48000.0, 512);
+
+  juce::AudioBuffer<float> buffer{2, 512};
+  juce::MidiBuffer midiMessages;
+  buffer.clear();
+
+  processor.getParameters().linearPhase = true;
+  processor.processBlock(buffer, midiMessages);
+  EXPECT_EQ(processor.getLatencySamples(), parametric_eq::LinearPhaseEngine::DEFAULT_LATENCY_SAMPLES);
+
+  processor.getParameters().linearPhase = false;
+  processor.processBlock(buffer, midiMessages);
+  EXPECT_EQ(processor.getLatencySamples(), 0);
+}
+
+// Double-precision hosts get the same signal path, oversampling included, in double.
+TEST(AudioProcessor, DoublePrecisionMatchesSinglePrecision) {
+  parametric_eq::AudioPluginAudioProcessor single{};
+  parametric_eq::AudioPluginAudioProcessor twice{};
+  ASSERT_TRUE(twice.supportsDoublePrecisionProcessing());
+
+  twice.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+  for (auto* processor : {&single, &twice}) {
+    processor->getParameters().oversampling = 1;
+    processor->getParameters().peakFilters[1]->gain = 6.0f;
+    processor->prepareToPlay(48000.0, 512);
+  }
+
+  ASSERT_TRUE(twice.getParametricEq().isUsingDoublePrecision());
+
+  juce::Random random{7};
+  juce::AudioBuffer<float> buffer{2, 512};
+  juce::AudioBuffer<double> doubles{2, 512};
+  juce::MidiBuffer midiMessages;
+
+  for (int block = 0; block < 8; ++block) {
+    for (int ch = 0; ch < 2; ++ch) {
+      for (int n = 0; n < 512; ++n) {
+        const auto sample = 2.0f * random.nextFloat() - 1.0f;
+        buffer.setSample(ch, n, sample);
+        doubles.setSample(ch, n, static_cast<double>(sample));
+      }
+    }
+
+    single.processBlock(buffer, midiMessages);
+    twice.processBlock(doubles, midiMessages);
+    EXPECT_EQ(twice.getLatencySamples(), single.getLatencySamples());
+
+    for (int ch = 0; ch < 2; ++ch) {
+      for (int n = 0; n < 512; ++n) {
+        ASSERT_NEAR(doubles.getSample(ch, n), static_cast<double>(buffer.getSample(ch, n)), 1e-4)
+            << "block " << block << ", channel " << ch << ", sample " << n;
+      }
+    }
+  }
+}
+
+// With every band at 0 dB the plugin only delays, so its output nulls against the input delayed
+// by the latency it reports, in each mode that adds latency. At 32 kHz an offline 8x render leaves
+// the multirate split fewer stages than the oversampler, so the split's latency has to divide
+// down to whole samples as well.
+TEST(AudioProcessor, NullsAgainstTheDelayedInputAtZeroDb) {
+  constexpr int blockSize = 512;
+  constexpr int numBlocks = 16;
+  constexpr double sampleRate = 32000.0;
+  constexpr float amplitude = 0.5f;
+
+  for (const auto linearPhase : {false, true}) {
+    for (const auto oversampling : {1, 2}) {
+      for (const auto offline : {false, true}) {
+        parametric_eq::AudioPluginAudioProcessor processor{};
+        auto& parameters = processor.getParameters();
+        parameters.linearPhase = linearPhase;
+        parameters.oversampling = oversampling;
+        parameters.lowPassParameters.bypassed = true;
+        parameters.highPassParameters.bypassed = true;
+        processor.setNonRealtime(offline);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer{2, blockSize};
+        juce::MidiBuffer midiMessages;
+        std::vector<float> input;
+        std::vector<float> output;
+
+        for (int block = 0; block < numBlocks; ++block) {
+          for (int n = 0; n < blockSize; ++n) {
+            const auto time = static_cast<double>(block * blockSize + n) / sampleRate;
+            const auto sample = amplitude * static_cast<float>(std::sin(2.0 * std::numbers::pi * 1000.0 * time));
+            input.push_back(sample);
+            buffer.setSample(0, n, sample);
+            buffer.setSample(1, n, sample);
+          }
+
+          processor.processBlock(buffer, midiMessages);
+          for (int n = 0; n < blockSize; ++n) {
+            output.push_back(buffer.getSample(0, n));
+          }
+        }
+
+        const auto latency = static_cast<size_t>(processor.getLatencySamples());
+        ASSERT_GT(latency, size_t{0});
+
+        // 60 dB below the tone, after the filters have filled.
+        auto residual = 0.0f;
+        for (auto n = latency + blockSize; n < output.size(); ++n) {
+          residual = std::max(residual, std::abs(output[n] - input[n - latency]));
+        }
+
+        EXPECT_LT(residual, 1e-3f * amplitude)
+            << "linear phase " << linearPhase << ", oversampling " << oversampling << ", offline " << offline;
+      }
+    }
+  }
+}
+
+// The linear-phase path keeps running while bypassed, so un-bypassing fades into the input that
+// came in meanwhile rather than into the audio its delay lines held when bypass engaged.
+TEST(AudioProcessor, UnbypassingBringsBackNoOldAudio) {
+  constexpr int blockSize = 512;
+
+  parametric_eq::AudioPluginAudioProcessor processor{};
+  processor.getParameters().linearPhase = true;
+  processor.prepareToPlay(48000.0, blockSize);
+
+  juce::AudioBuffer<float> buffer{2, blockSize};
+  juce::MidiBuffer midiMessages;
+  juce::Random random{3};
+
+  const auto processBlocks = [&](int numBlocks, bool loud) {
+    for (int block = 0; block < numBlocks; ++block) {
+      for (int ch = 0; ch < 2; ++ch) {
+        for (int n = 0; n < blockSize; ++n) {
+          buffer.setSample(ch, n, loud ? random.nextFloat() - 0.5f : 0.0f);
+        }
+      }
+
+      processor.processBlock(buffer, midiMessages);
+    }
+  };
+
+  processBlocks(8, true);
+  ASSERT_GT(processor.getLatencySamples(), 0);
+
+  // Long enough for the crossfade to finish and the latency to pass.
+  const auto bypassedBlocks = (processor.getLatencySamples() + 48000 / 10) / blockSize + 2;
+  processor.getParameters().bypassed = true;
+  processBlocks(bypassedBlocks, true);
+  processBlocks(bypassedBlocks, false);
+
+  processor.getParameters().bypassed = false;
+  for (int block = 0; block < bypassedBlocks; ++block) {
+    processBlocks(1, false);
+    EXPECT_LT(buffer.getMagnitude(0, blockSize), 1e-4f) << "block " << block;
+  }
+}
 }  // namespace parametric_eq_test
@@ -0,0 +1,314 @@
+#include <NIWSParametricEq/LinearPhaseEngine.h>
+#include <NIWSParametricEq/ParametricEq.h>
+#include <NIWSParametricEq/utils/FastMath.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "TestHelpers.h"
+
+// Timing runs rather than checks, disabled by default. Run them from an optimised build with
+//   --gtest_also_run_disabled_tests --gtest_filter='Benchmark.*'
+namespace parametric_eq_test {
+namespace {
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int BLOCK_SIZE = 512;
+constexpr int NUM_CHANNELS = 2;
+constexpr int NUM_BLOCKS = 4000;
+
+// Nanoseconds per sample per channel for an equaliser with only the two pass bands engaged.
+double timePassBands(int slopeIndex, bool isSteep) {
+  parametric_eq::ParametricEq eq;
+  eq.prepare(SAMPLE_RATE, NUM_CHANNELS);
+
+  for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+    eq.setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band], 1.0, 0.0f, true);
+  }
+
+  eq.setLowShelfParameters(80.0, 1.0, 0.0f, true, 0);
+  eq.setHighShelfParameters(15000.0, 1.0, 0.0f, true, 0);
+  eq.setLowPassParameters(12000.0, 0.7, false, slopeIndex, isSteep);
+  eq.setHighPassParameters(80.0, 0.7, false, slopeIndex, isSteep);
+
+  juce::Random random{3};
+  juce::AudioBuffer<float> buffer{NUM_CHANNELS, BLOCK_SIZE};
+  fillWithNoise(buffer, random);
+
+  for (int block = 0; block < 16; ++block) {
+    eq.processBlock(buffer);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    eq.processBlock(buffer);
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+  return elapsed.count() / (static_cast<double>(NUM_BLOCKS) * BLOCK_SIZE * NUM_CHANNELS);
+}
+
+// Nanoseconds per sample per channel with all four peaks swept continuously, so every band
+// retunes on every sample (control interval 1 for the biquad engine).
+double timeSweptPeaks(parametric_eq::ParametricEq::Engine engine) {
+  parametric_eq::ParametricEq eq;
+  eq.prepare(SAMPLE_RATE, NUM_CHANNELS);
+  eq.setControlInterval(1);
+  eq.setEngine(engine);
+
+  juce::Random random{3};
+  juce::AudioBuffer<float> buffer{NUM_CHANNELS, BLOCK_SIZE};
+  fillWithNoise(buffer, random);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    const auto sweep = 1.0 + static_cast<double>(block % 2);
+
+    for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+      eq.setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band] * sweep, 2.0, 6.0f, false);
+    }
+
+    eq.processBlock(buffer);
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+  return elapsed.count() / (static_cast<double>(NUM_BLOCKS) * BLOCK_SIZE * NUM_CHANNELS);
+}
+
+// Nanoseconds per sample of a mono equaliser with every band engaged and held still, either
+// through ParametricEq, which runs the whole cascade as one pipeline, or band by band.
+double timeMonoCascade(bool bandByBand) {
+  parametric_eq::ParametricEq eq;
+  eq.prepare(SAMPLE_RATE, 1);
+
+  for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+    eq.setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band], 1.0, 4.0f, false);
+  }
+
+  eq.setLowShelfParameters(80.0, 1.0, 3.0f, false, 0);
+  eq.setHighShelfParameters(12000.0, 1.0, -3.0f, false, 0);
+  eq.setLowPassParameters(16000.0, 0.7, false, 3, false);
+  eq.setHighPassParameters(40.0, 0.7, false, 3, false);
+  eq.settleParameters();
+
+  juce::Random random{3};
+  juce::AudioBuffer<float> buffer{1, BLOCK_SIZE};
+  fillWithNoise(buffer, random);
+  const auto bands = eq.getBands();
+
+  const auto process = [&] {
+    if (!bandByBand) {
+      eq.processBlock(buffer);
+      return;
+    }
+
+    for (auto* band : bands) {
+      band->processBlock(buffer);
+    }
+  };
+
+  for (int block = 0; block < 16; ++block) {
+    process();
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    process();
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+  return elapsed.count() / (static_cast<double>(NUM_BLOCKS) * BLOCK_SIZE);
+}
+
+// Nanoseconds per sample per channel with the first numPeaks peaks of the pool enabled and held
+// still, and everything else bypassed.
+double timePeakPool(size_t numPeaks) {
+  parametric_eq::ParametricEq eq;
+  eq.prepare(SAMPLE_RATE, NUM_CHANNELS);
+
+  for (size_t band = 0; band < parametric_eq::ParametricEq::MAX_PEAKS; ++band) {
+    eq.setPeakEnabled(band, band < numPeaks);
+    eq.setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band], 2.0, 3.0f, false);
+  }
+
+  eq.setLowShelfParameters(80.0, 1.0, 0.0f, true, 0);
+  eq.setHighShelfParameters(15000.0, 1.0, 0.0f, true, 0);
+  eq.setLowPassParameters(18000.0, 0.7, true, 0);
+  eq.setHighPassParameters(40.0, 0.7, true, 0);
+
+  juce::Random random{3};
+  juce::AudioBuffer<float> buffer{NUM_CHANNELS, BLOCK_SIZE};
+  fillWithNoise(buffer, random);
+
+  for (int block = 0; block < 16; ++block) {
+    eq.processBlock(buffer);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    eq.processBlock(buffer);
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+  return elapsed.count() / (static_cast<double>(NUM_BLOCKS) * BLOCK_SIZE * NUM_CHANNELS);
+}
+
+// Nanoseconds per sample per channel of a peak retuned on every sample, processed as Filter:
+// PeakFilter designs through a direct call, BiquadFilter through the virtual one.
+template <typename Filter>
+double timeSweptPeakFilter() {
+  PeakFilter peak;
+  peak.prepare(SAMPLE_RATE, NUM_CHANNELS);
+  peak.setParametersAndReset(500.0, 2.0, 6.0f);
+  peak.setControlInterval(1);
+  Filter& filter = peak;
+
+  juce::Random random{3};
+  juce::AudioBuffer<float> buffer{NUM_CHANNELS, BLOCK_SIZE};
+  fillWithNoise(buffer, random);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    peak.setFrequency(block % 2 == 0 ? 4000.0 : 500.0);
+    filter.processBlock(buffer);
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+  return elapsed.count() / (static_cast<double>(NUM_BLOCKS) * BLOCK_SIZE * NUM_CHANNELS);
+}
+
+struct BlockTimes {
+  double mean;
+  double worst;
+};
+
+// Microseconds the audio thread spends per host block of the linear-phase engine. The blocks are
+// paced in real time, so the tail worker gets the time it would have in a host.
+BlockTimes timeLinearPhaseBlocks(int headOrder, int blockSize) {
+  parametric_eq::LinearPhaseEngine engine;
+  engine.setHeadOrder(headOrder);
+  engine.prepare(NUM_CHANNELS);
+
+  juce::Random random{3};
+  juce::AudioBuffer<float> buffer{NUM_CHANNELS, blockSize};
+  const auto blockDuration = std::chrono::duration<double>(blockSize / SAMPLE_RATE);
+  const auto numBlocks = static_cast<int>(2.0 * SAMPLE_RATE) / blockSize;
+
+  BlockTimes times{0.0, 0.0};
+  auto deadline = std::chrono::steady_clock::now();
+
+  for (int block = 0; block < numBlocks; ++block) {
+    fillWithNoise(buffer, random);
+
+    const auto start = std::chrono::steady_clock::now();
+    engine.processBlock(buffer);
+    const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    times.mean += elapsed / numBlocks;
+    times.worst = std::max(times.worst, elapsed);
+
+    deadline += std::chrono::duration_cast<std::chrono::steady_clock::duration>(blockDuration);
+    std::this_thread::sleep_until(deadline);
+  }
+
+  return times;
+}
+
+struct PeakDesign {
+  float b0, b1, b2, a1, a2;
+};
+
+template <typename SinCos, typename DecibelsToGain>
+PeakDesign designPeak(float frequency, float Q, float gainDb, SinCos sinCos, DecibelsToGain decibelsToGain) {
+  const auto w0 = 2.0f * std::numbers::pi_v<float> * frequency / static_cast<float>(SAMPLE_RATE);
+  const auto [sin_w, cos_w] = sinCos(w0);
+  const auto A = decibelsToGain(0.5f * gainDb);
+  const auto alpha = sin_w / (2.0f * Q);
+  const auto a0 = 1.0f + alpha / A;
+  return {(1.0f + alpha * A) / a0, -2.0f * cos_w / a0, (1.0f - alpha * A) / a0, -2.0f * cos_w / a0,
+          (1.0f - alpha / A) / a0};
+}
+
+// Nanoseconds per peak design while frequency and gain sweep, the way a smoothed glide drives them.
+template <typename SinCos, typename DecibelsToGain>
+double timePeakDesigns(SinCos sinCos, DecibelsToGain decibelsToGain) {
+  constexpr int numDesigns = 10'000'000;
+  auto sink = 0.0f;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < numDesigns; ++i) {
+    const auto position = static_cast<float>(i % 1000) / 1000.0f;
+    const auto design = designPeak(20.0f + 19980.0f * position, 2.0f, -24.0f + 48.0f * position, sinCos,
+                                   decibelsToGain);
+    sink += design.b0 + design.b1 + design.b2 + design.a1 + design.a2;
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+  EXPECT_TRUE(std::isfinite(sink));
+  return elapsed.count() / numDesigns;
+}
+}  // namespace
+
+TEST(Benchmark, DISABLED_FastMathCoefficientDesign) {
+  const auto libm = timePeakDesigns(
+      [](float w0) { return fast_math::SinCos{std::sin(w0), std::cos(w0)}; },
+      [](float decibels) { return std::pow(10.0f, decibels / 20.0f); });
+  const auto fast = timePeakDesigns(fast_math::sinCos, fast_math::decibelsToGain);
+
+  std::cout << "Peak design: libm " << libm << " ns, fast_math " << fast << " ns per recompute\n";
+}
+
+TEST(Benchmark, DISABLED_SteepPassFiltersAgainstButterworthStack) {
+  const std::array<const char*, 5> slopeNames{"12dB/oct", "24dB/oct", "36dB/oct", "48dB/oct", "96dB/oct"};
+
+  for (int slope = 0; slope < static_cast<int>(slopeNames.size()); ++slope) {
+    const auto butterworth = timePassBands(slope, false);
+    const auto steep = timePassBands(slope, true);
+
+    std::cout << slopeNames[static_cast<size_t>(slope)] << ": Butterworth " << butterworth
+              << " ns, steep " << steep << " ns per sample per channel\n";
+  }
+}
+
+TEST(Benchmark, DISABLED_LinearPhaseHeadSizes) {
+  for (int headOrder = parametric_eq::LinearPhaseEngine::MIN_HEAD_ORDER;
+       headOrder <= parametric_eq::LinearPhaseEngine::MAX_HEAD_ORDER; headOrder += 2) {
+    for (const auto blockSize : {64, 256, 1024}) {
+      const auto times = timeLinearPhaseBlocks(headOrder, blockSize);
+
+      std::cout << "Head " << (1 << headOrder) << ", block " << blockSize << ": mean " << times.mean
+                << " us, worst " << times.worst << " us per block\n";
+    }
+  }
+}
+
+TEST(Benchmark, DISABLED_PeakPoolCostFollowsTheBandsInUse) {
+  for (const auto numPeaks : {size_t{0}, size_t{4}, size_t{12}, parametric_eq::ParametricEq::MAX_PEAKS}) {
+    std::cout << numPeaks << " peaks enabled: " << timePeakPool(numPeaks) << " ns per sample per channel\n";
+  }
+}
+
+TEST(Benchmark, DISABLED_MonoPipelineAgainstBandByBand) {
+  const auto bandByBand = timeMonoCascade(true);
+  const auto pipelined = timeMonoCascade(false);
+
+  std::cout << "Mono cascade: band by band " << bandByBand << " ns, pipelined " << pipelined
+            << " ns per sample (" << bandByBand / pipelined << "x)\n";
+}
+
+TEST(Benchmark, DISABLED_StaticAgainstVirtualDesign) {
+  const auto erased = timeSweptPeakFilter<BiquadFilter>();
+  const auto concrete = timeSweptPeakFilter<PeakFilter>();
+
+  std::cout << "Swept peak: through BiquadFilter " << erased << " ns, through PeakFilter " << concrete
+            << " ns per sample per channel (" << erased / concrete << "x)\n";
+}
+
+TEST(Benchmark, DISABLED_StateVariableEngineUnderModulation) {
+  const auto biquad = timeSweptPeaks(parametric_eq::ParametricEq::Engine::biquad);
+  const auto stateVariable = timeSweptPeaks(parametric_eq::ParametricEq::Engine::stateVariable);
+
+  std::cout << "Swept peaks: biquad " << biquad << " ns, state-variable " << stateVariable
+            << " ns per sample per channel\n";
+}
+}  // namespace parametric_eq_test
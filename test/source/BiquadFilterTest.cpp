@@ -0,0 +1,325 @@
+#include <NIWSParametricEq/filters/PeakFilter.h>
+#include <NIWSParametricEq/filters/LowPassFilter.h>
+#include <NIWSParametricEq/filters/PassFilterCascade.h>
+#include <gtest/gtest.h>
+
+#include "TestHelpers.h"
+
+namespace parametric_eq_test {
+namespace {
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int BLOCK_SIZE = 256;
+constexpr int NUM_BLOCKS = 8;
+
+template <typename Filter>
+void expectMultichannelMatchesMono(int numChannels) {
+  Filter multichannel;
+  multichannel.prepare(SAMPLE_RATE, numChannels);
+  multichannel.setParametersAndReset(1000.0, 0.7, 6.0f);
+
+  std::vector<Filter> mono(static_cast<size_t>(numChannels));
+  for (auto& filter : mono) {
+    filter.prepare(SAMPLE_RATE, 1);
+    filter.setParametersAndReset(1000.0, 0.7, 6.0f);
+  }
+
+  juce::Random random{1234};
+  juce::AudioBuffer<float> buffer{numChannels, BLOCK_SIZE};
+  juce::AudioBuffer<float> monoBuffer{1, BLOCK_SIZE};
+
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    // Move the parameters mid-run so the smoothed coefficient path is exercised as well.
+    const auto frequency = block < NUM_BLOCKS / 2 ? 1000.0 : 4000.0;
+    const auto bypassed = block == NUM_BLOCKS - 2;
+
+    fillWithNoise(buffer, random);
+    juce::AudioBuffer<float> expected{numChannels, BLOCK_SIZE};
+    expected.makeCopyOf(buffer);
+
+    multichannel.setFrequency(frequency);
+    multichannel.setAmplitude40(-9.0f);
+    multichannel.setBypassed(bypassed);
+    multichannel.processBlock(buffer);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      auto& filter = mono[static_cast<size_t>(ch)];
+      filter.setFrequency(frequency);
+      filter.setAmplitude40(-9.0f);
+      filter.setBypassed(bypassed);
+
+      monoBuffer.copyFrom(0, 0, expected, ch, 0, BLOCK_SIZE);
+      filter.processBlock(monoBuffer);
+
+      for (int n = 0; n < BLOCK_SIZE; ++n) {
+        ASSERT_NEAR(buffer.getSample(ch, n), monoBuffer.getSample(0, n), 1e-6f)
+            << "channels " << numChannels << ", channel " << ch << ", block " << block
+            << ", sample " << n;
+      }
+    }
+  }
+}
+
+// Counts how often the coefficients are redesigned, using peak filter maths.
+class CountingPeakFilter : public BiquadFilter {
+public:
+  int numDesigns = 0;
+
+private:
+  void calculateAndSetCoefficients(float Q, float amplitude, float frequency) override {
+    ++numDesigns;
+    const auto c = designPeak(Q, amplitude, frequency);
+    setCoefficients(c);
+  }
+
+  Coefficients designPeak(float Q, float A, float frequency) const {
+    const auto w0 = 2.0f * std::numbers::pi_v<float> * frequency / static_cast<float>(sampleRate_);
+    const auto alpha = std::sin(w0) / (2.0f * Q);
+    const auto a0 = 1.0f + alpha / A;
+    return {(1.0f + alpha * A) / a0, -2.0f * std::cos(w0) / a0, (1.0f - alpha * A) / a0,
+            -2.0f * std::cos(w0) / a0, (1.0f - alpha / A) / a0};
+  }
+};
+
+// Filter is the concrete type or BiquadFilter, which designs through the virtual call.
+template <typename Filter>
+void runSweep(Filter& filter, juce::AudioBuffer<float>& buffer, int numBlocks) {
+  juce::Random random{7};
+  for (int block = 0; block < numBlocks; ++block) {
+    fillWithNoise(buffer, random);
+    filter.setFrequency(block < numBlocks / 2 ? 500.0 : 6000.0);
+    filter.setAmplitude40(block < numBlocks / 2 ? 9.0f : -9.0f);
+    filter.processBlock(buffer);
+  }
+}
+}  // namespace
+
+TEST(BiquadFilter, ControlRateRampTracksPerSampleDesign) {
+  PeakFilter perSample;
+  PeakFilter controlRate;
+  for (auto* filter : {&perSample, &controlRate}) {
+    filter->prepare(SAMPLE_RATE, 1);
+    filter->setParametersAndReset(500.0, 1.0, 9.0f);
+  }
+  controlRate.setControlInterval(32);
+
+  // Every block of the sweep is compared. The glides take 10 ms, under two blocks from each
+  // change; while they run, the ramp between control-rate designs strays from the per-sample
+  // design by up to about -45 dB of full scale, and by less than 1e-3 once they end.
+  juce::Random random{7};
+  juce::AudioBuffer<float> perSampleBuffer{1, BLOCK_SIZE};
+  juce::AudioBuffer<float> controlRateBuffer{1, BLOCK_SIZE};
+
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    fillWithNoise(perSampleBuffer, random);
+    controlRateBuffer.makeCopyOf(perSampleBuffer);
+
+    for (auto* filter : {&perSample, &controlRate}) {
+      filter->setFrequency(block < NUM_BLOCKS / 2 ? 500.0 : 6000.0);
+      filter->setAmplitude40(block < NUM_BLOCKS / 2 ? 9.0f : -9.0f);
+    }
+
+    perSample.processBlock(perSampleBuffer);
+    controlRate.processBlock(controlRateBuffer);
+
+    const auto tolerance = block % (NUM_BLOCKS / 2) < 2 ? 1e-2f : 1e-3f;
+    for (int n = 0; n < BLOCK_SIZE; ++n) {
+      ASSERT_NEAR(perSampleBuffer.getSample(0, n), controlRateBuffer.getSample(0, n), tolerance)
+          << "block " << block << ", sample " << n;
+    }
+  }
+
+  // Once the smoothing has settled both modes land on exactly the same design.
+  for (auto frequency : {100.0, 1000.0, 6000.0, 15000.0}) {
+    EXPECT_NEAR(perSample.getMagnitudeDbAt(frequency), controlRate.getMagnitudeDbAt(frequency), 1e-4f);
+  }
+}
+
+TEST(BiquadFilter, ControlRateDesignsOncePerIntervalAndNotWhenSettled) {
+  CountingPeakFilter filter;
+  filter.prepare(SAMPLE_RATE, 1);
+  filter.setParametersAndReset(500.0, 1.0, 0.0f);
+  filter.setControlInterval(32);
+
+  juce::AudioBuffer<float> buffer{1, BLOCK_SIZE};
+  filter.numDesigns = 0;
+  runSweep(filter, buffer, 4);
+
+  // Two 10 ms glides at 48 kHz are 960 samples, i.e. 30 control intervals plus the two
+  // re-designs triggered directly by the frequency changes.
+  EXPECT_LE(filter.numDesigns, 34);
+  EXPECT_GT(filter.numDesigns, 0);
+
+  for (int block = 0; block < 4; ++block) {
+    filter.processBlock(buffer);
+  }
+
+  filter.numDesigns = 0;
+  filter.processBlock(buffer);
+  EXPECT_EQ(filter.numDesigns, 0);
+}
+
+// Processing through the concrete type only changes how the design is called.
+TEST(BiquadFilter, ConcreteTypeMatchesTheBiquadFilterInterface) {
+  for (const auto controlInterval : {1, 32}) {
+    PeakFilter concrete;
+    PeakFilter erased;
+    for (auto* filter : {&concrete, &erased}) {
+      filter->prepare(SAMPLE_RATE, 2);
+      filter->setParametersAndReset(500.0, 1.0, 9.0f);
+      filter->setControlInterval(controlInterval);
+    }
+
+    juce::AudioBuffer<float> concreteBuffer{2, BLOCK_SIZE};
+    juce::AudioBuffer<float> erasedBuffer{2, BLOCK_SIZE};
+    runSweep(concrete, concreteBuffer, 8);
+    runSweep<BiquadFilter>(erased, erasedBuffer, 8);
+
+    for (int ch = 0; ch < 2; ++ch) {
+      for (int n = 0; n < BLOCK_SIZE; ++n) {
+        ASSERT_EQ(concreteBuffer.getSample(ch, n), erasedBuffer.getSample(ch, n))
+            << "interval " << controlInterval << ", channel " << ch << ", sample " << n;
+      }
+    }
+  }
+}
+
+TEST(BiquadFilter, MultichannelKernelMatchesScalarKernel) {
+  for (int numChannels = 2; numChannels <= 8; ++numChannels) {
+    expectMultichannelMatchesMono<PeakFilter>(numChannels);
+    expectMultichannelMatchesMono<LowPassFilter>(numChannels);
+  }
+}
+
+TEST(BiquadFilter, ProcessesChannelCountsBeyondSimdWidth) {
+  expectMultichannelMatchesMono<PeakFilter>(12);
+}
+
+namespace {
+float getStackMagnitudeDb(PassFilterCascade& stack, double frequency) {
+  auto magnitude = 1.0;
+  for (int i = 0; i < stack.getNumSections(); ++i) {
+    magnitude *= static_cast<double>(stack.getSection(static_cast<size_t>(i)).getMagnitudeAtFrequency(frequency));
+  }
+  return static_cast<float>(juce::Decibels::gainToDecibels(magnitude));
+}
+}  // namespace
+
+// A 10 Hz cutoff at 192 kHz puts the poles within 1e-3 of z = 1, where float coefficients no
+// longer hold the response: the design is off by decibels at DC. In double it is exact, and
+// running a double buffer through it keeps the DC gain at unity.
+TEST(BiquadFilter, DoublePrecisionHoldsLowCutoffs) {
+  constexpr double highRate = 192000.0;
+
+  LowPassFilter filter;
+  filter.setDoublePrecision(true);
+  filter.prepare(highRate, 2);
+  filter.setParametersAndReset(10.0, std::sqrt(0.5));
+
+  EXPECT_NEAR(filter.getMagnitudeDbAt(10.0), -3.0103f, 1e-3f);
+  EXPECT_NEAR(filter.getMagnitudeDbAt(1.0), 0.0f, 1e-3f);
+
+  juce::AudioBuffer<double> dc{2, static_cast<int>(highRate)};
+  for (int ch = 0; ch < 2; ++ch) {
+    std::fill_n(dc.getWritePointer(ch), dc.getNumSamples(), 1.0);
+  }
+
+  filter.processBlock(dc);
+
+  for (int ch = 0; ch < 2; ++ch) {
+    EXPECT_NEAR(dc.getSample(ch, dc.getNumSamples() - 1), 1.0, 1e-6) << ch;
+  }
+}
+
+TEST(PassFilterCascade, SectionsFollowTheButterworthTable) {
+  for (int numSections = 1; numSections <= PassFilterCascade::MAX_SECTIONS; ++numSections) {
+    PassFilterCascade lowPass{PassFilterCascade::Type::lowPass};
+    lowPass.prepare(SAMPLE_RATE, 1);
+    lowPass.setNumSections(numSections);
+    lowPass.setParametersAndReset(1000.0, std::numbers::sqrt2 / 2.0);
+
+    PassFilterCascade highPass{PassFilterCascade::Type::highPass};
+    highPass.prepare(SAMPLE_RATE, 1);
+    highPass.setNumSections(numSections);
+    highPass.setParametersAndReset(1000.0, std::numbers::sqrt2 / 2.0);
+
+    // Maximally flat: -3 dB at the cutoff for every order, and flat well inside the passband.
+    EXPECT_NEAR(getStackMagnitudeDb(lowPass, 1000.0), -3.01f, 0.02f) << numSections << " sections";
+    EXPECT_NEAR(getStackMagnitudeDb(highPass, 1000.0), -3.01f, 0.02f) << numSections << " sections";
+    EXPECT_NEAR(getStackMagnitudeDb(lowPass, 250.0), 0.0f, 0.05f) << numSections << " sections";
+    EXPECT_NEAR(getStackMagnitudeDb(highPass, 4000.0), 0.0f, 0.05f) << numSections << " sections";
+  }
+}
+
+TEST(PassFilterCascade, FollowersTrackTheLeaderThroughGlides) {
+  PassFilterCascade gliding{PassFilterCascade::Type::lowPass};
+  gliding.prepare(SAMPLE_RATE, 1);
+  gliding.setNumSections(4);
+  gliding.setParametersAndReset(1000.0, 0.7);
+  gliding.setControlInterval(32);
+
+  gliding.setFrequency(5000.0);
+  gliding.setQ(1.2);
+
+  juce::AudioBuffer<float> frame{1, 1};
+  for (int n = 0; n < 4 * BLOCK_SIZE; ++n) {
+    for (int i = 0; i < gliding.getNumSections(); ++i) {
+      gliding.getSection(static_cast<size_t>(i)).processBlock(frame);
+    }
+  }
+
+  PassFilterCascade settled{PassFilterCascade::Type::lowPass};
+  settled.prepare(SAMPLE_RATE, 1);
+  settled.setNumSections(4);
+  settled.setParametersAndReset(5000.0, 1.2);
+
+  for (size_t i = 0; i < 4; ++i) {
+    const auto actual = gliding.getSection(i).getCoefficients();
+    const auto expected = settled.getSection(i).getCoefficients();
+    EXPECT_NEAR(actual.b0, expected.b0, 1e-6f) << "section " << i;
+    EXPECT_NEAR(actual.b1, expected.b1, 1e-6f) << "section " << i;
+    EXPECT_NEAR(actual.a1, expected.a1, 1e-6f) << "section " << i;
+    EXPECT_NEAR(actual.a2, expected.a2, 1e-6f) << "section " << i;
+  }
+}
+
+TEST(PassFilterCascade, EllipticPrototypeMeetsItsSpecification) {
+  for (int numSections = 1; numSections <= EllipticPrototype::MAX_SECTIONS; ++numSections) {
+    const auto attenuationDb = 24.0 * numSections;
+    const auto prototype = EllipticPrototype::design(numSections, 0.1, attenuationDb);
+    ASSERT_EQ(prototype.numSections, numSections);
+
+    for (auto omega = 0.0; omega <= 1.0; omega += 0.01) {
+      EXPECT_GE(juce::Decibels::gainToDecibels(prototype.getMagnitude(omega)), -0.1 - 1e-6) << "omega " << omega;
+    }
+
+    EXPECT_LT(prototype.stopbandEdge, 6.0);
+    for (auto omega = prototype.stopbandEdge * 1.0001; omega <= 100.0; omega *= 1.01) {
+      EXPECT_LE(juce::Decibels::gainToDecibels(prototype.getMagnitude(omega)), -attenuationDb + 1e-6)
+          << numSections << " sections, omega " << omega;
+    }
+  }
+}
+
+TEST(PassFilterCascade, SteepModeReachesTheStopbandWithinAnOctave) {
+  const auto prototype = EllipticPrototype::design(4, 0.1, 96.0);
+
+  PassFilterCascade lowPass{PassFilterCascade::Type::lowPass};
+  lowPass.prepare(SAMPLE_RATE, 1);
+  lowPass.setSteepPrototype(&prototype);
+  lowPass.setParametersAndReset(2000.0, 0.7);
+
+  PassFilterCascade highPass{PassFilterCascade::Type::highPass};
+  highPass.prepare(SAMPLE_RATE, 1);
+  highPass.setSteepPrototype(&prototype);
+  highPass.setParametersAndReset(2000.0, 0.7);
+
+  ASSERT_EQ(lowPass.getNumSections(), 4);
+  EXPECT_NEAR(getStackMagnitudeDb(lowPass, 1000.0), 0.0f, 0.11f);
+  EXPECT_NEAR(getStackMagnitudeDb(lowPass, 2000.0), -0.1f, 0.02f);
+  EXPECT_LT(getStackMagnitudeDb(lowPass, 4000.0), -90.0f);
+
+  EXPECT_NEAR(getStackMagnitudeDb(highPass, 4000.0), 0.0f, 0.11f);
+  EXPECT_NEAR(getStackMagnitudeDb(highPass, 2000.0), -0.1f, 0.02f);
+  EXPECT_LT(getStackMagnitudeDb(highPass, 1000.0), -90.0f);
+}
+}  // namespace parametric_eq_test
@@ -0,0 +1,98 @@
+#include <NIWSParametricEq/filters/LowPassFilter.h>
+#include <NIWSParametricEq/filters/PeakFilter.h>
+#include <NIWSParametricEq/utils/FastMath.h>
+#include <gtest/gtest.h>
+
+namespace parametric_eq_test {
+namespace {
+// The designs as they were before fast_math, for comparison.
+class LibmPeakFilter : public BiquadFilter {
+  void calculateAndSetCoefficients(float Q, float A, float frequency) override {
+    const auto w0 = 2.0f * std::numbers::pi_v<float> * frequency / static_cast<float>(sampleRate_);
+    const auto cos_w = std::cos(w0);
+    const auto alpha = std::sin(w0) / (2.0f * Q);
+    const auto a0 = 1.0f + alpha / A;
+    setCoefficients(Coefficients{(1.0f + alpha * A) / a0, -2.0f * cos_w / a0, (1.0f - alpha * A) / a0,
+                                 -2.0f * cos_w / a0, (1.0f - alpha / A) / a0});
+  }
+};
+
+class LibmLowPassFilter : public BiquadFilter {
+  void calculateAndSetCoefficients(float Q, float A, float frequency) override {
+    juce::ignoreUnused(A);
+    const auto w0 = 2.0f * std::numbers::pi_v<float> * frequency / static_cast<float>(sampleRate_);
+    const auto cos_w = std::cos(w0);
+    const auto alpha = std::sin(w0) / (2.0f * Q);
+    const auto a0 = 1.0f + alpha;
+    setCoefficients(Coefficients{(1.0f - cos_w) / 2.0f / a0, (1.0f - cos_w) / a0, (1.0f - cos_w) / 2.0f / a0,
+                                 -2.0f * cos_w / a0, (1.0f - alpha) / a0});
+  }
+};
+
+template <typename Fast, typename Reference>
+void expectMatchingMagnitudes(double sampleRate, double frequency, double Q, float gainDb) {
+  Fast fast;
+  fast.prepare(sampleRate, 1);
+  fast.setParametersAndReset(frequency, Q);
+  fast.setAmplitude40(gainDb);
+
+  Reference reference;
+  reference.prepare(sampleRate, 1);
+  reference.setParametersAndReset(frequency, Q);
+  reference.setAmplitude40(gainDb);
+
+  juce::AudioBuffer<float> buffer{1, 4096};
+  buffer.clear();
+  fast.processBlock(buffer);
+  reference.processBlock(buffer);
+
+  // Below a few hundred Hz one ulp of cos(w0) already moves the centre by a fraction of a Hz,
+  // which shows on the skirts of narrow peaks; neither design is more accurate there.
+  const auto tolerance = frequency >= 200.0 ? 0.002f : 0.25f;
+
+  for (auto f = 20.0; f <= 20000.0; f *= 1.05) {
+    const auto expected = reference.getMagnitudeDbAt(f);
+    if (expected < -60.0f) {
+      continue;
+    }
+
+    ASSERT_NEAR(fast.getMagnitudeDbAt(f), expected, tolerance)
+        << "fs " << sampleRate << ", f0 " << frequency << ", Q " << Q << ", gain " << gainDb << ", at " << f;
+  }
+}
+}  // namespace
+
+TEST(FastMath, TrigMatchesLibm) {
+  for (auto w0 = 0.0f; w0 <= std::numbers::pi_v<float>; w0 += 1e-4f) {
+    const auto [s, c] = fast_math::sinCos(w0);
+    ASSERT_NEAR(s, std::sin(w0), 3e-7f) << w0;
+    ASSERT_NEAR(c, std::cos(w0), 3e-7f) << w0;
+  }
+
+  for (auto x = 1e-4f; x < 0.49f * std::numbers::pi_v<float>; x += 1e-4f) {
+    ASSERT_NEAR(fast_math::tan(x) / std::tan(x), 1.0f, 1e-6f) << x;
+  }
+}
+
+TEST(FastMath, DecibelsToGainMatchesPow) {
+  EXPECT_EQ(fast_math::decibelsToGain(0.0f), 1.0f);
+
+  for (auto db = -96.0f; db <= 96.0f; db += 0.01f) {
+    const auto expected = std::pow(10.0f, db / 20.0f);
+    ASSERT_NEAR(fast_math::decibelsToGain(db) / expected, 1.0f, 2e-6f) << db;
+  }
+}
+
+TEST(FastMath, DesignsMatchLibmMagnitudeResponse) {
+  for (auto sampleRate : {44100.0, 48000.0, 96000.0}) {
+    for (auto frequency = 20.0; frequency <= 20000.0; frequency *= 1.25) {
+      for (auto Q : {0.1, 0.7, 2.0, 8.0, 20.0}) {
+        for (auto gainDb : {-24.0f, -6.0f, 3.0f, 24.0f}) {
+          expectMatchingMagnitudes<PeakFilter, LibmPeakFilter>(sampleRate, frequency, Q, gainDb);
+        }
+        expectMatchingMagnitudes<LowPassFilter, LibmLowPassFilter>(sampleRate, frequency, Q, 0.0f);
+      }
+    }
+  }
+}
+}  // namespace parametric_eq_test
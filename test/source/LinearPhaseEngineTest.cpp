@@ -0,0 +1,182 @@
+#include <NIWSParametricEq/LinearPhaseEngine.h>
+#include <NIWSParametricEq/filters/HighPassFilter.h>
+#include <NIWSParametricEq/filters/LowShelfFilter.h>
+#include <NIWSParametricEq/filters/PeakFilter.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <complex>
+#include <thread>
+
+#include "TestHelpers.h"
+
+namespace parametric_eq_test {
+namespace {
+using parametric_eq::LinearPhaseEngine;
+
+constexpr double SAMPLE_RATE = 48000.0;
+
+// Feeds silence until the kernel for the last response has been designed and faded in.
+void waitForKernel(LinearPhaseEngine& engine) {
+  juce::AudioBuffer<float> silence{2, engine.getHeadPartitionSize()};
+
+  for (int i = 0; i < 5000 && engine.isUpdatingKernel(); ++i) {
+    silence.clear();
+    engine.processBlock(silence);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  ASSERT_FALSE(engine.isUpdatingKernel());
+}
+
+juce::AudioBuffer<float> getImpulseResponse(LinearPhaseEngine& engine, int length, int blockSize) {
+  engine.reset();
+
+  juce::AudioBuffer<float> response{2, length};
+  response.clear();
+  response.setSample(0, 0, 1.0f);
+  response.setSample(1, 0, 1.0f);
+
+  for (int start = 0; start < length; start += blockSize) {
+    juce::AudioBuffer<float> block{response.getArrayOfWritePointers(), 2, start, juce::jmin(blockSize, length - start)};
+    engine.processBlock(block);
+  }
+
+  return response;
+}
+
+float getMeasuredMagnitudeDb(const juce::AudioBuffer<float>& impulseResponse, double frequency) {
+  const auto w = 2.0 * std::numbers::pi * frequency / SAMPLE_RATE;
+  auto sum = std::complex<double>{};
+
+  for (int n = 0; n < impulseResponse.getNumSamples(); ++n) {
+    sum += static_cast<double>(impulseResponse.getSample(0, n)) * std::polar(1.0, -w * static_cast<double>(n));
+  }
+
+  return juce::Decibels::gainToDecibels(static_cast<float>(std::abs(sum)), -200.0f);
+}
+}  // namespace
+
+TEST(LinearPhaseEngine, StartsAsAPureDelay) {
+  LinearPhaseEngine engine;
+  engine.prepare(2);
+
+  const auto latency = engine.getLatencySamples();
+  const auto response = getImpulseResponse(engine, 2 * latency, 512);
+
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int n = 0; n < response.getNumSamples(); ++n) {
+      ASSERT_NEAR(response.getSample(ch, n), n == latency ? 1.0f : 0.0f, 1e-5f) << "channel " << ch << ", sample " << n;
+    }
+  }
+}
+
+TEST(LinearPhaseEngine, RendersTheCascadeMagnitudeWithLinearPhase) {
+  const auto peak = makeFilter<PeakFilter>(SAMPLE_RATE, 1000.0, 1.0, 9.0f);
+  const auto shelf = makeFilter<LowShelfFilter>(SAMPLE_RATE, 250.0, 0.7, -6.0f);
+  const auto highPass = makeFilter<HighPassFilter>(SAMPLE_RATE, 60.0, 0.7, 0.0f);
+
+  LinearPhaseEngine::Response cascade;
+  for (const BiquadFilter* filter : {static_cast<const BiquadFilter*>(&peak), static_cast<const BiquadFilter*>(&shelf),
+                                     static_cast<const BiquadFilter*>(&highPass)}) {
+    cascade.sections[cascade.numSections++] = filter->getCoefficients();
+  }
+
+  LinearPhaseEngine engine;
+  engine.prepare(2);
+  engine.setResponse(cascade);
+  waitForKernel(engine);
+
+  const auto latency = engine.getLatencySamples();
+  const auto response = getImpulseResponse(engine, 2 * latency, 512);
+
+  // Symmetric about the latency, which makes the phase linear.
+  for (int m = 1; m < latency - engine.getHeadPartitionSize(); ++m) {
+    ASSERT_NEAR(response.getSample(0, latency + m), response.getSample(0, latency - m), 1e-5f) << m;
+  }
+
+  for (auto f = 150.0; f <= 20000.0; f *= 1.1) {
+    const auto expected = peak.getMagnitudeDbAt(f) + shelf.getMagnitudeDbAt(f) + highPass.getMagnitudeDbAt(f);
+    ASSERT_NEAR(getMeasuredMagnitudeDb(response, f), expected, 0.01f) << f;
+  }
+}
+
+// The head size only moves the kernel, by the difference in latency. The tail is handed to the
+// worker as many times as there are tail partitions in the kernel, so this runs through the
+// deadline on both the worker and the audio thread.
+TEST(LinearPhaseEngine, EveryHeadSizeRendersTheSameKernel) {
+  LinearPhaseEngine::Response cascade;
+  cascade.sections[0] = makeFilter<PeakFilter>(SAMPLE_RATE, 80.0, 4.0, 12.0f).getCoefficients();
+  cascade.sections[1] = makeFilter<LowShelfFilter>(SAMPLE_RATE, 400.0, 0.7, -4.0f).getCoefficients();
+  cascade.numSections = 2;
+
+  LinearPhaseEngine reference;
+  reference.prepare(2);
+  reference.setResponse(cascade);
+  waitForKernel(reference);
+
+  const auto length = 2 * reference.getLatencySamples();
+  const auto expected = getImpulseResponse(reference, length, 512);
+
+  for (int order = LinearPhaseEngine::MIN_HEAD_ORDER; order <= LinearPhaseEngine::MAX_HEAD_ORDER; ++order) {
+    LinearPhaseEngine engine;
+    engine.setHeadOrder(order);
+    engine.prepare(2);
+    engine.setResponse(cascade);
+    waitForKernel(engine);
+
+    ASSERT_EQ(engine.getHeadPartitionSize(), 1 << order);
+    const auto shift = engine.getLatencySamples() - reference.getLatencySamples();
+    const auto response = getImpulseResponse(engine, length + shift, 512);
+
+    for (int n = juce::jmax(0, -shift); n < length; ++n) {
+      ASSERT_NEAR(response.getSample(0, n + shift), expected.getSample(0, n), 1e-5f) << "order " << order << ", sample " << n;
+    }
+  }
+}
+
+// Changing the head size takes a new prepare, which redesigns the kernel that was rendered.
+TEST(LinearPhaseEngine, RepartitioningKeepsTheResponse) {
+  LinearPhaseEngine::Response cascade;
+  cascade.sections[0] = makeFilter<PeakFilter>(SAMPLE_RATE, 500.0, 1.0, 6.0f).getCoefficients();
+  cascade.numSections = 1;
+
+  LinearPhaseEngine engine;
+  engine.prepare(2);
+  engine.setResponse(cascade);
+  waitForKernel(engine);
+
+  engine.setHeadOrder(LinearPhaseEngine::MIN_HEAD_ORDER);
+  engine.prepare(2);
+  EXPECT_TRUE(engine.isUpdatingKernel());
+
+  engine.setResponse(cascade);
+  waitForKernel(engine);
+
+  const auto response = getImpulseResponse(engine, 2 * engine.getLatencySamples(), 512);
+  EXPECT_NEAR(getMeasuredMagnitudeDb(response, 500.0), 6.0f, 0.01f);
+}
+
+// The convolution runs on its own partitions, so the host block size only moves the point at which
+// they are processed.
+TEST(LinearPhaseEngine, OutputDoesNotDependOnTheBlockSize) {
+  LinearPhaseEngine::Response cascade;
+  cascade.sections[0] = makeFilter<PeakFilter>(SAMPLE_RATE, 3000.0, 2.0, -8.0f).getCoefficients();
+  cascade.numSections = 1;
+
+  LinearPhaseEngine engine;
+  engine.prepare(2);
+  engine.setResponse(cascade);
+  waitForKernel(engine);
+
+  const auto length = 3 * engine.getLatencySamples();
+  const auto expected = getImpulseResponse(engine, length, 1024);
+
+  for (const auto blockSize : {1, 37, 256, 300}) {
+    const auto response = getImpulseResponse(engine, length, blockSize);
+
+    for (int n = 0; n < length; ++n) {
+      ASSERT_EQ(response.getSample(1, n), expected.getSample(1, n)) << "block size " << blockSize << ", sample " << n;
+    }
+  }
+}
+}  // namespace parametric_eq_test
@@ -0,0 +1,99 @@
+#include <NIWSParametricEq/filters/HighShelfFilter.h>
+#include <NIWSParametricEq/filters/LowShelfFilter.h>
+#include <NIWSParametricEq/filters/PeakFilter.h>
+#include <gtest/gtest.h>
+
+#include "TestHelpers.h"
+
+namespace parametric_eq_test {
+namespace {
+struct Deviation {
+  float matched;
+  float bilinear;
+};
+
+float getPrototypeMagnitudeDb(const MatchedDesign::AnalogPrototype& prototype, double frequency, double f0) {
+  return static_cast<float>(10.0 * std::log10(prototype.getMagnitudeSquared(frequency / f0)));
+}
+
+// Largest distance from the analog prototype over the audio band, for both design modes.
+template <typename Filter>
+Deviation getWorstDeviation(MatchedDesign::AnalogPrototype (*prototype)(double, double), double sampleRate,
+                            double frequency, double Q, float gainDb) {
+  const auto matched = makeFilter<Filter>(sampleRate, frequency, Q, gainDb, BiquadFilter::DesignMode::matchedMagnitude);
+  const auto bilinear = makeFilter<Filter>(sampleRate, frequency, Q, gainDb, BiquadFilter::DesignMode::bilinear);
+  const auto analog = prototype(Q, std::pow(10.0, static_cast<double>(gainDb) / 40.0));
+
+  Deviation worst{0.0f, 0.0f};
+
+  for (auto f = 20.0; f <= 20000.0; f *= 1.02) {
+    const auto expected = getPrototypeMagnitudeDb(analog, f, frequency);
+    worst.matched = std::max(worst.matched, std::abs(matched.getMagnitudeDbAt(f) - expected));
+    worst.bilinear = std::max(worst.bilinear, std::abs(bilinear.getMagnitudeDbAt(f) - expected));
+  }
+
+  return worst;
+}
+
+template <typename Filter>
+void expectTracksPrototype(MatchedDesign::AnalogPrototype (*prototype)(double, double), float gainDb) {
+  for (const auto sampleRate : {44100.0, 48000.0}) {
+    for (const auto frequency : {1000.0, 5000.0, 10000.0, 16000.0}) {
+      for (const auto Q : {0.5, 0.707, 1.0}) {
+        const auto worst = getWorstDeviation<Filter>(prototype, sampleRate, frequency, Q, gainDb);
+        // Between the three matched points the fit loosens as the band approaches Nyquist, most
+        // for broad bands.
+        const auto tolerance = frequency <= 1000.0 ? 0.1f : frequency <= 5000.0 ? 0.75f : 1.5f;
+
+        EXPECT_LT(worst.matched, tolerance)
+            << "fs " << sampleRate << ", f0 " << frequency << ", Q " << Q << ", gain " << gainDb;
+
+        if (frequency >= 10000.0) {
+          EXPECT_LT(2.0f * worst.matched, worst.bilinear)
+              << "fs " << sampleRate << ", f0 " << frequency << ", Q " << Q << ", gain " << gainDb;
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST(MatchedDesign, PeaksTrackTheAnalogPrototypeUpToNyquist) {
+  expectTracksPrototype<PeakFilter>(MatchedDesign::peakPrototype, 12.0f);
+  expectTracksPrototype<PeakFilter>(MatchedDesign::peakPrototype, -12.0f);
+}
+
+TEST(MatchedDesign, ShelvesTrackTheAnalogPrototypeUpToNyquist) {
+  expectTracksPrototype<LowShelfFilter>(MatchedDesign::lowShelfPrototype, 9.0f);
+  expectTracksPrototype<LowShelfFilter>(MatchedDesign::lowShelfPrototype, -9.0f);
+  expectTracksPrototype<HighShelfFilter>(MatchedDesign::highShelfPrototype, 9.0f);
+  expectTracksPrototype<HighShelfFilter>(MatchedDesign::highShelfPrototype, -9.0f);
+}
+
+TEST(MatchedDesign, MatchesAtDcCentreAndNyquist) {
+  constexpr double sampleRate = 44100.0;
+  constexpr double frequency = 14000.0;
+  const auto filter = makeFilter<PeakFilter>(sampleRate, frequency, 0.8, 9.0f, BiquadFilter::DesignMode::matchedMagnitude);
+  const auto analog = MatchedDesign::peakPrototype(0.8, std::pow(10.0, 9.0 / 40.0));
+
+  for (const auto f : {0.0, frequency, sampleRate / 2.0}) {
+    EXPECT_NEAR(filter.getMagnitudeDbAt(f), getPrototypeMagnitudeDb(analog, f, frequency), 0.01f) << f;
+  }
+}
+
+// The cascade culls bands whose coefficients are an exact identity, which has to keep working.
+TEST(MatchedDesign, UnityGainIsAnExactIdentity) {
+  for (auto frequency = 20.0; frequency < 20000.0; frequency *= 1.1) {
+    const auto w0 = 2.0 * std::numbers::pi * frequency / 48000.0;
+
+    for (const auto Q : {0.3, 1.0, 10.0}) {
+      for (const auto& c : {MatchedDesign::designPeak(Q, 1.0, w0), MatchedDesign::designLowShelf(Q, 1.0, w0),
+                            MatchedDesign::designHighShelf(Q, 1.0, w0)}) {
+        EXPECT_EQ(c.b0, 1.0f) << frequency << ", Q " << Q;
+        EXPECT_EQ(c.b1, c.a1) << frequency << ", Q " << Q;
+        EXPECT_EQ(c.b2, c.a2) << frequency << ", Q " << Q;
+      }
+    }
+  }
+}
+}  // namespace parametric_eq_test
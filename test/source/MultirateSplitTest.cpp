@@ -0,0 +1,114 @@
+#include <NIWSParametricEq/filters/MultirateSplit.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numbers>
+
+#include "TestHelpers.h"
+
+namespace parametric_eq_test {
+namespace {
+constexpr double SAMPLE_RATE = 192000.0;
+
+juce::AudioBuffer<float> makeSine(double frequency, int numSamples) {
+  juce::AudioBuffer<float> buffer{2, numSamples};
+
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int n = 0; n < numSamples; ++n) {
+      const auto phase = 2.0 * std::numbers::pi * frequency * static_cast<double>(n) / SAMPLE_RATE;
+      buffer.setSample(ch, n, static_cast<float>(std::sin(phase)));
+    }
+  }
+
+  return buffer;
+}
+
+// Runs the split over the signal in uneven blocks, with the low band scaled by gain.
+void process(MultirateSplit& split, juce::AudioBuffer<float>& signal, float gain) {
+  const auto scale = [gain](juce::AudioBuffer<float>& lowBand) {
+    for (int ch = 0; ch < lowBand.getNumChannels(); ++ch) {
+      for (int n = 0; n < lowBand.getNumSamples(); ++n) {
+        lowBand.setSample(ch, n, gain * lowBand.getSample(ch, n));
+      }
+    }
+  };
+
+  for (int start = 0, blockSize = 1; start < signal.getNumSamples(); start += blockSize, blockSize = blockSize * 3 % 700 + 1) {
+    juce::AudioBuffer<float> block{signal.getArrayOfWritePointers(), 2, start,
+                                   juce::jmin(blockSize, signal.getNumSamples() - start)};
+    split.process(block, scale);
+  }
+}
+
+// Largest distance from the input, delayed by the latency and scaled, after the filters settle.
+float getWorstError(const juce::AudioBuffer<float>& input, const juce::AudioBuffer<float>& output, int latency,
+                    float gain) {
+  auto worst = 0.0f;
+
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int n = 4 * latency; n < output.getNumSamples(); ++n) {
+      worst = std::max(worst, std::abs(output.getSample(ch, n) - gain * input.getSample(ch, n - latency)));
+    }
+  }
+
+  return worst;
+}
+}  // namespace
+
+TEST(MultirateSplit, LatencyIsAWholeNumberOfReducedRateSamples) {
+  for (int numStages = 1; numStages <= MultirateSplit::MAX_STAGES; ++numStages) {
+    MultirateSplit split;
+    split.prepare(numStages, 2);
+
+    EXPECT_EQ(split.getFactor(), 1 << numStages);
+    EXPECT_GT(split.getLatencySamples(), 0);
+    EXPECT_EQ(split.getLatencySamples() % split.getFactor(), 0) << numStages;
+
+    // A larger multiple, as an oversampler around the split needs, pads the delays further.
+    split.prepare(numStages, 2, 16);
+    EXPECT_EQ(split.getLatencySamples() % 16, 0) << numStages;
+  }
+}
+
+// Left alone, the low band cancels out exactly and only the delay remains.
+TEST(MultirateSplit, UntouchedLowBandIsAPureDelay) {
+  MultirateSplit split;
+  split.prepare(2, 2);
+  const auto latency = split.getLatencySamples();
+
+  juce::Random random{5};
+  juce::AudioBuffer<float> input{2, 4096};
+  fillWithNoise(input, random);
+
+  juce::AudioBuffer<float> output;
+  output.makeCopyOf(input);
+  process(split, output, 1.0f);
+
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int n = 0; n < input.getNumSamples(); ++n) {
+      ASSERT_EQ(output.getSample(ch, n), n < latency ? 0.0f : input.getSample(ch, n - latency)) << n;
+    }
+  }
+}
+
+// What the low band does applies below the reduced rate's passband edge, and nothing above the
+// reduced rate's Nyquist frequency is touched.
+TEST(MultirateSplit, LowBandProcessingOnlyReachesTheLowBand) {
+  for (int numStages = 1; numStages <= MultirateSplit::MAX_STAGES; ++numStages) {
+    const auto reducedRate = SAMPLE_RATE / static_cast<double>(1 << numStages);
+
+    for (const auto& [frequency, gain] : {std::pair{100.0, 2.0f}, std::pair{0.3 * reducedRate, 2.0f},
+                                          std::pair{0.7 * reducedRate, 1.0f}}) {
+      MultirateSplit split;
+      split.prepare(numStages, 2);
+
+      const auto input = makeSine(frequency, 16384);
+      juce::AudioBuffer<float> output;
+      output.makeCopyOf(input);
+      process(split, output, 2.0f);
+
+      EXPECT_LT(getWorstError(input, output, split.getLatencySamples(), gain), 1e-3f)
+          << "stages " << numStages << ", " << frequency << " Hz";
+    }
+  }
+}
+}  // namespace parametric_eq_test
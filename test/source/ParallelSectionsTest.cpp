@@ -0,0 +1,185 @@
+#include <NIWSParametricEq/filters/HighPassFilter.h>
+#include <NIWSParametricEq/filters/HighShelfFilter.h>
+#include <NIWSParametricEq/filters/LowShelfFilter.h>
+#include <NIWSParametricEq/filters/ParallelSections.h>
+#include <NIWSParametricEq/filters/PeakFilter.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+#include "TestHelpers.h"
+
+namespace parametric_eq_test {
+namespace {
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int IMPULSE_LENGTH = 4096;
+
+// Impulse response of the cascade, run in series in double.
+std::vector<double> getCascadeImpulseResponse(const std::vector<BiquadFilter::Coefficients>& sections) {
+  std::vector<double> response(IMPULSE_LENGTH, 0.0);
+  response[0] = 1.0;
+
+  for (const auto& c : sections) {
+    auto s1 = 0.0;
+    auto s2 = 0.0;
+
+    for (auto& x : response) {
+      const auto y = static_cast<double>(c.b0) * x + s1;
+      s1 = static_cast<double>(c.b1) * x - static_cast<double>(c.a1) * y + s2;
+      s2 = static_cast<double>(c.b2) * x - static_cast<double>(c.a2) * y;
+      x = y;
+    }
+  }
+
+  return response;
+}
+
+juce::AudioBuffer<float> getImpulseResponse(ParallelSections& parallel) {
+  parallel.reset();
+
+  juce::AudioBuffer<float> response{1, IMPULSE_LENGTH};
+  response.clear();
+  response.setSample(0, 0, 1.0f);
+  parallel.process(response, 0, IMPULSE_LENGTH);
+  return response;
+}
+
+std::vector<size_t> getSlots(size_t numSections) {
+  std::vector<size_t> slots(numSections);
+  std::iota(slots.begin(), slots.end(), size_t{0});
+  return slots;
+}
+}  // namespace
+
+TEST(ParallelSections, SumOfBranchesMatchesTheCascade) {
+  const std::vector sections{makeCoefficients<PeakFilter>(SAMPLE_RATE, 1000.0, 2.0, 9.0f),
+                             makeCoefficients<PeakFilter>(SAMPLE_RATE, 3500.0, 1.0, -6.0f),
+                             makeCoefficients<LowShelfFilter>(SAMPLE_RATE, 200.0, 0.7, 4.0f),
+                             makeCoefficients<HighShelfFilter>(SAMPLE_RATE, 8000.0, 0.7, -3.0f),
+                             makeCoefficients<HighPassFilter>(SAMPLE_RATE, 40.0, 0.7, 0.0f)};
+  const auto slots = getSlots(sections.size());
+
+  ParallelSections parallel;
+  parallel.prepare(1);
+  parallel.setSections(slots, sections);
+  ASSERT_TRUE(parallel.isParallel());
+
+  const auto expected = getCascadeImpulseResponse(sections);
+  const auto response = getImpulseResponse(parallel);
+
+  for (int n = 0; n < IMPULSE_LENGTH; ++n) {
+    ASSERT_NEAR(response.getSample(0, n), expected[static_cast<size_t>(n)], 1e-5) << n;
+  }
+}
+
+// Two identical peaks share their poles, so the cascade has no partial-fraction expansion.
+TEST(ParallelSections, CoincidentPolesRunInSeries) {
+  const auto peak = makeCoefficients<PeakFilter>(SAMPLE_RATE, 1000.0, 2.0, 6.0f);
+  const std::vector sections{peak, peak};
+  const auto slots = getSlots(sections.size());
+
+  ParallelSections parallel;
+  parallel.prepare(1);
+  parallel.setSections(slots, sections);
+  EXPECT_FALSE(parallel.isParallel());
+
+  const auto expected = getCascadeImpulseResponse(sections);
+  const auto response = getImpulseResponse(parallel);
+
+  for (int n = 0; n < IMPULSE_LENGTH; ++n) {
+    ASSERT_NEAR(response.getSample(0, n), expected[static_cast<size_t>(n)], 1e-5) << n;
+  }
+}
+
+// Setting the same sections again, as the caller does every control interval, leaves the state
+// running instead of restarting the branches.
+TEST(ParallelSections, UnchangedSectionsKeepTheirState) {
+  const std::vector sections{makeCoefficients<PeakFilter>(SAMPLE_RATE, 500.0, 1.0, 6.0f),
+                             makeCoefficients<PeakFilter>(SAMPLE_RATE, 5000.0, 3.0, -9.0f)};
+  const auto slots = getSlots(sections.size());
+
+  ParallelSections parallel;
+  parallel.prepare(1);
+  parallel.setSections(slots, sections);
+
+  const auto expected = getCascadeImpulseResponse(sections);
+
+  juce::AudioBuffer<float> response{1, IMPULSE_LENGTH};
+  response.clear();
+  response.setSample(0, 0, 1.0f);
+
+  for (int start = 0; start < IMPULSE_LENGTH; start += 32) {
+    parallel.setSections(slots, sections);
+    parallel.process(response, start, 32);
+  }
+
+  for (int n = 0; n < IMPULSE_LENGTH; ++n) {
+    ASSERT_NEAR(response.getSample(0, n), expected[static_cast<size_t>(n)], 1e-5) << n;
+  }
+}
+
+// A change glides across the next block, reaching the new coefficients on its last sample.
+TEST(ParallelSections, ChangedSectionsRampAcrossTheNextBlock) {
+  constexpr int blockSize = 32;
+  const std::vector<size_t> slots{0};
+
+  ParallelSections parallel;
+  parallel.prepare(1);
+  parallel.setSections(slots, std::vector<BiquadFilter::Coefficients>{{1.0f, 0.0f, 0.0f, 0.0f, 0.0f}});
+
+  juce::AudioBuffer<float> buffer{1, blockSize};
+  buffer.clear();
+  std::fill_n(buffer.getWritePointer(0), blockSize, 1.0f);
+  parallel.process(buffer, 0, blockSize);
+  EXPECT_FLOAT_EQ(buffer.getSample(0, 0), 1.0f);
+
+  parallel.setSections(slots, std::vector<BiquadFilter::Coefficients>{{2.0f, 0.0f, 0.0f, 0.0f, 0.0f}});
+
+  for (const auto ramps : {true, false}) {
+    std::fill_n(buffer.getWritePointer(0), blockSize, 1.0f);
+    parallel.process(buffer, 0, blockSize);
+
+    for (int n = 0; n < blockSize; ++n) {
+      const auto expected = ramps ? 1.0f + static_cast<float>(n + 1) / blockSize : 2.0f;
+      ASSERT_NEAR(buffer.getSample(0, n), expected, 1e-5) << n;
+    }
+  }
+}
+
+// A section that joins fades in from nothing, so the output carries on from where it was.
+TEST(ParallelSections, NewSectionsFadeIn) {
+  constexpr int blockSize = 32;
+  const auto shelf = makeCoefficients<HighShelfFilter>(SAMPLE_RATE, 1000.0, 0.7, 12.0f);
+  const std::vector<BiquadFilter::Coefficients> flat{{1.0f, 0.0f, 0.0f, 0.0f, 0.0f}};
+  const std::vector<BiquadFilter::Coefficients> shelved{flat[0], shelf};
+
+  ParallelSections parallel;
+  parallel.prepare(1);
+  parallel.setSections(getSlots(1), flat);
+
+  // Nyquist, where the shelf lifts by its full gain.
+  juce::AudioBuffer<float> buffer{1, blockSize};
+  const auto fillBlock = [&buffer] {
+    for (int n = 0; n < blockSize; ++n) {
+      buffer.setSample(0, n, n % 2 == 0 ? 1.0f : -1.0f);
+    }
+  };
+
+  fillBlock();
+  parallel.process(buffer, 0, blockSize);
+
+  parallel.setSections(getSlots(2), shelved);
+  ASSERT_TRUE(parallel.isParallel());
+
+  fillBlock();
+  parallel.process(buffer, 0, blockSize);
+  EXPECT_NEAR(buffer.getSample(0, 0), 1.0f, 0.2f);
+
+  for (int block = 0; block < 256; ++block) {
+    fillBlock();
+    parallel.process(buffer, 0, blockSize);
+  }
+
+  EXPECT_NEAR(buffer.getSample(0, 0), juce::Decibels::decibelsToGain(12.0f), 1e-3);
+}
+}  // namespace parametric_eq_test
@@ -0,0 +1,617 @@
+#include <NIWSParametricEq/ParametricEq.h>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <utility>
+
+#include "TestHelpers.h"
+
+namespace parametric_eq_test {
+namespace {
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int BLOCK_SIZE = 256;
+constexpr int NUM_BLOCKS = 12;
+
+// Drives both equalisers through the same parameter automation, one block at a time.
+void setParameters(parametric_eq::ParametricEq& eq, int block) {
+  const auto sweep = static_cast<double>(block) / static_cast<double>(NUM_BLOCKS);
+
+  for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+    const auto frequency = parametric_eq::ParametricEq::DEFAULT_FREQS[band] * (1.0 + sweep);
+    eq.setPeakParameters(band, frequency, 1.5, static_cast<float>(12.0 * sweep - 4.0), band == 2 && block > 6);
+  }
+
+  eq.setLowShelfParameters(120.0, 0.7, 6.0f, false, 0);
+  eq.setHighShelfParameters(9000.0, 0.7, static_cast<float>(-6.0 * sweep), block == 3, 0);
+  eq.setLowPassParameters(14000.0, 0.9, false, block < 6 ? 3 : 1, block >= 9);
+  eq.setHighPassParameters(60.0 + 40.0 * sweep, 0.7, false, block < 4 ? 0 : 4, block >= 8);
+}
+
+void expectFusedCascadeMatchesPerBand(int numChannels) {
+  parametric_eq::ParametricEq fused;
+  parametric_eq::ParametricEq perBand;
+  fused.prepare(SAMPLE_RATE, numChannels);
+  perBand.prepare(SAMPLE_RATE, numChannels);
+
+  juce::Random random{42};
+  juce::AudioBuffer<float> buffer{numChannels, BLOCK_SIZE};
+  juce::AudioBuffer<float> expected{numChannels, BLOCK_SIZE};
+
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    fillWithNoise(buffer, random);
+    expected.makeCopyOf(buffer);
+
+    setParameters(fused, block);
+    setParameters(perBand, block);
+
+    fused.processBlock(buffer);
+
+    // Peaks and shelves come first. The slope sections follow their leader's design, so they
+    // are stepped one sample at a time to keep them in lockstep.
+    const auto bands = perBand.getBands();
+    const auto numBlockBands = parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS + 2;
+
+    for (size_t i = 0; i < numBlockBands; ++i) {
+      bands[i]->processBlock(expected);
+    }
+
+    for (int n = 0; n < BLOCK_SIZE; ++n) {
+      juce::AudioBuffer<float> frame{expected.getArrayOfWritePointers(), numChannels, n, 1};
+      for (size_t i = numBlockBands; i < bands.size(); ++i) {
+        bands[i]->processBlock(frame);
+      }
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      for (int n = 0; n < BLOCK_SIZE; ++n) {
+        ASSERT_NEAR(buffer.getSample(ch, n), expected.getSample(ch, n), 1e-5f)
+            << "channels " << numChannels << ", channel " << ch << ", block " << block
+            << ", sample " << n;
+      }
+    }
+  }
+}
+
+// Steady-state gain for a sine, measured past the latency and the filters' settling.
+float getMeasuredGainDb(parametric_eq::ParametricEq& eq, double sampleRate, double frequency) {
+  eq.reset();
+
+  const auto numSamples = static_cast<int>(sampleRate / 2.0);
+  juce::AudioBuffer<float> buffer{1, numSamples};
+  for (int n = 0; n < numSamples; ++n) {
+    buffer.setSample(0, n, static_cast<float>(std::sin(2.0 * std::numbers::pi * frequency * static_cast<double>(n) / sampleRate)));
+  }
+
+  for (int start = 0; start < numSamples; start += BLOCK_SIZE) {
+    juce::AudioBuffer<float> block{buffer.getArrayOfWritePointers(), 1, start, juce::jmin(BLOCK_SIZE, numSamples - start)};
+    eq.processBlock(block);
+  }
+
+  return juce::Decibels::gainToDecibels(buffer.getMagnitude(0, numSamples / 2, numSamples / 2));
+}
+
+void setFlat(parametric_eq::ParametricEq& eq, bool peakBypassed) {
+  for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+    eq.setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band], 1.0, band == 1 ? 9.0f : 0.0f,
+                         band == 1 && peakBypassed);
+  }
+
+  eq.setLowShelfParameters(120.0, 0.7, 0.0f, false, 0);
+  eq.setHighShelfParameters(9000.0, 0.7, 0.0f, false, 0);
+  eq.setLowPassParameters(14000.0, 0.7, true, 1);
+  eq.setHighPassParameters(60.0, 0.7, true, 1);
+}
+}  // namespace
+
+TEST(ParametricEq, IdleBandsPassTheSignalThroughUntouched) {
+  parametric_eq::ParametricEq eq;
+  eq.prepare(SAMPLE_RATE, 2);
+
+  juce::Random random{7};
+  juce::AudioBuffer<float> buffer{2, BLOCK_SIZE};
+  juce::AudioBuffer<float> input{2, BLOCK_SIZE};
+
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    setFlat(eq, true);
+    fillWithNoise(buffer, random);
+    input.makeCopyOf(buffer);
+    eq.processBlock(buffer);
+
+    if (block < 4) {
+      continue;
+    }
+
+    for (int ch = 0; ch < 2; ++ch) {
+      for (int n = 0; n < BLOCK_SIZE; ++n) {
+        ASSERT_EQ(buffer.getSample(ch, n), input.getSample(ch, n)) << "block " << block << ", sample " << n;
+      }
+    }
+  }
+}
+
+TEST(ParametricEq, ReengagedBandStartsFromClearedState) {
+  parametric_eq::ParametricEq eq;
+  eq.prepare(SAMPLE_RATE, 1);
+
+  juce::Random random{11};
+  juce::AudioBuffer<float> buffer{1, BLOCK_SIZE};
+
+  setFlat(eq, false);
+  for (int block = 0; block < 4; ++block) {
+    fillWithNoise(buffer, random);
+    eq.processBlock(buffer);
+  }
+
+  // Bypass the boosted band while it still rings, then let the fade finish.
+  setFlat(eq, true);
+  for (int block = 0; block < 4; ++block) {
+    fillWithNoise(buffer, random);
+    eq.processBlock(buffer);
+  }
+
+  setFlat(eq, false);
+  buffer.clear();
+  eq.processBlock(buffer);
+
+  for (int n = 0; n < BLOCK_SIZE; ++n) {
+    ASSERT_EQ(buffer.getSample(0, n), 0.0f) << "sample " << n;
+  }
+}
+
+// With the parameters held still, both engines realise the same transfer functions.
+TEST(ParametricEq, StateVariableEngineMatchesBiquadEngine) {
+  parametric_eq::ParametricEq biquad;
+  parametric_eq::ParametricEq stateVariable;
+  biquad.prepare(SAMPLE_RATE, 2);
+  stateVariable.prepare(SAMPLE_RATE, 2);
+
+  for (auto* eq : {&biquad, &stateVariable}) {
+    for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+      eq->setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band] * 1.5, 1.2,
+                            band % 2 == 0 ? 6.0f : -4.0f, false);
+    }
+
+    eq->setLowShelfParameters(120.0, 0.7, 3.0f, false, 0);
+    eq->setHighShelfParameters(9000.0, 0.7, -6.0f, false, 0);
+    eq->setLowPassParameters(14000.0, 0.9, false, 2);
+    eq->setHighPassParameters(50.0, 0.7, false, 1);
+  }
+
+  stateVariable.setEngine(parametric_eq::ParametricEq::Engine::stateVariable);
+
+  juce::AudioBuffer<float> buffer{2, BLOCK_SIZE};
+  juce::AudioBuffer<float> expected{2, BLOCK_SIZE};
+
+  // Let the biquad engine's glides from the defaults finish on silence.
+  for (int block = 0; block < 8; ++block) {
+    buffer.clear();
+    biquad.processBlock(buffer);
+    stateVariable.processBlock(buffer);
+  }
+
+  juce::Random random{19};
+
+  for (int block = 0; block < NUM_BLOCKS; ++block) {
+    fillWithNoise(buffer, random);
+    expected.makeCopyOf(buffer);
+
+    stateVariable.processBlock(buffer);
+    biquad.processBlock(expected);
+
+    for (int ch = 0; ch < 2; ++ch) {
+      for (int n = 0; n < BLOCK_SIZE; ++n) {
+        ASSERT_NEAR(buffer.getSample(ch, n), expected.getSample(ch, n), 1e-3f)
+            << "channel " << ch << ", block " << block << ", sample " << n;
+      }
+    }
+  }
+}
+
+// Held still, the parallel sections sum to the same response as the cascade, including the steep
+// slopes' elliptic sections.
+TEST(ParametricEq, ParallelEngineMatchesBiquadEngine) {
+  for (const auto isSteep : {false, true}) {
+    parametric_eq::ParametricEq biquad;
+    parametric_eq::ParametricEq parallel;
+    biquad.prepare(SAMPLE_RATE, 2);
+    parallel.prepare(SAMPLE_RATE, 2);
+    parallel.setEngine(parametric_eq::ParametricEq::Engine::parallel);
+
+    for (auto* eq : {&biquad, &parallel}) {
+      for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+        eq->setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band] * 1.5, 1.2,
+                              band % 2 == 0 ? 6.0f : -4.0f, false);
+      }
+
+      eq->setLowShelfParameters(120.0, 0.7, 3.0f, false, 0);
+      eq->setHighShelfParameters(9000.0, 0.7, -6.0f, false, 0);
+      eq->setLowPassParameters(14000.0, 0.9, false, 2, isSteep);
+      eq->setHighPassParameters(50.0, 0.7, false, 1, isSteep);
+    }
+
+    juce::AudioBuffer<float> buffer{2, BLOCK_SIZE};
+    juce::AudioBuffer<float> expected{2, BLOCK_SIZE};
+
+    for (int block = 0; block < 8; ++block) {
+      buffer.clear();
+      biquad.processBlock(buffer);
+      parallel.processBlock(buffer);
+    }
+
+    // Rounding the branch coefficients to float moves the response by about 1e-4 of full scale on
+    // its own. The elliptic sections put poles close together near DC, where it moves the most.
+    const auto tolerance = isSteep ? 1e-3f : 2e-4f;
+    juce::Random random{23};
+
+    for (int block = 0; block < NUM_BLOCKS; ++block) {
+      fillWithNoise(buffer, random);
+      expected.makeCopyOf(buffer);
+
+      parallel.processBlock(buffer);
+      biquad.processBlock(expected);
+
+      for (int ch = 0; ch < 2; ++ch) {
+        for (int n = 0; n < BLOCK_SIZE; ++n) {
+          ASSERT_NEAR(buffer.getSample(ch, n), expected.getSample(ch, n), tolerance)
+              << "steep " << isSteep << ", channel " << ch << ", block " << block << ", sample " << n;
+        }
+      }
+    }
+  }
+}
+
+TEST(ParametricEq, OnlyTheLinearPhaseEngineAddsLatency) {
+  parametric_eq::ParametricEq eq;
+  eq.prepare(SAMPLE_RATE, 2);
+  EXPECT_EQ(eq.getLatencySamples(), 0);
+
+  eq.setEngine(parametric_eq::ParametricEq::Engine::linearPhase);
+  EXPECT_EQ(eq.getLatencySamples(), parametric_eq::LinearPhaseEngine::DEFAULT_LATENCY_SAMPLES);
+
+  eq.setEngine(parametric_eq::ParametricEq::Engine::stateVariable);
+  EXPECT_EQ(eq.getLatencySamples(), 0);
+}
+
+// At 192 kHz the low shelf and the high-pass run at a quarter of the rate. The split is delayed by
+// its own latency, and the response still matches what the bands report.
+TEST(ParametricEq, MultirateLowBandsFollowTheReportedResponse) {
+  constexpr auto highRate = 192000.0;
+
+  parametric_eq::ParametricEq eq;
+  eq.prepare(highRate, 1);
+  eq.setMultirate(true);
+  ASSERT_TRUE(eq.isMultirateActive());
+  EXPECT_GT(eq.getLatencySamples(), 0);
+
+  for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+    eq.setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band], 1.0, band == 3 ? 6.0f : 0.0f, false);
+  }
+
+  eq.setLowShelfParameters(200.0, 0.7, 8.0f, false, 0);
+  eq.setHighShelfParameters(9000.0, 0.7, -4.0f, false, 0);
+  eq.setLowPassParameters(30000.0, 0.7, true, 1);
+  eq.setHighPassParameters(50.0, 0.7, false, 2);
+  eq.settleParameters();
+
+  const auto bands = eq.getBands();
+
+  for (const auto frequency : {40.0, 120.0, 400.0, 2000.0, 12000.0, 30000.0}) {
+    auto expected = 1.0f;
+    for (auto* band : bands) {
+      expected *= band->getMagnitudeAtFrequency(frequency);
+    }
+
+    EXPECT_NEAR(getMeasuredGainDb(eq, highRate, frequency), juce::Decibels::gainToDecibels(expected), 0.05f)
+        << frequency << " Hz";
+  }
+
+  // Only the biquad engine splits the signal.
+  eq.setEngine(parametric_eq::ParametricEq::Engine::parallel);
+  EXPECT_FALSE(eq.isMultirateActive());
+  EXPECT_EQ(eq.getLatencySamples(), 0);
+}
+
+// The split leaves everything above its passband edge alone, so a low shelf or a high-pass that
+// reaches up there runs at the full rate, and goes back down to the reduced one with its cutoff.
+TEST(ParametricEq, MultirateKeepsHighCutoffsAtTheFullRate) {
+  constexpr auto highRate = 96000.0;
+  constexpr auto reducedRate = highRate / 2.0;
+
+  parametric_eq::ParametricEq multirate;
+  parametric_eq::ParametricEq fullRate;
+
+  for (auto* eq : {&multirate, &fullRate}) {
+    eq->prepare(highRate, 1);
+    setFlat(*eq, true);
+  }
+
+  multirate.setMultirate(true);
+  ASSERT_TRUE(multirate.isMultirateActive());
+
+  const auto getRates = [&multirate] {
+    const auto bands = multirate.getBands();
+    const auto numPeaks = parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS;
+    return std::pair{bands[numPeaks]->getSampleRate(), bands.back()->getSampleRate()};
+  };
+
+  const auto expectSameResponse = [&] {
+    for (const auto frequency : {1000.0, 8000.0, 15000.0, 20000.0, 30000.0}) {
+      EXPECT_NEAR(getMeasuredGainDb(multirate, highRate, frequency), getMeasuredGainDb(fullRate, highRate, frequency),
+                  0.1f)
+          << frequency << " Hz";
+    }
+  };
+
+  for (auto* eq : {&multirate, &fullRate}) {
+    eq->setLowShelfParameters(12000.0, 0.7, 12.0f, false, 0);
+    eq->setHighPassParameters(20000.0, 0.7, false, 3);
+    eq->settleParameters();
+  }
+
+  expectSameResponse();
+  EXPECT_TRUE(juce::exactlyEqual(getRates().first, highRate));
+  EXPECT_TRUE(juce::exactlyEqual(getRates().second, highRate));
+
+  for (auto* eq : {&multirate, &fullRate}) {
+    eq->setLowShelfParameters(150.0, 0.7, 12.0f, false, 0);
+    eq->setHighPassParameters(40.0, 0.7, false, 3);
+    eq->settleParameters();
+  }
+
+  expectSameResponse();
+  EXPECT_TRUE(juce::exactlyEqual(getRates().first, reducedRate));
+  EXPECT_TRUE(juce::exactlyEqual(getRates().second, reducedRate));
+}
+
+// Double buffers run the biquad engine in place. The engines that only run in float take them in
+// chunks, so blocks longer than a chunk come out the same as float buffers do.
+TEST(ParametricEq, DoubleBuffersMatchFloatBuffers) {
+  using Engine = parametric_eq::ParametricEq::Engine;
+  constexpr int longBlock = 2 * parametric_eq::ParametricEq::FLOAT_CHUNK_SIZE + 37;
+
+  for (const auto engine : {Engine::biquad, Engine::stateVariable, Engine::parallel}) {
+    parametric_eq::ParametricEq single;
+    parametric_eq::ParametricEq twice;
+
+    for (auto* eq : {&single, &twice}) {
+      eq->prepare(SAMPLE_RATE, 2);
+      eq->setDoublePrecision(true);
+      eq->setEngine(engine);
+      setParameters(*eq, 5);
+    }
+
+    ASSERT_TRUE(twice.isUsingDoublePrecision());
+
+    juce::Random random{31};
+    juce::AudioBuffer<float> buffer{2, longBlock};
+    juce::AudioBuffer<double> doubles{2, longBlock};
+
+    for (int block = 0; block < 4; ++block) {
+      fillWithNoise(buffer, random);
+      for (int ch = 0; ch < 2; ++ch) {
+        for (int n = 0; n < longBlock; ++n) {
+          doubles.setSample(ch, n, static_cast<double>(buffer.getSample(ch, n)));
+        }
+      }
+
+      single.processBlock(buffer);
+      twice.processBlock(doubles);
+
+      for (int ch = 0; ch < 2; ++ch) {
+        for (int n = 0; n < longBlock; ++n) {
+          ASSERT_NEAR(doubles.getSample(ch, n), static_cast<double>(buffer.getSample(ch, n)), 1e-5)
+              << "engine " << static_cast<int>(engine) << ", channel " << ch << ", block " << block
+              << ", sample " << n;
+        }
+      }
+    }
+  }
+}
+
+// With multirate on, a double buffer stays in double outside the low band: with the low bands
+// flat it comes out as a delay of itself, bit for bit, and otherwise matches a float buffer.
+TEST(ParametricEq, MultirateKeepsDoubleBuffersInDouble) {
+  constexpr auto highRate = 96000.0;
+  constexpr int numSamples = 4096;
+
+  parametric_eq::ParametricEq single;
+  parametric_eq::ParametricEq twice;
+
+  for (auto* eq : {&single, &twice}) {
+    eq->prepare(highRate, 2);
+    eq->setMultirate(true);
+    setFlat(*eq, true);
+    eq->settleParameters();
+  }
+
+  ASSERT_TRUE(twice.isMultirateActive());
+  const auto latency = twice.getLatencySamples();
+
+  juce::Random random{8};
+  juce::AudioBuffer<double> input{2, numSamples};
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int n = 0; n < numSamples; ++n) {
+      input.setSample(ch, n, 2.0 * random.nextDouble() - 1.0);
+    }
+  }
+
+  juce::AudioBuffer<double> doubles;
+  doubles.makeCopyOf(input);
+  twice.processBlock(doubles);
+
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int n = latency; n < numSamples; ++n) {
+      ASSERT_TRUE(juce::exactlyEqual(doubles.getSample(ch, n), input.getSample(ch, n - latency))) << n;
+    }
+  }
+
+  for (auto* eq : {&single, &twice}) {
+    eq->setLowShelfParameters(150.0, 0.7, 6.0f, false, 0);
+    eq->setHighPassParameters(40.0, 0.7, false, 1);
+    eq->settleParameters();
+    eq->reset();
+  }
+
+  juce::AudioBuffer<float> floats{2, numSamples};
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int n = 0; n < numSamples; ++n) {
+      floats.setSample(ch, n, static_cast<float>(input.getSample(ch, n)));
+      doubles.setSample(ch, n, static_cast<double>(floats.getSample(ch, n)));
+    }
+  }
+
+  single.processBlock(floats);
+  twice.processBlock(doubles);
+
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int n = 0; n < numSamples; ++n) {
+      ASSERT_NEAR(doubles.getSample(ch, n), static_cast<double>(floats.getSample(ch, n)), 1e-5) << n;
+    }
+  }
+}
+
+// A double buffer with more channels than prepared for filters the ones it was prepared for and
+// passes the others through, in the engines that take it in float chunks too.
+TEST(ParametricEq, ExtraDoubleChannelsPassThrough) {
+  using Engine = parametric_eq::ParametricEq::Engine;
+  constexpr int numSamples = parametric_eq::ParametricEq::FLOAT_CHUNK_SIZE + 19;
+
+  for (const auto engine : {Engine::biquad, Engine::stateVariable, Engine::parallel}) {
+    parametric_eq::ParametricEq eq;
+    eq.prepare(SAMPLE_RATE, 2);
+    eq.setEngine(engine);
+    setParameters(eq, 5);
+
+    juce::Random random{12};
+    juce::AudioBuffer<double> input{3, numSamples};
+    for (int ch = 0; ch < 3; ++ch) {
+      for (int n = 0; n < numSamples; ++n) {
+        input.setSample(ch, n, 2.0 * random.nextDouble() - 1.0);
+      }
+    }
+
+    juce::AudioBuffer<double> buffer;
+    buffer.makeCopyOf(input);
+    eq.processBlock(buffer);
+
+    auto difference = 0.0;
+    for (int n = 0; n < numSamples; ++n) {
+      difference += std::abs(buffer.getSample(0, n) - input.getSample(0, n));
+      ASSERT_TRUE(juce::exactlyEqual(buffer.getSample(2, n), input.getSample(2, n)))
+          << "engine " << static_cast<int>(engine) << ", sample " << n;
+    }
+
+    EXPECT_GT(difference, 1.0) << "engine " << static_cast<int>(engine);
+  }
+}
+
+TEST(ParametricEq, FusedCascadeMatchesPerBandProcessing) {
+  expectFusedCascadeMatchesPerBand(1);
+  expectFusedCascadeMatchesPerBand(2);
+  expectFusedCascadeMatchesPerBand(6);
+}
+
+// Held parameters put a mono cascade on the pipelined path, which fills and drains within every
+// block, including blocks shorter than the pipeline.
+TEST(ParametricEq, MonoPipelineMatchesPerBandProcessing) {
+  parametric_eq::ParametricEq pipelined;
+  parametric_eq::ParametricEq perBand;
+
+  for (auto* eq : {&pipelined, &perBand}) {
+    eq->prepare(SAMPLE_RATE, 1);
+
+    for (size_t band = 0; band < parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS; ++band) {
+      eq->setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band] * 1.3, 2.0,
+                            band % 2 == 0 ? 5.0f : -7.0f, band == 1);
+    }
+
+    eq->setLowShelfParameters(150.0, 0.7, 4.0f, false, 0);
+    eq->setHighShelfParameters(8000.0, 0.7, -3.0f, false, 0);
+    eq->setLowPassParameters(15000.0, 0.8, false, 4, false);
+    eq->setHighPassParameters(40.0, 0.7, false, 2, true);
+    eq->settleParameters();
+  }
+
+  juce::Random random{7};
+  const auto bands = perBand.getBands();
+
+  for (const auto blockSize : {256, 5, 1, 64, 13}) {
+    juce::AudioBuffer<float> buffer{1, blockSize};
+    juce::AudioBuffer<float> expected{1, blockSize};
+
+    for (int block = 0; block < 4; ++block) {
+      fillWithNoise(buffer, random);
+      expected.makeCopyOf(buffer);
+
+      pipelined.processBlock(buffer);
+
+      for (auto* band : bands) {
+        band->processBlock(expected);
+      }
+
+      for (int n = 0; n < blockSize; ++n) {
+        ASSERT_NEAR(buffer.getSample(0, n), expected.getSample(0, n), 1e-5f)
+            << "block size " << blockSize << ", block " << block << ", sample " << n;
+      }
+    }
+  }
+}
+
+// A band added to the pool fades in at the parameters it was given while disabled, and one taken
+// out fades away like a bypassed band, in every engine that processes the pool block by block.
+TEST(ParametricEq, EnabledPeaksJoinAndLeaveThePool) {
+  using Engine = parametric_eq::ParametricEq::Engine;
+  constexpr size_t band = 10;
+
+  for (const auto engine : {Engine::biquad, Engine::stateVariable, Engine::parallel}) {
+    parametric_eq::ParametricEq eq;
+    eq.prepare(SAMPLE_RATE, 1);
+    eq.setEngine(engine);
+    setFlat(eq, true);
+    eq.setPeakParameters(band, 3000.0, 2.0, 9.0f, false);
+
+    EXPECT_FALSE(eq.isPeakEnabled(band));
+    EXPECT_NEAR(getMeasuredGainDb(eq, SAMPLE_RATE, 3000.0), 0.0f, 0.05f);
+
+    eq.setPeakEnabled(band, true);
+    EXPECT_TRUE(eq.isPeakEnabled(band));
+    EXPECT_EQ(eq.getBands().size(), parametric_eq::ParametricEq::DEFAULT_NUM_PEAKS + 7);
+    EXPECT_NEAR(getMeasuredGainDb(eq, SAMPLE_RATE, 3000.0), 9.0f, 0.05f);
+
+    eq.setPeakEnabled(band, false);
+    EXPECT_NEAR(getMeasuredGainDb(eq, SAMPLE_RATE, 3000.0), 0.0f, 0.05f);
+  }
+}
+
+// Every band of the pool can be in use at once, in the fused cascade and in the parallel engine.
+TEST(ParametricEq, WholePoolRunsTheSumOfItsBands) {
+  using Engine = parametric_eq::ParametricEq::Engine;
+
+  for (const auto engine : {Engine::biquad, Engine::parallel}) {
+    parametric_eq::ParametricEq eq;
+    eq.prepare(SAMPLE_RATE, 1);
+    eq.setEngine(engine);
+    setFlat(eq, false);
+
+    for (size_t band = 0; band < parametric_eq::ParametricEq::MAX_PEAKS; ++band) {
+      eq.setPeakEnabled(band, true);
+      eq.setPeakParameters(band, parametric_eq::ParametricEq::DEFAULT_FREQS[band], 2.0, band % 2 == 0 ? 2.0f : -1.5f,
+                           false);
+    }
+
+    const auto bands = eq.getBands();
+    ASSERT_EQ(bands.size(), parametric_eq::ParametricEq::MAX_PEAKS + 6);
+
+    // The bands take the enabled state on the next block, so the responses are read after it.
+    for (const auto frequency : {90.0, 600.0, 1000.0, 4000.0, 11000.0}) {
+      const auto measured = getMeasuredGainDb(eq, SAMPLE_RATE, frequency);
+
+      auto expected = 0.0f;
+      for (const auto* filter : bands) {
+        expected += filter->getMagnitudeDbAt(frequency);
+      }
+
+      EXPECT_NEAR(measured, expected, 0.1f) << frequency << " Hz";
+    }
+  }
+}
+}  // namespace parametric_eq_test
@@ -0,0 +1,409 @@
+#include <NIWSParametricEq/ParametricEq.h>
+#include <NIWSParametricEq/PluginProcessor.h>
+#include <NIWSParametricEq/SpectrumAnalyzer.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define NIWS_TRAP_LIBC 1
+#include <dlfcn.h>
+#include <pthread.h>
+
+extern "C" {
+void* __libc_malloc(std::size_t) noexcept;
+void* __libc_calloc(std::size_t, std::size_t) noexcept;
+void* __libc_realloc(void*, std::size_t) noexcept;
+}
+#endif
+
+// Replaces the global allocation functions for the whole test executable. They count what the
+// thread that opened a RealtimeTrap allocates while it is open, and otherwise only forward,
+// so the other tests and the engines' worker threads are left alone. Where the C library lets
+// itself be wrapped, malloc and friends are counted as well, which catches JUCE's HeapBlock, and
+// so is pthread_mutex_lock, which std::mutex, juce::CriticalSection and juce::WaitableEvent all
+// end up in. Elsewhere only operator new is counted, and locks go unnoticed.
+namespace {
+constinit thread_local bool isTrapping = false;
+std::atomic<int> numTrappedAllocations{0};
+std::atomic<int> numTrappedLocks{0};
+
+void noteAllocation() noexcept {
+  if (isTrapping) {
+    numTrappedAllocations.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void noteLock() noexcept {
+  if (isTrapping) {
+    numTrappedLocks.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void* allocate(std::size_t size) {
+#if NIWS_TRAP_LIBC
+  auto* pointer = __libc_malloc(size == 0 ? 1 : size);
+#else
+  auto* pointer = std::malloc(size == 0 ? 1 : size);
+#endif
+  if (pointer == nullptr) {
+    throw std::bad_alloc{};
+  }
+
+  noteAllocation();
+  return pointer;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+  const auto align = static_cast<std::size_t>(alignment);
+  const auto rounded = (size + align - 1) / align * align;
+#if defined(_MSC_VER)
+  auto* pointer = _aligned_malloc(rounded == 0 ? align : rounded, align);
+#else
+  auto* pointer = std::aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+  if (pointer == nullptr) {
+    throw std::bad_alloc{};
+  }
+
+  noteAllocation();
+  return pointer;
+}
+
+void freeAligned(void* pointer) noexcept {
+#if defined(_MSC_VER)
+  _aligned_free(pointer);
+#else
+  std::free(pointer);
+#endif
+}
+}  // namespace
+
+#if NIWS_TRAP_LIBC
+extern "C" {
+void* malloc(std::size_t size) noexcept {
+  noteAllocation();
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept {
+  noteAllocation();
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size) noexcept {
+  noteAllocation();
+  return __libc_realloc(pointer, size);
+}
+
+// The C library's own lock, looked up the first time any is taken; glibc locks internally
+// without coming through here, so the lookup doesn't.
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+  using Lock = int (*)(pthread_mutex_t*);
+  static const auto libcLock = reinterpret_cast<Lock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+
+  noteLock();
+  return libcLock(mutex);
+}
+}
+#endif
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return allocate(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return allocate(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+
+namespace parametric_eq_test {
+namespace {
+using parametric_eq::ParametricEq;
+
+// Counts the allocations and locks the calling thread makes while it is alive. Only read the
+// counts once it is gone, since the test framework's own bookkeeping allocates.
+class RealtimeTrap {
+public:
+  RealtimeTrap() noexcept {
+    numTrappedAllocations = 0;
+    numTrappedLocks = 0;
+    isTrapping = true;
+  }
+
+  ~RealtimeTrap() { isTrapping = false; }
+
+  RealtimeTrap(const RealtimeTrap&) = delete;
+  RealtimeTrap& operator=(const RealtimeTrap&) = delete;
+};
+
+int getTrappedAllocations() noexcept { return numTrappedAllocations.load(); }
+int getTrappedLocks() noexcept { return numTrappedLocks.load(); }
+
+constexpr int MAX_BLOCK_SIZE = 2048;
+constexpr std::array BLOCK_SIZES{1, 37, 256, MAX_BLOCK_SIZE};
+
+// Fills the signal with noise and wraps a block of each size around it, all before the trap opens.
+template <typename SampleType>
+class Signal {
+public:
+  explicit Signal(int numChannels) : buffer_(numChannels, MAX_BLOCK_SIZE) {
+    juce::Random random{19};
+    for (int ch = 0; ch < numChannels; ++ch) {
+      for (int n = 0; n < MAX_BLOCK_SIZE; ++n) {
+        buffer_.setSample(ch, n, static_cast<SampleType>(0.5f * random.nextFloat() - 0.25f));
+      }
+    }
+
+    for (size_t i = 0; i < BLOCK_SIZES.size(); ++i) {
+      blocks_[i] = juce::AudioBuffer<SampleType>{buffer_.getArrayOfWritePointers(), numChannels, BLOCK_SIZES[i]};
+    }
+  }
+
+  juce::AudioBuffer<SampleType>& getBlock(size_t index) noexcept { return blocks_[index]; }
+
+private:
+  juce::AudioBuffer<SampleType> buffer_;
+  std::array<juce::AudioBuffer<SampleType>, BLOCK_SIZES.size()> blocks_;
+};
+
+// Moves every band somewhere new, as a host automating all of them would.
+void sweepParameters(ParametricEq& eq, int step) {
+  const auto t = static_cast<double>(step % 16) / 16.0;
+  const auto gainDb = static_cast<float>(24.0 * t - 12.0);
+
+  for (size_t band = 0; band < ParametricEq::MAX_PEAKS; ++band) {
+    eq.setPeakEnabled(band, (band + static_cast<size_t>(step)) % 3 != 0);
+    eq.setPeakParameters(band, 40.0 * std::pow(400.0, t) + 10.0 * static_cast<double>(band), 0.5 + 4.0 * t, gainDb,
+                         step % 5 == 0);
+  }
+
+  const auto slopeIndex = step % 5;
+  eq.setLowShelfParameters(80.0 + 200.0 * t, 0.7, gainDb, step % 7 == 0, slopeIndex);
+  eq.setHighShelfParameters(4000.0 + 8000.0 * t, 0.7, -gainDb, false, slopeIndex);
+  eq.setLowPassParameters(20000.0 - 15000.0 * t, 0.7, step % 4 == 0, slopeIndex, step % 2 == 0);
+  eq.setHighPassParameters(20.0 + 300.0 * t, 0.7, false, slopeIndex, step % 3 == 0);
+}
+
+template <typename SampleType>
+void expectNoAllocations(ParametricEq& eq, int numChannels) {
+  Signal<SampleType> signal{numChannels};
+
+  {
+    RealtimeTrap trap;
+
+    for (int step = 0; step < 48; ++step) {
+      sweepParameters(eq, step);
+      eq.processBlock(signal.getBlock(static_cast<size_t>(step) % BLOCK_SIZES.size()));
+    }
+  }
+
+  EXPECT_EQ(getTrappedAllocations(), 0) << "engine " << static_cast<int>(eq.getEngine()) << ", " << numChannels
+                                        << " channels";
+  EXPECT_EQ(getTrappedLocks(), 0) << "engine " << static_cast<int>(eq.getEngine()) << ", " << numChannels
+                                  << " channels";
+}
+}  // namespace
+
+TEST(RealtimeSafety, EveryEngineProcessesWithoutAllocating) {
+  for (const auto engine : {ParametricEq::Engine::biquad, ParametricEq::Engine::stateVariable,
+                            ParametricEq::Engine::linearPhase, ParametricEq::Engine::parallel}) {
+    for (const auto numChannels : {1, 2}) {
+      ParametricEq eq;
+      eq.prepare(48000.0, numChannels);
+      eq.setEngine(engine);
+
+      expectNoAllocations<float>(eq, numChannels);
+      expectNoAllocations<double>(eq, numChannels);
+    }
+  }
+}
+
+TEST(RealtimeSafety, SwitchingModesDoesNotAllocate) {
+  ParametricEq eq;
+  eq.prepare(96000.0, 2);
+  eq.setMultirate(true);
+  ASSERT_TRUE(eq.isMultirateActive());
+
+  Signal<float> signal{2};
+
+  {
+    RealtimeTrap trap;
+
+    for (int step = 0; step < 32; ++step) {
+      sweepParameters(eq, step);
+      eq.setDoublePrecision(step % 3 == 0);
+      eq.setMultirate(step % 4 != 0);
+      eq.setEngine(step % 8 == 7 ? ParametricEq::Engine::parallel : ParametricEq::Engine::biquad);
+      eq.processBlock(signal.getBlock(static_cast<size_t>(step) % BLOCK_SIZES.size()));
+    }
+  }
+
+  EXPECT_EQ(getTrappedAllocations(), 0);
+  EXPECT_EQ(getTrappedLocks(), 0);
+}
+
+// A change of oversampling prepares the EQ again at another rate, from the audio thread. Once it
+// has been prepared for its channels, that only picks up splits and buffers it already holds.
+TEST(RealtimeSafety, ChangingTheRateAfterPrepareDoesNotAllocate) {
+  ParametricEq eq;
+  eq.prepare(48000.0, 2);
+  eq.setMultirate(true);
+
+  Signal<float> signal{2};
+
+  {
+    RealtimeTrap trap;
+
+    for (const auto sampleRate : {96000.0, 192000.0, 48000.0, 384000.0, 96000.0}) {
+      eq.prepare(sampleRate, 2);
+      eq.settleParameters();
+      eq.processBlock(signal.getBlock(2));
+    }
+  }
+
+  EXPECT_EQ(getTrappedAllocations(), 0);
+  EXPECT_EQ(getTrappedLocks(), 0);
+}
+
+// A mono block through a stereo EQ filters the one channel it has, and nothing is prepared again.
+TEST(RealtimeSafety, FewerChannelsThanPreparedDoNotAllocate) {
+  ParametricEq eq;
+  eq.prepare(48000.0, 2);
+
+  Signal<float> mono{1};
+
+  {
+    RealtimeTrap trap;
+
+    for (int step = 0; step < 16; ++step) {
+      sweepParameters(eq, step);
+      eq.processBlock(mono.getBlock(static_cast<size_t>(step) % BLOCK_SIZES.size()));
+    }
+  }
+
+  EXPECT_EQ(getTrappedAllocations(), 0);
+  EXPECT_EQ(getTrappedLocks(), 0);
+}
+
+TEST(RealtimeSafety, SpectrumAnalyzerPushesWithoutAllocating) {
+  SpectrumAnalyzer analyzer{11};
+  analyzer.prepare(48000.0, 2);
+
+  Signal<float> floatSignal{2};
+  Signal<double> doubleSignal{2};
+
+  {
+    RealtimeTrap trap;
+
+    for (int step = 0; step < 32; ++step) {
+      const auto index = static_cast<size_t>(step) % BLOCK_SIZES.size();
+      analyzer.pushBlock(floatSignal.getBlock(index));
+      analyzer.pushBlock(doubleSignal.getBlock(index));
+    }
+  }
+
+  EXPECT_EQ(getTrappedAllocations(), 0);
+  EXPECT_EQ(getTrappedLocks(), 0);
+}
+
+// The whole plugin, with the parameters changed between blocks as the host would, including the
+// oversampling factor, which is applied on the audio thread.
+TEST(RealtimeSafety, ProcessorProcessesWithoutAllocating) {
+  parametric_eq::AudioPluginAudioProcessor processor{};
+  processor.prepareToPlay(48000.0, MAX_BLOCK_SIZE);
+
+  Signal<float> signal{processor.getTotalNumInputChannels()};
+  juce::MidiBuffer midi;
+  auto& parameters = processor.getParameters();
+
+  for (int step = 0; step < 24; ++step) {
+    parameters.oversampling = step / 4 % 3;
+    parameters.linearPhase = step % 6 == 5;
+    parameters.peakFilters[0]->gain = static_cast<float>(step % 12) - 6.0f;
+    *parameters.peakEnabled[static_cast<size_t>(step) % ParametricEq::MAX_PEAKS] = step % 2 == 0;
+
+    {
+      RealtimeTrap trap;
+      processor.processBlock(signal.getBlock(static_cast<size_t>(step) % BLOCK_SIZES.size()), midi);
+    }
+
+    ASSERT_EQ(getTrappedAllocations(), 0) << "block " << step;
+    ASSERT_EQ(getTrappedLocks(), 0) << "block " << step;
+  }
+}
+
+// Bypassed with latency, the plugin copies each block and runs the whole EQ on the copy, so that
+// un-bypassing fades into current audio. Neither the copy nor that pass may allocate.
+template <typename SampleType>
+void expectBypassedProcessorDoesNotAllocate() {
+  parametric_eq::AudioPluginAudioProcessor processor{};
+  if constexpr (std::is_same_v<SampleType, double>) {
+    processor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+  }
+
+  auto& parameters = processor.getParameters();
+  parameters.oversampling = 1;
+  processor.prepareToPlay(48000.0, MAX_BLOCK_SIZE);
+
+  Signal<SampleType> signal{processor.getTotalNumInputChannels()};
+  juce::MidiBuffer midi;
+  auto& longestBlock = signal.getBlock(BLOCK_SIZES.size() - 1);
+  processor.processBlock(longestBlock, midi);
+  ASSERT_GT(processor.getLatencySamples(), 0);
+
+  // Past the crossfade, so that every trapped block takes the bypassed branch.
+  parameters.bypassed = true;
+  for (int block = 0; block < 4; ++block) {
+    processor.processBlock(longestBlock, midi);
+  }
+
+  for (int step = 0; step < 24; ++step) {
+    parameters.linearPhase = step % 6 >= 3;
+    parameters.peakFilters[0]->gain = static_cast<float>(step % 12) - 6.0f;
+    *parameters.peakEnabled[static_cast<size_t>(step) % ParametricEq::MAX_PEAKS] = step % 2 == 0;
+
+    {
+      RealtimeTrap trap;
+      processor.processBlock(signal.getBlock(static_cast<size_t>(step) % BLOCK_SIZES.size()), midi);
+    }
+
+    ASSERT_EQ(getTrappedAllocations(), 0) << "block " << step;
+    ASSERT_EQ(getTrappedLocks(), 0) << "block " << step;
+  }
+}
+
+TEST(RealtimeSafety, BypassedProcessorProcessesWithoutAllocating) {
+  expectBypassedProcessorDoesNotAllocate<float>();
+  expectBypassedProcessorDoesNotAllocate<double>();
+}
+}  // namespace parametric_eq_test
@@ -0,0 +1,85 @@
+#include <NIWSParametricEq/gui/ResponseCache.h>
+#include <NIWSParametricEq/filters/PeakFilter.h>
+#include <NIWSParametricEq/filters/LowShelfFilter.h>
+#include <gtest/gtest.h>
+#include <array>
+
+namespace parametric_eq_test {
+namespace {
+using parametric_eq::ResponseCache;
+
+constexpr double SAMPLE_RATE = 48000.0;
+
+// The total straight from the bands, as the frequency axis used to take it for every paint.
+float getCombinedMagnitudeDb(const std::vector<BiquadFilter*>& bands, double frequency) {
+  auto totalDb = 0.0f;
+  for (const auto* band : bands) {
+    totalDb += band->getMagnitudeDbAt(frequency);
+  }
+  return totalDb;
+}
+
+void expectMatchesBands(const ResponseCache& cache, const std::vector<BiquadFilter*>& bands) {
+  const auto& frequencies = cache.getFrequencies();
+  const auto& totalDb = cache.getTotalDb();
+
+  for (size_t i = 0; i < ResponseCache::NUM_POINTS; i += 7) {
+    ASSERT_NEAR(totalDb[i], getCombinedMagnitudeDb(bands, frequencies[i]), 1e-4f) << frequencies[i] << " Hz";
+  }
+}
+}  // namespace
+
+TEST(ResponseCache, SpansTheAxisInLogFrequency) {
+  const ResponseCache cache;
+  const auto& frequencies = cache.getFrequencies();
+
+  EXPECT_NEAR(frequencies.front(), 20.0, 1e-9);
+  EXPECT_NEAR(frequencies.back(), 20000.0, 1e-6);
+  EXPECT_NEAR(frequencies[1] / frequencies[0], frequencies[300] / frequencies[299], 1e-12);
+}
+
+// Only the bands that changed are evaluated again, and the total always matches the bands.
+TEST(ResponseCache, EvaluatesOnlyTheBandsThatChanged) {
+  std::array<PeakFilter, 3> peaks;
+  LowShelfFilter shelf;
+
+  const std::array<double, 3> frequencies{100.0, 1000.0, 8000.0};
+  for (size_t i = 0; i < peaks.size(); ++i) {
+    peaks[i].prepare(SAMPLE_RATE, 2);
+    peaks[i].setParametersAndReset(frequencies[i], 1.0, 6.0f);
+  }
+  shelf.prepare(SAMPLE_RATE, 2);
+  shelf.setParametersAndReset(200.0, 0.7, -4.0f);
+
+  const std::vector<BiquadFilter*> bands{&peaks[0], &peaks[1], &peaks[2], &shelf};
+
+  ResponseCache cache;
+  ASSERT_TRUE(cache.update(bands));
+  EXPECT_EQ(cache.getNumEvaluated(), 4u);
+  expectMatchesBands(cache, bands);
+
+  EXPECT_FALSE(cache.update(bands));
+  EXPECT_EQ(cache.getNumEvaluated(), 0u);
+
+  peaks[1].setParametersAndReset(2000.0, 2.0, -9.0f);
+  ASSERT_TRUE(cache.update(bands));
+  EXPECT_EQ(cache.getNumEvaluated(), 1u);
+  expectMatchesBands(cache, bands);
+
+  shelf.setBypassed(true);
+  ASSERT_TRUE(cache.update(bands));
+  EXPECT_EQ(cache.getNumEvaluated(), 1u);
+  expectMatchesBands(cache, bands);
+
+  // Removing a band shifts the ones after it.
+  const std::vector<BiquadFilter*> fewer{&peaks[0], &peaks[2], &shelf};
+  ASSERT_TRUE(cache.update(fewer));
+  EXPECT_EQ(cache.getNumEvaluated(), 2u);
+  expectMatchesBands(cache, fewer);
+
+  ASSERT_TRUE(cache.update({}));
+  for (const auto level : cache.getTotalDb()) {
+    ASSERT_EQ(level, 0.0f);
+  }
+}
+}  // namespace parametric_eq_test
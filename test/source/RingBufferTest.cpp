@@ -0,0 +1,151 @@
+#include <NIWSParametricEq/utils/RingBuffer.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace parametric_eq_test {
+namespace {
+// Channel ch of sample i, counted from the first sample written, reads i + 1000 * ch.
+template <typename SampleType>
+juce::AudioBuffer<SampleType> makeRamp(int numChannels, int numSamples, int first) {
+  juce::AudioBuffer<SampleType> block{numChannels, numSamples};
+
+  for (int ch = 0; ch < numChannels; ++ch) {
+    for (int n = 0; n < numSamples; ++n) {
+      block.setSample(ch, n, static_cast<SampleType>(first + n + 1000 * ch));
+    }
+  }
+
+  return block;
+}
+}  // namespace
+
+// Blocks that straddle the wrap, in float and double, come out in order.
+TEST(RingBuffer, KeepsTheMostRecentSamplesAcrossTheWrap) {
+  RingBuffer ring{64, 2};
+  ASSERT_EQ(ring.getCapacity(), 64);
+
+  auto written = 0;
+  for (const auto size : {37, 50, 13}) {
+    if (size == 50) {
+      ring.writeBlock(makeRamp<double>(2, size, written));
+    } else {
+      ring.writeBlock(makeRamp<float>(2, size, written));
+    }
+    written += size;
+  }
+
+  std::vector<float> recent(64);
+  ring.copyMostRecentBlock(1, recent.data(), 64);
+  for (int n = 0; n < 64; ++n) {
+    EXPECT_EQ(recent[static_cast<size_t>(n)], static_cast<float>(written - 64 + n + 1000));
+  }
+
+  EXPECT_EQ(ring.readSampleAtDelay(0, 0), static_cast<float>(written - 1));
+  EXPECT_EQ(ring.readSampleAtDelay(0, 10), static_cast<float>(written - 11));
+}
+
+// Of a block longer than the ring, only the end is kept.
+TEST(RingBuffer, KeepsTheEndOfALongBlock) {
+  RingBuffer ring{32, 1};
+  ring.writeBlock(makeRamp<float>(1, 100, 0));
+
+  std::vector<float> recent(32);
+  ring.copyMostRecentBlock(0, recent.data(), 32);
+  EXPECT_EQ(recent.front(), 68.0f);
+  EXPECT_EQ(recent.back(), 99.0f);
+}
+
+// Downmixing as the samples go in reads the same as downmixing them on the way out.
+TEST(RingBuffer, DownmixesOnWriteOrOnRead) {
+  RingBuffer perChannel{64, 3};
+  RingBuffer downmixed{64, 3, RingBuffer::Layout::downmixed};
+  EXPECT_EQ(downmixed.getNumChannels(), 1);
+  EXPECT_TRUE(downmixed.isDownmixed());
+
+  auto written = 0;
+  for (const auto size : {40, 40}) {
+    const auto block = makeRamp<float>(3, size, written);
+    perChannel.writeBlock(block);
+    downmixed.writeBlock(block);
+    written += size;
+  }
+
+  const float frame[] = {1.0f, 2.0f, 6.0f};
+  perChannel.writeFrame(frame, 3);
+  downmixed.writeFrame(frame, 3);
+  EXPECT_NEAR(downmixed.readSampleAtDelay(0, 0), 3.0f, 1e-6f);
+
+  std::vector<float> fromPerChannel(50);
+  std::vector<float> fromDownmixed(50);
+  perChannel.copyMostRecentSamplesMono(fromPerChannel.data(), 50);
+  downmixed.copyMostRecentSamplesMono(fromDownmixed.data(), 50);
+
+  for (size_t n = 0; n < 50; ++n) {
+    EXPECT_NEAR(fromPerChannel[n], fromDownmixed[n], 1e-3f) << n;
+  }
+  EXPECT_NEAR(fromDownmixed[0], static_cast<float>(written - 49 + 1000), 1e-3f);
+}
+
+// Cursors read the same stream at their own pace, and one that falls behind by more than the
+// capacity skips what was overwritten.
+TEST(RingBuffer, CursorsReadIndependently) {
+  RingBuffer ring{64, 2};
+  ring.writeBlock(makeRamp<float>(2, 10, -10));
+
+  auto fast = ring.createCursor();
+  auto slow = ring.createCursor();
+  EXPECT_EQ(ring.getNumReady(fast), 0);
+
+  std::vector<float> read(64);
+  auto written = 0;
+  auto fastRead = 0;
+
+  for (int i = 0; i < 8; ++i) {
+    ring.writeBlock(makeRamp<float>(2, 24, written));
+    written += 24;
+
+    const auto numReady = ring.getNumReady(fast);
+    ASSERT_EQ(numReady, written - fastRead);
+    ring.copyFromCursor(fast, 1, read.data(), numReady);
+    for (int n = 0; n < numReady; ++n) {
+      ASSERT_EQ(read[static_cast<size_t>(n)], static_cast<float>(fastRead + n + 1000));
+    }
+
+    ring.advance(fast, numReady);
+    fastRead += numReady;
+
+    if (i == 1) {
+      ASSERT_EQ(ring.getNumReady(slow), 48);
+      ring.copyFromCursorMono(slow, read.data(), 8);
+      EXPECT_EQ(read[0], 500.0f);
+      ring.advance(slow, 8);
+    }
+  }
+
+  EXPECT_EQ(ring.getNumReady(fast), 0);
+  EXPECT_EQ(ring.getNumReady(slow), 64);
+
+  ring.copyFromCursor(slow, 0, read.data(), 64);
+  EXPECT_EQ(read[0], static_cast<float>(written - 64));
+
+  ring.advance(slow, 1000);
+  EXPECT_EQ(ring.getNumReady(slow), 0);
+}
+
+// A cursor can start behind the newest sample, with those samples left to read first, but no
+// further back than the capacity.
+TEST(RingBuffer, CursorsStartBehindTheNewestSample) {
+  RingBuffer ring{64, 2};
+  ring.writeBlock(makeRamp<float>(2, 100, 0));
+
+  const auto behind = ring.createCursor(16);
+  ASSERT_EQ(ring.getNumReady(behind), 16);
+
+  std::vector<float> read(64);
+  ring.copyFromCursor(behind, 0, read.data(), 16);
+  EXPECT_EQ(read[0], 84.0f);
+  EXPECT_EQ(read[15], 99.0f);
+
+  EXPECT_EQ(ring.getNumReady(ring.createCursor(1000)), 64);
+}
+}  // namespace parametric_eq_test
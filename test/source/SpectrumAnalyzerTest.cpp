@@ -0,0 +1,162 @@
+#include <NIWSParametricEq/SpectrumAnalyzer.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <numbers>
+#include <thread>
+
+namespace parametric_eq_test {
+namespace {
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int FFT_ORDER = 12;
+
+// Pushes a stereo sine, at about the pace of a host, for long enough to fill the longest transform
+// several times over, then takes the last frame.
+bool analyzeSine(SpectrumAnalyzer& analyzer, double frequency) {
+  constexpr int blockSize = 256;
+  juce::AudioBuffer<float> block{2, blockSize};
+  auto phase = 0.0;
+
+  for (int i = 0; i < 4 * (1 << FFT_ORDER) / blockSize; ++i) {
+    for (int n = 0; n < blockSize; ++n) {
+      const auto sample = static_cast<float>(0.5 * std::sin(phase));
+      block.setSample(0, n, sample);
+      block.setSample(1, n, sample);
+      phase += 2.0 * std::numbers::pi * frequency / SAMPLE_RATE;
+    }
+
+    analyzer.pushBlock(block);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  return analyzer.updateMagnitudesDb();
+}
+
+size_t getLoudestPoint(const std::vector<float>& magnitudes) {
+  return static_cast<size_t>(std::distance(magnitudes.begin(), std::max_element(magnitudes.begin(), magnitudes.end())));
+}
+}  // namespace
+
+TEST(SpectrumAnalyzer, PublishesTheSpectrumFromItsOwnThread) {
+  SpectrumAnalyzer analyzer{FFT_ORDER};
+  analyzer.prepare(SAMPLE_RATE, 2);
+  analyzer.addConsumer();
+  EXPECT_FALSE(analyzer.updateMagnitudesDb());
+
+  // Near 100 Hz, 1 kHz and 10 kHz, on a bin of the longest transform, whose bins are about a
+  // twelfth of an octave apart at 100 Hz.
+  const auto binWidth = SAMPLE_RATE / static_cast<double>(1 << FFT_ORDER);
+
+  for (const auto multiResolution : {false, true}) {
+    analyzer.setMultiResolution(multiResolution);
+
+    for (const auto frequency : {9.0 * binWidth, 85.0 * binWidth, 853.0 * binWidth}) {
+      ASSERT_TRUE(analyzeSine(analyzer, frequency));
+
+      const auto& magnitudes = analyzer.getMagnitudesDb();
+      ASSERT_EQ(magnitudes.size(), SpectrumAnalyzer::NUM_POINTS);
+
+      const auto peakFrequency = SpectrumAnalyzer::getPointFrequency(getLoudestPoint(magnitudes));
+      EXPECT_NEAR(std::log2(peakFrequency / frequency), 0.0, 1.0 / 24.0) << frequency << " Hz";
+    }
+  }
+}
+
+// The shorter transforms are scaled to read a tone at the level the longest one does. The tones
+// sit on a bin of every resolution, so only the point spacing is left to tell them apart.
+TEST(SpectrumAnalyzer, ResolutionsAgreeOnTheLevelOfATone) {
+  SpectrumAnalyzer analyzer{FFT_ORDER};
+  analyzer.prepare(SAMPLE_RATE, 2);
+  analyzer.addConsumer();
+
+  const auto shortestBinWidth = SAMPLE_RATE / static_cast<double>(1 << (FFT_ORDER - 4));
+
+  for (const auto frequency : {2.0 * shortestBinWidth, 16.0 * shortestBinWidth, 64.0 * shortestBinWidth}) {
+    analyzer.setMultiResolution(false);
+    ASSERT_TRUE(analyzeSine(analyzer, frequency));
+    const auto singleLevel = *std::max_element(analyzer.getMagnitudesDb().begin(), analyzer.getMagnitudesDb().end());
+
+    analyzer.setMultiResolution(true);
+    ASSERT_TRUE(analyzeSine(analyzer, frequency));
+    const auto multiLevel = *std::max_element(analyzer.getMagnitudesDb().begin(), analyzer.getMagnitudesDb().end());
+
+    EXPECT_NEAR(multiLevel, singleLevel, 3.0f) << frequency << " Hz";
+  }
+}
+
+TEST(SpectrumAnalyzer, ReportsItsCost) {
+  SpectrumAnalyzer analyzer{FFT_ORDER};
+  analyzer.setMultiResolution(false);
+  analyzer.setOverlap(SpectrumAnalyzer::MAX_OVERLAP);
+  analyzer.prepare(SAMPLE_RATE, 2);
+  analyzer.addConsumer();
+
+  juce::AudioBuffer<float> block{2, 480};
+  block.clear();
+
+  for (int i = 0; i < 120; ++i) {
+    analyzer.pushBlock(block);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  const auto stats = analyzer.getStats();
+  EXPECT_GT(stats.transformsPerSecond, 0.0);
+  EXPECT_GT(stats.framesPerSecond, 0.0);
+  EXPECT_GT(stats.threadLoad, 0.0);
+  EXPECT_LT(stats.threadLoad, 1.0);
+}
+
+// With nobody watching, the thread publishes nothing. The first consumer wakes it, and the first
+// frame only waits for a short hop of new samples, on top of what the ring already holds.
+TEST(SpectrumAnalyzer, SleepsUntilSomeoneWatches) {
+  SpectrumAnalyzer analyzer{FFT_ORDER};
+  analyzer.prepare(SAMPLE_RATE, 2);
+  ASSERT_FALSE(analyzer.hasConsumers());
+
+  ASSERT_FALSE(analyzeSine(analyzer, 1000.0));
+  EXPECT_EQ(analyzer.getStats().transformsPerSecond, 0.0);
+
+  analyzer.addConsumer();
+  EXPECT_TRUE(analyzer.hasConsumers());
+
+  juce::AudioBuffer<float> block{2, 256};
+  block.clear();
+  analyzer.pushBlock(block);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_TRUE(analyzer.updateMagnitudesDb());
+
+  analyzer.removeConsumer();
+  EXPECT_FALSE(analyzer.hasConsumers());
+}
+
+// Every frame the reader takes is one the writer finished, however the two interleave.
+TEST(TripleBuffer, ReaderOnlySeesWholeFrames) {
+  TripleBuffer<std::array<int, 64>> frames;
+  frames.fill({});
+
+  constexpr int NUM_FRAMES = 100000;
+
+  std::thread writer{[&frames] {
+    for (int i = 1; i <= NUM_FRAMES; ++i) {
+      frames.getWriteBuffer().fill(i);
+      frames.publish();
+    }
+  }};
+
+  auto last = 0;
+  while (last < NUM_FRAMES) {
+    if (!frames.update()) {
+      continue;
+    }
+
+    const auto& frame = frames.getReadBuffer();
+    ASSERT_TRUE(std::all_of(frame.begin(), frame.end(), [&frame](int value) { return value == frame[0]; }));
+    ASSERT_GT(frame[0], last);
+    last = frame[0];
+  }
+
+  writer.join();
+  EXPECT_FALSE(frames.update());
+}
+}  // namespace parametric_eq_test
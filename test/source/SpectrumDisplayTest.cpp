@@ -0,0 +1,116 @@
+#include <NIWSParametricEq/gui/SpectrumDisplay.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace parametric_eq_test {
+namespace {
+using parametric_eq::SpectrumDisplay;
+
+constexpr auto NUM_POINTS = SpectrumAnalyzer::NUM_POINTS;
+
+// A tone at one point, over a floor far below it.
+std::vector<float> makeTone(size_t point, float levelDb) {
+  std::vector<float> levels(NUM_POINTS, -100.0f);
+  levels[point] = levelDb;
+  return levels;
+}
+
+size_t countColumnsAbove(const SpectrumDisplay& display, float levelDb) {
+  const auto& columns = display.getColumns();
+  return static_cast<size_t>(std::count_if(columns.begin(), columns.end(),
+                                           [levelDb](const auto& column) { return column.levelDb > levelDb; }));
+}
+}  // namespace
+
+TEST(SpectrumDisplay, OneColumnPerStemWidth) {
+  SpectrumDisplay display;
+  display.setBounds({10.0f, 0.0f, 804.0f, 300.0f});
+
+  const auto& columns = display.getColumns();
+  ASSERT_EQ(columns.size(), 100u);
+  EXPECT_NEAR(columns.front().x, 14.0f, 1e-4f);
+  EXPECT_NEAR(columns.back().x, 10.0f + 99.5f * SpectrumDisplay::COLUMN_WIDTH, 1e-4f);
+
+  display.pushFrame(std::vector<float>(NUM_POINTS, -60.0f));
+  for (const auto& column : columns) {
+    EXPECT_NEAR(column.levelDb, -60.0f, 1e-4f);
+  }
+}
+
+// A column shows the loudest point within it, wherever it lands, and a new size keeps the frame.
+TEST(SpectrumDisplay, ColumnsShowTheirLoudestPoint) {
+  for (const auto point : {size_t{0}, size_t{100}, size_t{301}, NUM_POINTS - 1}) {
+    SpectrumDisplay tone;
+    tone.setBounds({0.0f, 0.0f, 800.0f, 300.0f});
+    tone.pushFrame(makeTone(point, 0.0f));
+
+    EXPECT_EQ(countColumnsAbove(tone, -50.0f), 1u) << point;
+
+    const auto expectedColumn = static_cast<size_t>(800.0 * static_cast<double>(point) / static_cast<double>(NUM_POINTS - 1)
+                                                    / static_cast<double>(SpectrumDisplay::COLUMN_WIDTH));
+    const auto& columns = tone.getColumns();
+    EXPECT_NEAR(columns[juce::jmin(expectedColumn, columns.size() - 1)].levelDb, 0.0f, 1e-4f) << point;
+
+    tone.setBounds({0.0f, 0.0f, 400.0f, 300.0f});
+    EXPECT_EQ(tone.getColumns().size(), 50u);
+    EXPECT_EQ(countColumnsAbove(tone, -50.0f), 1u) << point;
+  }
+}
+
+// Successive frames are averaged.
+TEST(SpectrumDisplay, BlendsWithThePreviousFrame) {
+  SpectrumDisplay display;
+  display.setBounds({0.0f, 0.0f, 800.0f, 300.0f});
+
+  display.pushFrame(std::vector<float>(NUM_POINTS, -60.0f));
+  display.pushFrame(std::vector<float>(NUM_POINTS, -40.0f));
+  EXPECT_NEAR(display.getColumns()[50].levelDb, -50.0f, 1e-4f);
+
+  display.pushFrame(std::vector<float>(NUM_POINTS, -40.0f));
+  EXPECT_NEAR(display.getColumns()[50].levelDb, -40.0f, 1e-4f);
+}
+
+// A tone spreads over more of the spectrum, and peaks lower, the wider the smoothing. A flat
+// spectrum stays as it was.
+TEST(SpectrumDisplay, SmoothsOverAFractionOfAnOctave) {
+  SpectrumDisplay display;
+  display.setBounds({0.0f, 0.0f, 1000.0f, 300.0f});
+  display.pushFrame(makeTone(NUM_POINTS / 2, 0.0f));
+
+  auto previousSpread = countColumnsAbove(display, -50.0f);
+  auto previousPeak = 0.0f;
+  EXPECT_EQ(previousSpread, 1u);
+
+  for (const auto smoothing : {SpectrumDisplay::Smoothing::twelfthOctave, SpectrumDisplay::Smoothing::sixthOctave,
+                               SpectrumDisplay::Smoothing::thirdOctave}) {
+    display.setSmoothing(smoothing);
+    ASSERT_TRUE(display.getSmoothing() == smoothing);
+
+    const auto spread = countColumnsAbove(display, -50.0f);
+    const auto& columns = display.getColumns();
+    const auto peak = std::max_element(columns.begin(), columns.end(), [](const auto& a, const auto& b) {
+                        return a.levelDb < b.levelDb;
+                      })->levelDb;
+
+    EXPECT_GT(spread, previousSpread);
+    EXPECT_LT(peak, previousPeak);
+    previousSpread = spread;
+    previousPeak = peak;
+  }
+
+  // At about 100 px an octave, a third of one is a few columns wide, and the tone's power is
+  // shared by the points in it.
+  const auto pointsPerOctave = static_cast<double>(NUM_POINTS - 1) / std::log2(1000.0);
+  EXPECT_NEAR(static_cast<float>(previousSpread) * SpectrumDisplay::COLUMN_WIDTH, 100.0f / 3.0f,
+              1.5f * SpectrumDisplay::COLUMN_WIDTH);
+  EXPECT_NEAR(previousPeak, 10.0 * std::log10(3.0 / pointsPerOctave), 1.0);
+
+  display.pushFrame(std::vector<float>(NUM_POINTS, -60.0f));
+  display.pushFrame(std::vector<float>(NUM_POINTS, -60.0f));
+  for (const auto& column : display.getColumns()) {
+    EXPECT_NEAR(column.levelDb, -60.0f, 1e-3f);
+  }
+}
+}  // namespace parametric_eq_test
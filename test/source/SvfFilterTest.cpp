@@ -0,0 +1,106 @@
+#include <NIWSParametricEq/filters/BandPassFilter.h>
+#include <NIWSParametricEq/filters/HighPassFilter.h>
+#include <NIWSParametricEq/filters/HighShelfFilter.h>
+#include <NIWSParametricEq/filters/LowPassFilter.h>
+#include <NIWSParametricEq/filters/LowShelfFilter.h>
+#include <NIWSParametricEq/filters/NotchFilter.h>
+#include <NIWSParametricEq/filters/PeakFilter.h>
+#include <NIWSParametricEq/filters/SvfFilter.h>
+#include <gtest/gtest.h>
+#include <complex>
+
+#include "TestHelpers.h"
+
+namespace parametric_eq_test {
+namespace {
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int IMPULSE_LENGTH = 16384;
+
+// Magnitude of the filter's measured impulse response at frequency, in dB.
+float getMeasuredMagnitudeDb(const juce::AudioBuffer<float>& impulseResponse, double frequency) {
+  const auto w = 2.0 * std::numbers::pi * frequency / SAMPLE_RATE;
+  auto sum = std::complex<double>{};
+
+  for (int n = 0; n < impulseResponse.getNumSamples(); ++n) {
+    sum += static_cast<double>(impulseResponse.getSample(0, n)) * std::polar(1.0, -w * static_cast<double>(n));
+  }
+
+  return juce::Decibels::gainToDecibels(static_cast<float>(std::abs(sum)), -200.0f);
+}
+
+template <typename Biquad>
+void expectMatchingBiquadResponse(SvfFilter::Type type, double frequency, double Q, float gainDb) {
+  SvfFilter svf{type};
+  svf.prepare(SAMPLE_RATE, 1);
+  svf.setParametersAndReset(frequency, Q, gainDb);
+
+  Biquad biquad;
+  biquad.prepare(SAMPLE_RATE, 1);
+  biquad.setParametersAndReset(frequency, Q);
+  biquad.setAmplitude40(gainDb);
+  biquad.settleParameters();
+
+  juce::AudioBuffer<float> impulseResponse{1, IMPULSE_LENGTH};
+  impulseResponse.clear();
+  impulseResponse.setSample(0, 0, 1.0f);
+  svf.processBlock(impulseResponse);
+
+  // Low in the spectrum the biquad's float coefficients are the coarser of the two designs, and
+  // the stopbands and notches, where small errors show as large dB differences, are skipped.
+  const auto tolerance = frequency >= 200.0 ? 0.01f : 0.05f;
+
+  for (auto f = 20.0; f <= 20000.0; f *= 1.1) {
+    const auto expected = biquad.getMagnitudeDbAt(f);
+    if (expected < -20.0f) {
+      continue;
+    }
+
+    const auto designed = svf.getMagnitudeDbAt(f);
+    ASSERT_NEAR(designed, expected, tolerance)
+        << "f0 " << frequency << ", Q " << Q << ", gain " << gainDb << ", at " << f;
+    ASSERT_NEAR(getMeasuredMagnitudeDb(impulseResponse, f), designed, 0.02f)
+        << "measured, f0 " << frequency << ", Q " << Q << ", gain " << gainDb << ", at " << f;
+  }
+}
+}  // namespace
+
+TEST(SvfFilter, MatchesTheBiquadMagnitudeResponses) {
+  for (const auto frequency : {80.0, 1000.0, 12000.0}) {
+    for (const auto Q : {0.5, 0.707, 4.0}) {
+      expectMatchingBiquadResponse<PeakFilter>(SvfFilter::Type::peak, frequency, Q, 9.0f);
+      expectMatchingBiquadResponse<PeakFilter>(SvfFilter::Type::peak, frequency, Q, -15.0f);
+      expectMatchingBiquadResponse<LowShelfFilter>(SvfFilter::Type::lowShelf, frequency, Q, 6.0f);
+      expectMatchingBiquadResponse<HighShelfFilter>(SvfFilter::Type::highShelf, frequency, Q, -9.0f);
+      expectMatchingBiquadResponse<LowPassFilter>(SvfFilter::Type::lowPass, frequency, Q, 0.0f);
+      expectMatchingBiquadResponse<HighPassFilter>(SvfFilter::Type::highPass, frequency, Q, 0.0f);
+      expectMatchingBiquadResponse<BandPassFilter>(SvfFilter::Type::bandPass, frequency, Q, 0.0f);
+      expectMatchingBiquadResponse<NotchFilter>(SvfFilter::Type::notch, frequency, Q, 0.0f);
+    }
+  }
+}
+
+// Retuning a resonant band by decades every few samples would blow up a direct-form biquad's
+// states; the integrator states of the SVF stay bounded.
+TEST(SvfFilter, StaysBoundedUnderFastModulation) {
+  SvfFilter svf{SvfFilter::Type::peak};
+  svf.prepare(SAMPLE_RATE, 2);
+  svf.setParametersAndReset(1000.0, 10.0, 18.0f);
+
+  juce::Random random{5};
+  juce::AudioBuffer<float> buffer{2, 8};
+
+  for (int block = 0; block < 6000; ++block) {
+    svf.setFrequency(20.0 * std::pow(1000.0, static_cast<double>(random.nextFloat())));
+
+    fillWithNoise(buffer, random);
+
+    svf.processBlock(buffer);
+
+    for (int ch = 0; ch < 2; ++ch) {
+      for (int n = 0; n < buffer.getNumSamples(); ++n) {
+        ASSERT_LT(std::abs(buffer.getSample(ch, n)), 100.0f) << "block " << block;
+      }
+    }
+  }
+}
+}  // namespace parametric_eq_test
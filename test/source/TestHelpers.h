@@ -0,0 +1,36 @@
+#pragma once
+
+#include <NIWSParametricEq/filters/BiquadFilter.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Helpers shared between the test files.
+namespace parametric_eq_test {
+// Uniform noise in [-1, 1), channel after channel.
+inline void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random) {
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+    auto* data = buffer.getWritePointer(ch);
+    for (int n = 0; n < buffer.getNumSamples(); ++n) {
+      data[n] = 2.0f * random.nextFloat() - 1.0f;
+    }
+  }
+}
+
+// A one-channel filter settled on the given parameters, with the gain applied the way the shelves
+// and peaks take it.
+template <typename Filter>
+Filter makeFilter(double sampleRate, double frequency, double Q, float gainDb,
+                  BiquadFilter::DesignMode mode = BiquadFilter::DesignMode::bilinear) {
+  Filter filter;
+  filter.prepare(sampleRate, 1);
+  filter.setDesignMode(mode);
+  filter.setParametersAndReset(frequency, Q);
+  filter.setAmplitude40(gainDb);
+  filter.settleParameters();
+  return filter;
+}
+
+template <typename Filter>
+BiquadFilter::Coefficients makeCoefficients(double sampleRate, double frequency, double Q, float gainDb) {
+  return makeFilter<Filter>(sampleRate, frequency, Q, gainDb).getCoefficients();
+}
+}  // namespace parametric_eq_test